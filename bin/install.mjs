@@ -46,7 +46,7 @@ function buildBinary() {
 
     log('Building tm binary...')
     try {
-        execSync(`bun build ./testme.ts --compile --outfile ${binaryName}`, {
+        execSync(`bun build ./testme.ts ./src/utils/js-worker.ts --compile --outfile ${binaryName}`, {
             stdio: 'inherit',
         })
         log('Binary built successfully')
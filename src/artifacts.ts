@@ -1,9 +1,11 @@
 import type {TestFile, ArtifactManager as IArtifactManager, TestConfig} from './types.ts'
 import {join, basename, relative, dirname} from 'path'
 import * as path from 'path'
-import {mkdir, rmdir, readdir, unlink} from 'node:fs/promises'
+import {mkdir, rmdir, readdir} from 'node:fs/promises'
 import {existsSync} from 'node:fs'
 import {GlobExpansion} from './utils/glob-expansion.ts'
+import {discardTree, removeTree, settleBackground, withRemoveSlot} from './utils/remove.ts'
+import {Log} from './utils/log.ts'
 
 /**
  * Manages build artifacts and temporary files for test execution
@@ -27,7 +29,7 @@ import {GlobExpansion} from './utils/glob-expansion.ts'
  * Features:
  * - Creates isolated artifact directories per test file
  * - Supports Xcode project generation for C test debugging on macOS
- * - Handles recursive cleanup of artifact directories
+ * - Handles recursive cleanup of artifact directories (bounded parallel, per-test cleanup in the background)
  * - Provides artifact file read/write utilities
  *
  * @example
@@ -72,7 +74,8 @@ export class ArtifactManager implements IArtifactManager {
 
     /*
      Removes the artifact directory for a test file
-     Also removes the parent .testme directory if it becomes empty
+     The directory is renamed aside and removed in the background, so cleanup never delays the
+     next test. Also removes the parent .testme directory if it becomes empty.
      @param testFile Test file to clean artifact directory for
      @throws Error if directory removal fails
      */
@@ -84,17 +87,16 @@ export class ArtifactManager implements IArtifactManager {
         }
 
         try {
-            // Remove the test's artifact directory
-            await this.removeDirectory(artifactDir)
-
-            // Check if parent .testme directory is now empty and remove it
-            const parentDir = dirname(artifactDir)
-            if (basename(parentDir) === '.testme' && existsSync(parentDir)) {
-                const entries = await readdir(parentDir)
-                if (entries.length === 0) {
-                    await rmdir(parentDir)
+            await discardTree(artifactDir, async () => {
+                // Check if parent .testme directory is now empty and remove it
+                const parentDir = dirname(artifactDir)
+                if (basename(parentDir) === '.testme') {
+                    const entries = await readdir(parentDir)
+                    if (entries.length === 0) {
+                        await rmdir(parentDir)
+                    }
                 }
-            }
+            })
         } catch (error) {
             throw new Error(`Failed to clean artifact directory ${artifactDir}: ${error}`)
         }
@@ -102,6 +104,7 @@ export class ArtifactManager implements IArtifactManager {
 
     /*
      Recursively removes all .testme directories in a directory tree
+     Directories are searched and removed concurrently with a bounded number of filesystem operations
      @param rootDir Root directory to start cleaning from
      @throws Error if cleanup fails
      */
@@ -113,6 +116,13 @@ export class ArtifactManager implements IArtifactManager {
         }
     }
 
+    /*
+     Waits for artifact directories being removed in the background
+     */
+    async flush(): Promise<void> {
+        await settleBackground()
+    }
+
     /*
      Gets the full path to an artifact file
      @param testFile Test file to get artifact path for
@@ -186,83 +196,6 @@ export class ArtifactManager implements IArtifactManager {
         }
     }
 
-    /*
-     Recursively removes a directory and all its contents
-     Includes retry logic for Windows file locking issues
-     Uses readdir with withFileTypes to avoid extra stat() calls
-     @param dirPath Path to directory to remove
-     */
-    private async removeDirectory(dirPath: string): Promise<void> {
-        try {
-            const entries = await readdir(dirPath, {withFileTypes: true})
-
-            // Remove all files and subdirectories
-            for (const entry of entries) {
-                const fullPath = join(dirPath, entry.name)
-
-                if (entry.isDirectory()) {
-                    await this.removeDirectory(fullPath)
-                } else {
-                    // Windows may lock executables briefly after process exit
-                    // Retry file deletion with exponential backoff
-                    await this.removeFileWithRetry(fullPath)
-                }
-            }
-
-            // Remove the directory itself
-            await rmdir(dirPath)
-        } catch (error) {
-            // If directory doesn't exist, that's OK
-            if ((error as any).code !== 'ENOENT') {
-                throw error
-            }
-        }
-    }
-
-    /*
-     Removes a file with retry logic for Windows file locking
-     @param filePath Path to file to remove
-     @param maxRetries Maximum number of retry attempts (default: 5)
-     @param delayMs Initial delay in milliseconds (default: 50)
-     */
-    private async removeFileWithRetry(filePath: string, maxRetries: number = 5, delayMs: number = 50): Promise<void> {
-        let lastError: any
-
-        for (let attempt = 0; attempt <= maxRetries; attempt++) {
-            try {
-                // Check if file still exists before attempting deletion
-                if (!existsSync(filePath)) {
-                    return // File already deleted, success
-                }
-
-                await unlink(filePath)
-                return // Success
-            } catch (error: any) {
-                lastError = error
-
-                // Only retry on Windows EPERM/EBUSY errors (file locked)
-                if (error.code === 'EPERM' || error.code === 'EBUSY') {
-                    if (attempt < maxRetries) {
-                        // Exponential backoff: 50ms, 100ms, 200ms, 400ms (capped at 500ms)
-                        const delay = Math.min(delayMs * Math.pow(2, attempt), 500)
-                        await new Promise((resolve) => setTimeout(resolve, delay))
-                        continue
-                    }
-                }
-
-                // For ENOENT (file doesn't exist), treat as success
-                if (error.code === 'ENOENT') {
-                    return
-                }
-
-                // For other errors or max retries exceeded, throw
-                throw error
-            }
-        }
-
-        throw lastError
-    }
-
     /*
      Recursively finds and removes all .testme artifact directories
      Uses readdir with withFileTypes to avoid extra stat() calls
@@ -270,7 +203,8 @@ export class ArtifactManager implements IArtifactManager {
      */
     private async findAndRemoveArtifactDirs(dirPath: string): Promise<void> {
         try {
-            const entries = await readdir(dirPath, {withFileTypes: true})
+            const entries = await withRemoveSlot(() => readdir(dirPath, {withFileTypes: true}))
+            const work: Promise<void>[] = []
 
             for (const entry of entries) {
                 if (entry.isDirectory()) {
@@ -278,13 +212,14 @@ export class ArtifactManager implements IArtifactManager {
 
                     if (entry.name === '.testme') {
                         // Found an artifact directory, remove it
-                        await this.removeDirectory(fullPath)
+                        work.push(removeTree(fullPath))
                     } else if (!this.shouldSkipDirectory(entry.name)) {
                         // Recursively search subdirectories
-                        await this.findAndRemoveArtifactDirs(fullPath)
+                        work.push(this.findAndRemoveArtifactDirs(fullPath))
                     }
                 }
             }
+            await Promise.all(work)
         } catch (error) {
             // Log warning but continue
             console.warn(`Warning: Could not clean artifacts in ${dirPath}: ${error}`)
@@ -367,6 +302,9 @@ export class ArtifactManager implements IArtifactManager {
         allEnvVars.TESTME_VERBOSE = config.output?.verbose === true ? '1' : '0'
         allEnvVars.TESTME_QUIET = config.output?.quiet === true ? '1' : '0'
         allEnvVars.TESTME_KEEP = config.execution?.keepArtifacts === true ? '1' : '0'
+        if (config.output?.quietPass === true && config.output?.verbose !== true) {
+            allEnvVars.TESTME_QUIET_PASS = '1'
+        }
         allEnvVars.TESTME_STOP = config.execution?.stopOnFailure === true ? '1' : '0'
         allEnvVars.TESTME_ITERATIONS = (config.execution?.iterations ?? 1).toString()
 
@@ -491,7 +429,7 @@ schemes:
             // Write the project configuration file
             await this.writeArtifact(testFile, configFileName, projectConfigContent)
 
-            console.log(`📝 Created Xcode project configuration: ${configFileName}`)
+            Log.info(`📝 Created Xcode project configuration: ${configFileName}`)
         } catch (error) {
             throw new Error(`Failed to create Xcode project: ${error}`)
         }
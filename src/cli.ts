@@ -1,4 +1,6 @@
 import type {CliOptions} from './types.ts'
+import {parseShard} from './utils/shards.ts'
+import {CompilerManager} from './platform/compiler.ts'
 
 /*
  Command-line interface parser for the testme application
@@ -31,6 +33,7 @@ export class CliParser {
             noServices: false,
             stop: false,
             live: false,
+            watch: false,
             testClass: undefined,
         }
 
@@ -165,6 +168,82 @@ export class CliParser {
                     }
                     break
 
+                case '--save-baseline':
+                    options.saveBaseline = true
+                    i++
+                    break
+
+                case '--shard':
+                    if (i + 1 < args.length) {
+                        options.shard = parseShard(args[i + 1]!)
+                        i += 2
+                    } else {
+                        throw new Error(`${arg} requires a value of the form i/N`)
+                    }
+                    break
+
+                case '--shard-timings':
+                    if (i + 1 < args.length) {
+                        options.shardTimings = args[i + 1]!
+                        i += 2
+                    } else {
+                        throw new Error(`${arg} requires a JSON report file`)
+                    }
+                    break
+
+                case '--merge':
+                    options.merge = true
+                    i++
+                    break
+
+                case '--ndjson':
+                    if (i + 1 < args.length) {
+                        options.ndjson = args[i + 1]!
+                        i += 2
+                    } else {
+                        throw new Error(`${arg} requires a report file`)
+                    }
+                    break
+
+                case '--junit':
+                    if (i + 1 < args.length) {
+                        options.junit = args[i + 1]!
+                        i += 2
+                    } else {
+                        throw new Error(`${arg} requires a report file`)
+                    }
+                    break
+
+                case '--sanitize':
+                    if (i + 1 < args.length) {
+                        options.sanitize = args[i + 1]!.split(',')
+                        // Report unknown or conflicting sanitizers before any test is compiled
+                        CompilerManager.getInstrumentation(options.sanitize)
+                        i += 2
+                    } else {
+                        throw new Error(`${arg} requires a list of sanitizers`)
+                    }
+                    break
+
+                case '--coverage':
+                    options.coverage = true
+                    i++
+                    break
+
+                case '--trace':
+                    if (i + 1 < args.length) {
+                        options.trace = args[i + 1]!
+                        i += 2
+                    } else {
+                        throw new Error(`${arg} requires a trace file`)
+                    }
+                    break
+
+                case '--watch':
+                    options.watch = true
+                    i++
+                    break
+
                 case '--class':
                     if (i + 1 < args.length) {
                         options.testClass = args[i + 1]!
@@ -188,6 +267,19 @@ export class CliParser {
                     }
                     break
 
+                case '--repeat':
+                    if (i + 1 < args.length) {
+                        const repeatValue = parseInt(args[i + 1]!, 10)
+                        if (isNaN(repeatValue) || repeatValue < 1) {
+                            throw new Error(`${arg} requires a positive number`)
+                        }
+                        options.repeat = repeatValue
+                        i += 2
+                    } else {
+                        throw new Error(`${arg} requires a number value`)
+                    }
+                    break
+
                 case '--init':
                     options.init = true
                     i++
@@ -324,6 +416,7 @@ OPTIONS:
         --clean              Clean all .testme artifact directories and exit
     -c, --config <FILE>      Use specific configuration file
         --continue           Continue running tests even if some fail, always exit with 0
+        --coverage           Build C tests with line coverage and write .testme/lcov.info
     -d, --debug              Launch debugger (GDB on Linux, Xcode on macOS)
         --depth <NUMBER>     Run tests with depth requirement <= NUMBER (default: 0)
         --duration <COUNT>   Set duration count with optional suffix (secs/mins/hrs/hours/days)
@@ -332,21 +425,31 @@ OPTIONS:
     -h, --help               Show this help message
     -i, --iterations <N>     Set iteration count (exports TESTME_ITERATIONS for tests to use, TestMe does not repeat execution)
         --init               Create testme.json5 configuration file in current directory
+        --junit <FILE>       Write JUnit XML results to FILE as each test completes
     -k, --keep               Keep .testme artifacts (default; use --clean to remove)
     -l, --list               List discovered tests without running them
+        --merge              Merge JSON or NDJSON reports named by <PATTERNS> into one final report
     -m, --monitor            Stream test output in real-time to console (requires TTY)
     -n, --no-services        Skip all service commands (skip, prep, setup, cleanup)
+        --ndjson <FILE>      Write each test result to FILE as one JSON line as it completes
         --new <NAME>         Create new test file from template (e.g., --new math.c)
     -p, --profile <NAME>     Set build profile (overrides config and env.PROFILE)
     -q, --quiet              Run silently with no output, only exit codes
     -R, --rebuild            Force recompilation of C tests (default: skip if binary is newer)
+        --repeat <N>         Run each test N times, stopping at the first failure (see execution.forkServer)
+        --sanitize <LIST>    Build C tests with sanitizers (address, undefined, thread, leak, memory)
+        --save-baseline      Save benchmark results as the new baseline for regression checks
+        --shard <i/N>        Run only shard i of N (tests dealt in path order)
+        --shard-timings <FILE>  Use durations from a JSON report to balance shards
     -s, --show               Display test configuration and environment variables
         --step               Run tests one at a time with prompts (forces serial mode)
         --stop               Stop immediately when a test fails (fast-fail mode)
     -t, --timeout <SECONDS>  Set test timeout in seconds (overrides config)
+        --trace <FILE>       Write a Chrome/Perfetto trace of run phases and per-test stages to FILE
     -v, --verbose            Enable verbose mode with detailed output and TESTME_VERBOSE
     -V, --version            Show version information
     -w, --warning            Show compiler warnings and compile command line for C tests
+        --watch              Watch for changes and re-run affected tests (Ctrl+C to exit)
     -W, --workers <NUMBER>   Number of parallel workers (overrides config)
 
 EXAMPLES:
@@ -375,6 +478,12 @@ EXAMPLES:
     tm -W 8                    # Use 8 parallel workers (overrides config)
     tm --quiet                 # Run silently with no output, only exit codes
     tm -n                      # Run tests without any service commands (run services externally)
+    tm --save-baseline "bench*" # Record benchmark baselines
+    tm --shard 2/8 > s2.json   # Run CI shard 2 of 8 (with output.format 'json')
+    tm --merge shard*.json     # Combine shard reports into one final report
+    tm --watch "*.tst.c"       # Re-run C tests as their sources and headers change
+    tm --sanitize address,undefined  # Run C tests built with ASan and UBSan
+    tm --coverage              # Run C tests with coverage and write .testme/lcov.info
 
 SUPPORTED TEST TYPES:
     *.tst.sh    Shell script tests (bash/zsh/fish)
@@ -419,6 +528,14 @@ For more information, see the project documentation.
             throw new Error('Cannot use --clean and --list together')
         }
 
+        if (options.merge && options.patterns.length === 0) {
+            throw new Error('--merge requires one or more JSON report files')
+        }
+
+        if (options.watch && (options.step || options.debug || options.merge)) {
+            throw new Error('--watch cannot be used with --step, --debug or --merge')
+        }
+
         // Validate test patterns
         for (const pattern of options.patterns) {
             if (!pattern.trim()) {
@@ -76,7 +76,21 @@ export class ConfigManager {
      * Avoids repeated file system walks and parsing for the same directory
      * @internal
      */
-    private static configCache = new Map<string, TestConfig>()
+    private static configCache = new Map<string, Promise<TestConfig>>()
+
+    /**
+     * Cache for resolved configurations indexed by config file directory
+     * Directories sharing one testme.json5 share one resolved configuration
+     * @internal
+     */
+    private static resolvedCache = new Map<string, Promise<TestConfig>>()
+
+    /**
+     * Cache for config file lookups indexed by directory
+     * A walk up the tree stops at the first directory already looked up by a sibling
+     * @internal
+     */
+    private static fileCache = new Map<string, Promise<{config: Partial<TestConfig> | null; configDir: string | null}>>()
 
     /**
      * Default configuration values used as fallback
@@ -96,7 +110,7 @@ export class ConfigManager {
         execution: {
             timeout: 30, // 30 seconds
             parallel: true,
-            workers: 4,
+            // No workers - one per CPU core (RunBudget.getWorkers)
         },
         output: {
             verbose: false,
@@ -140,32 +154,63 @@ export class ConfigManager {
      * inheritance, parent configs are loaded and merged.
      *
      * Results are cached for the lifetime of the process to avoid repeated file system
-     * walks and parsing for the same directory.
+     * walks and parsing for the same directory. Lookups are cached per directory and
+     * resolution per config file, so sibling directories sharing a parent config walk
+     * and parse it once. Concurrent calls share one pending lookup. Callers must not
+     * modify the returned configuration: it is shared by every directory using it.
      */
     static async findConfig(startDir: string): Promise<TestConfig> {
         // Check cache first
-        const cached = this.configCache.get(startDir)
-        if (cached) {
-            return cached
+        let result = this.configCache.get(startDir)
+        if (!result) {
+            result = this.findConfigFile(startDir).then(({config, configDir}) =>
+                this.resolveConfig(config, configDir)
+            )
+            // Cache the result
+            this.configCache.set(startDir, result)
         }
+        return await result
+    }
 
-        const {config, configDir} = await this.findConfigFile(startDir)
-
-        let result: TestConfig
-        // If config has inherit field, load parent config and merge
-        if (config && config.inherit !== undefined && config.inherit !== false) {
-            const parentConfig = configDir ? await this.loadParentConfig(configDir) : null
-            const inheritedConfig = this.mergeInheritedConfig(config, parentConfig)
-            result = this.mergeWithDefaults(inheritedConfig, configDir)
-        } else {
-            result = this.mergeWithDefaults(config, configDir)
+    /**
+     * Resolves a config file into a complete configuration, once per config directory
+     *
+     * @param config - Parsed configuration file, or null if none was found
+     * @param configDir - Directory containing the config file
+     * @returns Configuration merged with inherited parent configs and defaults
+     *
+     * @internal
+     */
+    private static resolveConfig(config: Partial<TestConfig> | null, configDir: string | null): Promise<TestConfig> {
+        const key = configDir ?? ''
+        let result = this.resolvedCache.get(key)
+        if (!result) {
+            result = (async () => {
+                // If config has inherit field, load parent config and merge
+                if (config && config.inherit !== undefined && config.inherit !== false) {
+                    const parentConfig = configDir ? await this.loadParentConfig(configDir) : null
+                    const inheritedConfig = this.mergeInheritedConfig(config, parentConfig)
+                    return this.mergeWithDefaults(inheritedConfig, configDir)
+                }
+                return this.mergeWithDefaults(config, configDir)
+            })()
+            this.resolvedCache.set(key, result)
         }
-
-        // Cache the result
-        this.configCache.set(startDir, result)
         return result
     }
 
+    /**
+     * Clears cached configurations
+     *
+     * @remarks
+     * Used by watch mode when a testme.json5 file changes so the next run reloads it.
+     */
+    static clearCache(): void {
+        this.configCache.clear()
+        this.resolvedCache.clear()
+        this.fileCache.clear()
+    }
+
     /**
      * Searches for configuration file by walking up directory tree
      *
@@ -175,36 +220,50 @@ export class ConfigManager {
      * @remarks
      * Returns null for both config and configDir if no configuration file is found.
      * Uses JSON5 parser to allow comments and trailing commas in config files.
+     * Lookups are cached per directory (see clearCache()).
      */
     static async findConfigFile(
         startDir: string
     ): Promise<{config: Partial<TestConfig> | null; configDir: string | null}> {
-        let currentDir = startDir
-
-        while (true) {
-            const configPath = join(currentDir, this.CONFIG_FILENAME)
+        let result = this.fileCache.get(startDir)
+        if (!result) {
+            result = this.readConfigFile(startDir)
+            this.fileCache.set(startDir, result)
+        }
+        return await result
+    }
 
-            try {
-                const file = Bun.file(configPath)
-                if (await file.exists()) {
-                    const configText = await file.text()
-                    const config = JSON5.parse(configText) as Partial<TestConfig>
-                    return {config, configDir: currentDir}
-                }
-            } catch (error) {
-                console.error(ErrorMessages.configFileError(configPath, error))
-                // Continue searching in parent directories
-            }
+    /**
+     * Looks for a configuration file in one directory, then in its parents
+     *
+     * @param dir - Directory to look in
+     * @returns Object with parsed configuration and config directory path
+     *
+     * @internal
+     */
+    private static async readConfigFile(
+        dir: string
+    ): Promise<{config: Partial<TestConfig> | null; configDir: string | null}> {
+        const configPath = join(dir, this.CONFIG_FILENAME)
 
-            const parentDir = dirname(currentDir)
-            if (parentDir === currentDir) {
-                // Reached root directory
-                break
+        try {
+            const file = Bun.file(configPath)
+            if (await file.exists()) {
+                const configText = await file.text()
+                const config = JSON5.parse(configText) as Partial<TestConfig>
+                return {config, configDir: dir}
             }
-            currentDir = parentDir
+        } catch (error) {
+            console.error(ErrorMessages.configFileError(configPath, error))
+            // Continue searching in parent directories
         }
 
-        return {config: null, configDir: null}
+        const parentDir = dirname(dir)
+        if (parentDir === dir) {
+            // Reached root directory
+            return {config: null, configDir: null}
+        }
+        return await this.findConfigFile(parentDir)
     }
 
     /**
@@ -238,12 +297,15 @@ export class ConfigManager {
         let shallowestConfig: Partial<TestConfig> | null = null
         let shallowestConfigDir: string | null = null
         let shallowestDepth = Infinity
+        const visited = new Set<string>()
 
         // For each test directory, walk up to find configs
         for (const testDir of testDirectories) {
             let currentDir = testDir
 
-            while (true) {
+            // Stop where another test directory's walk already passed (its parents were all checked)
+            while (!visited.has(currentDir)) {
+                visited.add(currentDir)
                 const configPath = join(currentDir, this.CONFIG_FILENAME)
 
                 try {
@@ -593,7 +655,8 @@ export class ConfigManager {
 
         // Resolve relative paths in parent config to absolute paths
         // This allows child configs to inherit without path depth issues
-        const resolvedParentConfig = this.resolveConfigPaths(parentConfig, parentConfigDir)
+        // (on a copy: resolveConfigPaths updates nested flags and the parsed file is cached)
+        const resolvedParentConfig = this.resolveConfigPaths(structuredClone(parentConfig), parentConfigDir)
 
         // Substitute ${CONFIGDIR} with parent's absolute path before inheritance
         // This ensures child configs inherit the correct parent directory reference
@@ -637,7 +700,18 @@ export class ConfigManager {
         // Determine which keys to inherit
         const keysToInherit: string[] =
             childConfig.inherit === true
-                ? ['compiler', 'debug', 'execution', 'output', 'patterns', 'services', 'environment', 'env', 'profile']
+                ? [
+                      'compiler',
+                      'debug',
+                      'execution',
+                      'output',
+                      'patterns',
+                      'services',
+                      'benchmarks',
+                      'environment',
+                      'env',
+                      'profile',
+                  ]
                 : Array.isArray(childConfig.inherit)
                   ? childConfig.inherit
                   : []
@@ -658,6 +732,8 @@ export class ConfigManager {
                 inherited.patterns = this.deepMerge(parentConfig.patterns, childConfig.patterns || {})
             } else if (key === 'services' && parentConfig.services) {
                 inherited.services = {...parentConfig.services, ...childConfig.services}
+            } else if (key === 'benchmarks' && parentConfig.benchmarks) {
+                inherited.benchmarks = {...parentConfig.benchmarks, ...childConfig.benchmarks}
             } else if (key === 'environment') {
                 // Prefer 'environment' over 'env' from parent
                 const parentEnv = parentConfig.environment || parentConfig.env
@@ -781,6 +857,7 @@ export class ConfigManager {
                       ...this.DEFAULT_CONFIG.services,
                       ...userConfig.services,
                   },
+                  benchmarks: userConfig.benchmarks,
                   // Prefer 'environment' over 'env' for consistency, but support both for backward compatibility
                   environment: userConfig.environment || userConfig.env,
                   env: undefined, // Don't propagate deprecated 'env' key
@@ -1,7 +1,54 @@
 import type {TestFile, DiscoveryOptions} from './types.ts'
 import {TestType} from './types.ts'
-import {join, dirname, basename, extname} from 'path'
-import {readdir} from 'node:fs/promises'
+import {join, dirname, basename, extname, relative} from 'path'
+import {mkdir, readdir, stat} from 'node:fs/promises'
+import {createHash} from 'crypto'
+
+// Maximum concurrent directory reads during discovery
+const FAN_OUT = 32
+
+// Discovery index location (relative to the root directory) and format version
+const INDEX_FILE = join('.testme', 'discovery.json')
+const INDEX_VERSION = 1
+
+// Directories modified this recently are not indexed (their mtime may not reflect a concurrent change yet)
+const INDEX_SETTLE = 2000
+
+/*
+ Compiled glob pattern: one matcher per path segment, null for "**"
+ */
+type CompiledGlob = (RegExp | null)[]
+
+/*
+ Scan result of one directory, in readdir order
+ */
+type DirectoryScan = {
+    files: string[] // Names of files matching the include and exclude patterns
+    dirs: string[] // Names of subdirectories to search
+}
+
+/*
+ On-disk discovery index: directory scans keyed by path relative to the root, valid while the mtime is unchanged
+ */
+type DiscoveryIndex = {
+    version: number
+    key: string // Hash of the patterns the scans were filtered with
+    dirs: Record<string, DirectoryScan & {mtime: number}>
+}
+
+/*
+ State shared by the directories of one discovery run
+ */
+type DiscoveryRun = {
+    options: DiscoveryOptions
+    include: CompiledGlob[]
+    exclude: CompiledGlob[]
+    slots: number // Free directory read slots
+    waiting: (() => void)[] // Reads waiting for a slot
+    index?: DiscoveryIndex // Previous index (when options.index is enabled)
+    next?: DiscoveryIndex // Index being built by this run
+    started: number
+}
 
 /*
  TestDiscovery - Pattern-driven test file discovery engine
@@ -35,6 +82,12 @@ import {readdir} from 'node:fs/promises'
  - Platform-specific patterns enable platform-specific test files
  - Patterns are evaluated against relative paths from root directory
 
+ Performance:
+ - Directories are read concurrently with a bounded fan-out (FAN_OUT concurrent reads)
+ - Glob patterns are compiled once per pattern into per-segment matchers
+ - Optional discovery index (patterns.index) in .testme/discovery.json keyed on directory mtimes:
+   an unchanged directory is stat()ed instead of read and matched again
+
  Exclusions:
  - node_modules directories
  - .testme artifact directories
@@ -57,6 +110,9 @@ export class TestDiscovery {
         '.es': TestType.Ejscript,
     }
 
+    // Compiled glob patterns, shared by all discovery runs
+    private static readonly globs = new Map<string, CompiledGlob>()
+
     /*
      Discovers test files based on provided options
      @param options Discovery configuration including patterns and root directory
@@ -65,12 +121,28 @@ export class TestDiscovery {
      */
     static async discoverTests(options: DiscoveryOptions): Promise<TestFile[]> {
         const tests: TestFile[] = []
+        const run: DiscoveryRun = {
+            options,
+            include: options.patterns.map((pattern) => this.compileGlob(pattern)),
+            exclude: options.excludePatterns.map((pattern) => this.compileGlob(pattern)),
+            slots: FAN_OUT,
+            waiting: [],
+            started: Date.now(),
+        }
+        if (options.index) {
+            const key = this.getIndexKey(options)
+            run.index = await this.loadIndex(options.rootDir, key)
+            run.next = {version: INDEX_VERSION, key, dirs: {}}
+        }
 
         try {
-            await this.searchDirectory(options.rootDir, options, tests)
+            await this.searchDirectory(options.rootDir, run, tests)
         } catch (error) {
             throw new Error(`Failed to discover tests in ${options.rootDir}: ${error}`)
         }
+        if (run.next) {
+            await this.saveIndex(options.rootDir, run.next)
+        }
 
         return this.filterByPatterns(tests, options.patterns, options.rootDir)
     }
@@ -78,62 +150,144 @@ export class TestDiscovery {
     /*
      Recursively searches a directory for test files
      Pattern-driven: Only files matching include patterns are analyzed
-     Uses readdir with withFileTypes to avoid extra stat() calls
+     Subdirectories are searched concurrently; results keep the depth-first readdir order.
      @param dirPath Directory path to search
-     @param options Discovery options
+     @param run State of the discovery run
      @param tests Array to accumulate found test files
      */
-    private static async searchDirectory(dirPath: string, options: DiscoveryOptions, tests: TestFile[]): Promise<void> {
-        try {
-            const entries = await readdir(dirPath, {withFileTypes: true})
+    private static async searchDirectory(dirPath: string, run: DiscoveryRun, tests: TestFile[]): Promise<void> {
+        const scan = await this.scanDirectory(dirPath, run)
+        for (const name of scan.files) {
+            // Analyze file based on final extension
+            const testFile = this.analyzeFileByExtension(join(dirPath, name))
+            if (testFile) {
+                tests.push(testFile)
+            }
+        }
+        const found = await Promise.all(
+            scan.dirs.map(async (name) => {
+                const subtests: TestFile[] = []
+                await this.searchDirectory(join(dirPath, name), run, subtests)
+                return subtests
+            })
+        )
+        for (const subtests of found) {
+            tests.push(...subtests)
+        }
+    }
 
-            for (const entry of entries) {
-                const fullPath = join(dirPath, entry.name)
+    /*
+     Reads one directory, or reuses its indexed scan if the directory is unchanged
+     Uses readdir with withFileTypes to avoid extra stat() calls
+     @param dirPath Directory path to scan
+     @param run State of the discovery run
+     @returns Matching files and subdirectories to search
+     */
+    private static async scanDirectory(dirPath: string, run: DiscoveryRun): Promise<DirectoryScan> {
+        await this.acquire(run)
+        try {
+            const key = relative(run.options.rootDir, dirPath).replace(/\\/g, '/')
+            let mtime = 0
+            if (run.next) {
+                mtime = (await stat(dirPath)).mtimeMs
+                const cached = run.index?.dirs[key]
+                if (cached && cached.mtime === mtime) {
+                    run.next.dirs[key] = cached
+                    return cached
+                }
+            }
 
+            const scan: DirectoryScan = {files: [], dirs: []}
+            for (const entry of await readdir(dirPath, {withFileTypes: true})) {
                 if (entry.isDirectory()) {
                     // Skip excluded directories
-                    if (this.shouldSkipDirectory(entry.name)) {
-                        continue
+                    if (!this.shouldSkipDirectory(entry.name)) {
+                        scan.dirs.push(entry.name)
                     }
-
-                    // Recursively search subdirectories
-                    await this.searchDirectory(fullPath, options, tests)
                 } else if (entry.isFile()) {
-                    // First check if file matches include patterns
-                    if (this.matchesIncludePatterns(fullPath, options.patterns, options.rootDir)) {
-                        // Then check if it's excluded
-                        if (this.matchesExcludePatterns(fullPath, options.excludePatterns, options.rootDir)) {
-                            // Analyze file based on final extension
-                            const testFile = this.analyzeFileByExtension(fullPath)
-                            if (testFile) {
-                                tests.push(testFile)
-                            }
-                        }
+                    // File must match an include pattern and no exclude pattern
+                    const path = key ? `${key}/${entry.name}` : entry.name
+                    if (this.matchesAny(path, run.include) && !this.matchesAny(path, run.exclude)) {
+                        scan.files.push(entry.name)
                     }
                 }
             }
+            if (run.next && mtime < run.started - INDEX_SETTLE) {
+                run.next.dirs[key] = {...scan, mtime}
+            }
+            return scan
         } catch (error) {
             // Log warning but continue - might be permission issue
             console.warn(`Warning: Could not read directory ${dirPath}: ${error}`)
+            return {files: [], dirs: []}
+        } finally {
+            this.release(run)
         }
     }
 
     /*
-     Checks if a file matches any include patterns
-     @param filePath Full path to the file
-     @param patterns Array of include patterns
-     @param rootDir Root directory for relative path calculation
-     @returns true if file matches at least one include pattern
+     Waits for a free directory read slot
+     @param run State of the discovery run
+     */
+    private static async acquire(run: DiscoveryRun): Promise<void> {
+        if (run.slots > 0) {
+            run.slots--
+            return
+        }
+        await new Promise<void>((resolve) => run.waiting.push(resolve))
+    }
+
+    /*
+     Frees a directory read slot, handing it to the next waiting read
+     @param run State of the discovery run
      */
-    private static matchesIncludePatterns(filePath: string, patterns: string[], rootDir: string): boolean {
-        if (!patterns.length) return false
+    private static release(run: DiscoveryRun): void {
+        const next = run.waiting.shift()
+        if (next) {
+            next()
+        } else {
+            run.slots++
+        }
+    }
 
-        const relativePath = filePath.startsWith(rootDir)
-            ? filePath.slice(rootDir.length).replace(/^[\/\\]/, '')
-            : filePath
-        const normalizedPath = relativePath.replace(/\\/g, '/')
+    /*
+     Computes the key identifying the patterns an index was built with
+     @param options Discovery options
+     @returns Hash of the root directory and patterns
+     */
+    private static getIndexKey(options: DiscoveryOptions): string {
+        const source = JSON.stringify([options.rootDir, options.patterns, options.excludePatterns])
+        return createHash('sha256').update(source).digest('hex').slice(0, 16)
+    }
 
-        return patterns.some((pattern) => this.matchesGlob(normalizedPath, pattern))
+    /*
+     Loads the discovery index
+     @param rootDir Root directory
+     @param key Expected pattern key
+     @returns Index, or undefined if missing, unreadable or built with other patterns
+     */
+    private static async loadIndex(rootDir: string, key: string): Promise<DiscoveryIndex | undefined> {
+        try {
+            const index = (await Bun.file(join(rootDir, INDEX_FILE)).json()) as DiscoveryIndex
+            return index.version === INDEX_VERSION && index.key === key ? index : undefined
+        } catch {
+            return undefined
+        }
+    }
+
+    /*
+     Saves the discovery index. Failures are ignored (the index is only an optimization).
+     @param rootDir Root directory
+     @param index Index built by this run
+     */
+    private static async saveIndex(rootDir: string, index: DiscoveryIndex): Promise<void> {
+        try {
+            const path = join(rootDir, INDEX_FILE)
+            await mkdir(dirname(path), {recursive: true})
+            await Bun.write(path, JSON.stringify(index))
+        } catch {
+            // Read-only checkout
+        }
     }
 
     /*
@@ -199,7 +353,7 @@ export class TestDiscovery {
     static matchesExcludePatterns(filePath: string, excludePatterns: string[], rootDir: string): boolean {
         if (!excludePatterns.length) return true
 
-        // Calculate relative path and normalize separators (like matchesIncludePatterns)
+        // Calculate relative path and normalize separators
         const relativePath = filePath.startsWith(rootDir)
             ? filePath.slice(rootDir.length).replace(/^[\/\\]/, '')
             : filePath
@@ -362,38 +516,66 @@ export class TestDiscovery {
      @returns true if text matches pattern
      */
     private static matchesGlob(text: string, pattern: string): boolean {
-        // Simple manual glob matching without complex regex
-        // Split pattern into segments
-        const patternParts = pattern.split('/')
+        return this.matchGlobParts(text.split('/'), 0, this.compileGlob(pattern), 0)
+    }
+
+    /*
+     Checks if text matches any of a set of compiled patterns
+     @param text Relative path with forward slashes
+     @param globs Compiled patterns
+     @returns true if at least one pattern matches
+     */
+    private static matchesAny(text: string, globs: CompiledGlob[]): boolean {
+        if (!globs.length) return false
         const textParts = text.split('/')
+        return globs.some((glob) => this.matchGlobParts(textParts, 0, glob, 0))
+    }
 
-        return this.matchGlobParts(textParts, patternParts)
+    /*
+     Compiles a glob pattern into per-segment matchers (cached per pattern)
+     @param pattern Glob pattern
+     @returns Segment matchers, null for "**" segments
+     */
+    private static compileGlob(pattern: string): CompiledGlob {
+        let glob = this.globs.get(pattern)
+        if (!glob) {
+            glob = pattern.split('/').map((part) => {
+                if (part === '**') {
+                    return null
+                }
+                // Convert glob pattern to regex for single segment
+                const regexPattern = part
+                    .replace(/[.+^${}()|[\]\\]/g, '\\$&') // Escape regex special chars
+                    .replace(/\*/g, '.*') // * matches anything
+                    .replace(/\?/g, '.') // ? matches single char
+                return new RegExp(`^${regexPattern}$`, 'i')
+            })
+            this.globs.set(pattern, glob)
+        }
+        return glob
     }
 
     /*
-     Recursively matches glob pattern parts against text parts
+     Recursively matches compiled glob segments against text segments
      @param textParts Text split by /
-     @param patternParts Pattern split by /
+     @param ti Index of the next text segment
+     @param glob Compiled pattern
+     @param gi Index of the next pattern segment
      @returns true if match
      */
-    private static matchGlobParts(textParts: string[], patternParts: string[]): boolean {
-        // Base case: both empty = match
-        if (patternParts.length === 0 && textParts.length === 0) {
-            return true
+    private static matchGlobParts(textParts: string[], ti: number, glob: CompiledGlob, gi: number): boolean {
+        // Pattern consumed: match only if the text is consumed too
+        if (gi === glob.length) {
+            return ti === textParts.length
         }
 
-        // Pattern empty but text remains = no match
-        if (patternParts.length === 0) {
-            return false
-        }
-
-        const [patternHead, ...patternTail] = patternParts
+        const segment = glob[gi]
 
         // Handle ** (matches zero or more path segments)
-        if (patternHead === '**') {
+        if (segment === null) {
             // Try matching with ** consuming 0, 1, 2, ... segments
-            for (let i = 0; i <= textParts.length; i++) {
-                if (this.matchGlobParts(textParts.slice(i), patternTail)) {
+            for (let i = ti; i <= textParts.length; i++) {
+                if (this.matchGlobParts(textParts, i, glob, gi + 1)) {
                     return true
                 }
             }
@@ -401,35 +583,12 @@ export class TestDiscovery {
         }
 
         // Text empty but pattern remains (and it's not **) = no match
-        if (textParts.length === 0) {
+        if (ti === textParts.length) {
             return false
         }
 
-        const [textHead, ...textTail] = textParts
-
         // Match current segment
-        if (this.matchSegment(textHead, patternHead)) {
-            return this.matchGlobParts(textTail, patternTail)
-        }
-
-        return false
-    }
-
-    /*
-     Matches a single path segment with * and ? wildcards
-     @param text Text segment
-     @param pattern Pattern segment
-     @returns true if match
-     */
-    private static matchSegment(text: string, pattern: string): boolean {
-        // Convert glob pattern to regex for single segment
-        const regexPattern = pattern
-            .replace(/[.+^${}()|[\]\\]/g, '\\$&') // Escape regex special chars
-            .replace(/\*/g, '.*') // * matches anything
-            .replace(/\?/g, '.') // ? matches single char
-
-        const regex = new RegExp(`^${regexPattern}$`, 'i')
-        return regex.test(text)
+        return segment!.test(textParts[ti]!) && this.matchGlobParts(textParts, ti + 1, glob, gi + 1)
     }
 
     /*
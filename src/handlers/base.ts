@@ -1,10 +1,19 @@
-import type {TestFile, TestResult, TestConfig, TestHandler} from '../types.ts'
+import type {TestFile, TestResult, TestConfig, TestHandler, ResourceUsage} from '../types.ts'
 import {TestStatus} from '../types.ts'
 import {GlobExpansion} from '../utils/glob-expansion.ts'
 import {ErrorMessages} from '../utils/error-messages.ts'
 import {PlatformDetector} from '../platform/detector.ts'
 import {countAssertions} from '../utils/assertion-counter.ts'
-import {resolve} from 'path'
+import type {AssertionCounts} from '../utils/assertion-counter.ts'
+import {parseBenchmarks, parsePerfRecords} from '../utils/benchmarks.ts'
+import {OutputCapture} from '../utils/output-capture.ts'
+import {readResults, resetResults} from '../utils/result-channel.ts'
+import {Trace} from '../utils/trace.ts'
+import {Cancellation} from '../utils/cancel.ts'
+import {ProcessManager} from '../platform/process.ts'
+import {toResourceUsage} from '../utils/resource-usage.ts'
+import {Log} from '../utils/log.ts'
+import {basename, join, resolve} from 'path'
 
 /*
  Abstract base class for all test handlers
@@ -47,8 +56,9 @@ export abstract class BaseTestHandler implements TestHandler {
      Executes a system command with timeout and environment options
      @param command Command to execute
      @param args Command arguments
-     @param options Execution options (cwd, timeout, env, config for live streaming, description for error messages)
-     @returns Promise resolving to command execution results
+     @param options Execution options (cwd, timeout, env, config for live streaming, description for error messages,
+            logDir for the complete output of oversized streams, resultFile for structured results)
+     @returns Promise resolving to command execution results, with the resources the process used
      */
     protected async runCommand(
         command: string,
@@ -59,8 +69,16 @@ export abstract class BaseTestHandler implements TestHandler {
             env?: Record<string, string>
             config?: TestConfig
             description?: string
+            logDir?: string // Directory for the complete output of streams exceeding output.captureLimit
+            resultFile?: string // Structured result file passed to the test as TESTME_RESULT_FILE
         } = {}
-    ): Promise<{exitCode: number; stdout: string; stderr: string}> {
+    ): Promise<{
+        exitCode: number
+        stdout: string
+        stderr: string
+        assertions?: AssertionCounts
+        resources?: ResourceUsage
+    }> {
         // Build environment - be defensive about PATH handling on Windows
         const spawnEnv: Record<string, string> = {}
 
@@ -76,6 +94,12 @@ export abstract class BaseTestHandler implements TestHandler {
             spawnEnv[key] = value
         }
 
+        // Structured result channel: the test appends NDJSON records instead of relying on output scanning
+        if (options.resultFile) {
+            await resetResults(options.resultFile)
+            spawnEnv.TESTME_RESULT_FILE = options.resultFile
+        }
+
         // On Windows, if we have a custom PATH, ensure it completely replaces any variants
         if (PlatformDetector.isWindows() && options.env?.PATH) {
             // Remove any case variants from process.env, keep only our uppercase PATH
@@ -86,6 +110,17 @@ export abstract class BaseTestHandler implements TestHandler {
             }
         }
 
+        // Work of a cancelled suite (fast-fail or interrupt) is not started
+        const signal = Cancellation.signal
+        if (signal?.aborted) {
+            Cancellation.markCancelled()
+            return {exitCode: -1, stdout: '', stderr: Cancellation.describe(signal)}
+        }
+
+        // Compiler processes are traced as compile time, others as spawn and run time
+        const spanName = options.description || basename(command)
+        const compiling = Trace.stage === 'compile'
+        const spawning = performance.now()
         const proc = Bun.spawn([command, ...args], {
             cwd: options.cwd,
             env: spawnEnv,
@@ -93,12 +128,21 @@ export abstract class BaseTestHandler implements TestHandler {
             stderr: 'pipe',
             stdin: PlatformDetector.isWindows() ? 'pipe' : 'ignore',
         })
+        const running = performance.now()
+        Trace.record(`spawn ${spanName}`, compiling ? 'compile' : 'spawn', spawning, running)
 
         // On Windows, close stdin pipe immediately to prevent process from waiting for input
         if (PlatformDetector.isWindows() && proc.stdin) {
             proc.stdin.end()
         }
 
+        // Kill the whole process tree as soon as the suite is cancelled
+        let cancelled: AbortSignal | undefined
+        const removeCancel = Cancellation.onCancel((signal) => {
+            cancelled = signal
+            void ProcessManager.killProcessTree(proc.pid)
+        })
+
         let timeoutId: Timer | undefined
         let timedOut = false
 
@@ -115,100 +159,73 @@ export abstract class BaseTestHandler implements TestHandler {
             // When user explicitly requests monitor mode (-m/--monitor), honor it regardless of TTY status
             const shouldStream = options.config?.output?.live && !options.config?.output?.quiet
 
-            let stdout = ''
-            let stderr = ''
-
-            if (shouldStream) {
-                // Stream output in real-time while also buffering
-                const stdoutReader = proc.stdout.getReader()
-                const stderrReader = proc.stderr.getReader()
-                const decoder = new TextDecoder()
-
-                const readStream = async (
-                    reader: ReadableStreamDefaultReader<Uint8Array>,
-                    isStderr: boolean
-                ): Promise<string> => {
-                    let buffer = ''
-                    try {
-                        while (true) {
-                            const {done, value} = await reader.read()
-                            if (done) break
-
-                            const text = decoder.decode(value, {stream: true})
-                            buffer += text
-
-                            // Stream to console in real-time
+            // Capture output in bounded memory. Oversized streams keep their head and tail, and the
+            // complete stream is written to <logDir>/stdout.log or stderr.log
+            const limitMB = options.config?.output?.captureLimit
+            const limit = limitMB ? limitMB * 1024 * 1024 : undefined
+            const logPath = (name: string) => (options.logDir ? join(options.logDir, name) : undefined)
+
+            const readStream = async (stream: ReadableStream<Uint8Array>, isStderr: boolean): Promise<string> => {
+                const capture = new OutputCapture(limit, logPath(isStderr ? 'stderr.log' : 'stdout.log'))
+                const reader = stream.getReader()
+                try {
+                    while (true) {
+                        const {done, value} = await reader.read()
+                        if (done) break
+
+                        const text = await capture.write(value)
+
+                        // Stream to console in real-time
+                        if (shouldStream) {
                             if (isStderr) {
                                 process.stderr.write(text)
                             } else {
-                                process.stdout.write(text)
+                                Log.stream.write(text)
                             }
                         }
-                    } finally {
-                        reader.releaseLock()
                     }
-                    return buffer
+                } finally {
+                    reader.releaseLock()
                 }
+                return await capture.finish()
+            }
 
-                // Read both streams concurrently with process exit
-                const [result, stdoutText, stderrText] = await Promise.all([
-                    proc.exited,
-                    readStream(stdoutReader as any, false),
-                    readStream(stderrReader as any, true),
-                ])
-
-                stdout = stdoutText
-                stderr = stderrText
+            // Read both streams concurrently with process exit
+            const [result, stdout, stderr] = await Promise.all([
+                proc.exited,
+                readStream(proc.stdout, false),
+                readStream(proc.stderr, true),
+            ])
+            Trace.record(spanName, compiling ? 'compile' : 'run', running, performance.now(), {exitCode: result})
+            const resources = toResourceUsage(proc.resourceUsage())
 
-                if (timeoutId) {
-                    clearTimeout(timeoutId)
-                }
+            if (timeoutId) {
+                clearTimeout(timeoutId)
+            }
 
-                if (timedOut) {
-                    const timeoutSeconds = Math.round((options.timeout || 0) / 1000)
-                    const description = options.description || `${command} ${args.join(' ')}`
-                    return {
-                        exitCode: -1,
-                        stdout,
-                        stderr: stderr + `\n${description} timed out after ${timeoutSeconds}s`,
-                    }
-                }
+            if (cancelled) {
+                return {exitCode: -1, stdout, stderr: stderr + `\n${Cancellation.describe(cancelled)}`, resources}
+            }
 
+            if (timedOut) {
+                const timeoutSeconds = Math.round((options.timeout || 0) / 1000)
+                const description = options.description || `${command} ${args.join(' ')}`
                 return {
-                    exitCode: result,
+                    exitCode: -1,
                     stdout,
-                    stderr,
-                }
-            } else {
-                // Original buffered mode - read all at once
-                const [result, stdoutText, stderrText] = await Promise.all([
-                    proc.exited,
-                    new Response(proc.stdout).text(),
-                    new Response(proc.stderr).text(),
-                ])
-
-                stdout = stdoutText
-                stderr = stderrText
-
-                if (timeoutId) {
-                    clearTimeout(timeoutId)
-                }
-
-                if (timedOut) {
-                    const timeoutSeconds = Math.round((options.timeout || 0) / 1000)
-                    const description = options.description || `${command} ${args.join(' ')}`
-                    return {
-                        exitCode: -1,
-                        stdout,
-                        stderr: stderr + `\n${description} timed out after ${timeoutSeconds}s`,
-                    }
+                    stderr: stderr + `\n${description} timed out after ${timeoutSeconds}s`,
+                    resources,
                 }
+            }
 
-                return {
-                    exitCode: result,
-                    stdout,
-                    stderr,
-                }
+            // Counts from structured records replace counting ✓/✗ in the output
+            const assertions = options.resultFile ? await readResults(options.resultFile) : null
+            return {
+                exitCode: result,
+                stdout,
+                stderr,
+                ...(assertions && {assertions}),
+                resources,
             }
         } catch (error) {
             if (timeoutId) {
@@ -258,6 +275,8 @@ Original error: ${error}`
                 stdout: '',
                 stderr: errorMessage,
             }
+        } finally {
+            removeCancel()
         }
     }
 
@@ -279,6 +298,11 @@ Original error: ${error}`
         // Set TESTME_QUIET (always set to 0 or 1)
         env.TESTME_QUIET = config.output?.quiet === true ? '1' : '0'
 
+        // Set TESTME_QUIET_PASS so testme.h counts passing assertions without printing them
+        if (config.output?.quietPass === true && config.output?.verbose !== true) {
+            env.TESTME_QUIET_PASS = '1'
+        }
+
         // Set TESTME_KEEP (always set to 0 or 1)
         env.TESTME_KEEP = config.execution?.keepArtifacts === true ? '1' : '0'
 
@@ -490,6 +514,7 @@ Original error: ${error}`
      @param output Combined output from the test
      @param error Error message if test failed
      @param exitCode Process exit code
+     @param resources Resources used by the test process
      @returns TestResult object
      */
     protected createTestResult(
@@ -498,11 +523,18 @@ Original error: ${error}`
         duration: number,
         output: string,
         error?: string,
-        exitCode?: number
+        exitCode?: number,
+        resources?: ResourceUsage
     ): TestResult {
         // Count assertions in output (✓ and ✗ symbols from test macros)
         const assertions = countAssertions(output)
 
+        // Collect benchmark records (TESTME_BENCH lines from tbench/tBenchmark)
+        const benchmarks = parseBenchmarks(output)
+
+        // Collect counter regions (TESTME_PERF lines from tPerfBegin/tPerfEnd)
+        const perf = parsePerfRecords(output)
+
         return {
             file,
             status,
@@ -511,6 +543,22 @@ Original error: ${error}`
             error,
             exitCode,
             assertions: assertions || undefined,
+            benchmarks: benchmarks || undefined,
+            perf: perf || undefined,
+            resources,
+        }
+    }
+
+    /*
+     Applies structured assertion counts (worker messages or the result file) to a test result
+     Records replace the ✓/✗ counts from the output, which a test's own output can inflate. The output
+     counts are only kept when no records were written, e.g. by a test not using testme
+     @param testResult Result created from the test output
+     @param counts Structured assertion counts
+     */
+    protected applyAssertionCounts(testResult: TestResult, counts: AssertionCounts): void {
+        if (counts.passed + counts.failed > 0) {
+            testResult.assertions = counts
         }
     }
 
@@ -587,23 +635,23 @@ Original error: ${error}`
             return
         }
 
-        console.log(`📄 Config used for ${file.name}:`)
-        console.log(this.formatConfig(config))
+        Log.info(`📄 Config used for ${file.name}:`)
+        Log.info(this.formatConfig(config))
 
         // Show environment variables defined by TestMe
         if (Object.keys(testEnv).length > 0) {
-            console.log(`\n🌍 TestMe environment variables:`)
+            Log.info(`\n🌍 TestMe environment variables:`)
             for (const [key, value] of Object.entries(testEnv)) {
-                console.log(`   ${key}=${value}`)
+                Log.info(`   ${key}=${value}`)
             }
         }
 
         // Show full environment if verbose mode is enabled
         if (config.output?.verbose) {
-            console.log(`\n🌍 Full environment (${Object.keys(process.env).length} variables):`)
+            Log.info(`\n🌍 Full environment (${Object.keys(process.env).length} variables):`)
             const sortedKeys = Object.keys(process.env).sort()
             for (const key of sortedKeys) {
-                console.log(`   ${key}=${process.env[key]}`)
+                Log.info(`   ${key}=${process.env[key]}`)
             }
         }
     }
@@ -4,19 +4,70 @@ import {BaseTestHandler} from './base.ts'
 import {ArtifactManager} from '../artifacts.ts'
 import {GlobExpansion} from '../utils/glob-expansion.ts'
 import {CompilerManager, CompilerType} from '../platform/compiler.ts'
+import type {CompilerConfig, Instrumentation} from '../platform/compiler.ts'
 import {PermissionManager} from '../platform/permissions.ts'
 import {PlatformDetector} from '../platform/detector.ts'
 import {ErrorMessages} from '../utils/error-messages.ts'
-import {basename, resolve, isAbsolute, join} from 'path'
-import {stat} from 'fs/promises'
+import {CompileCache} from '../utils/compile-cache.ts'
+import {Coverage} from '../utils/coverage.ts'
+import {ForkServer} from '../utils/fork-server.ts'
+import {RESULT_FILE} from '../utils/result-channel.ts'
+import {Trace} from '../utils/trace.ts'
+import {findUnityTests, generateDriver, stripUnityFraming, writeIfChanged} from '../utils/unity.ts'
+import {PCH_DIR, PCH_HEADER, PCH_SOURCE, canPrecompile, getPchName} from '../utils/pch.ts'
+import type {PrecompiledHeader} from '../utils/pch.ts'
+import {Log} from '../utils/log.ts'
+import {basename, dirname, resolve, relative, isAbsolute, join} from 'path'
+import {existsSync} from 'fs'
+import {rename, stat} from 'fs/promises'
+import {createHash} from 'crypto'
 import os from 'os'
 
+// Artifact recording the compile command hash and header dependencies of the cached binary
+// (compile-<variant>.deps for instrumented builds)
+const DEPS_ARTIFACT = 'compile.deps'
+const DEPS_PATTERN = /^compile(-[\w-]+)?\.deps$/
+
+/*
+ Result of compiling a C test
+ */
+export type CompileOutcome = {
+    success: boolean
+    duration: number
+    output: string
+    error?: string
+    compiler?: string
+    skipped?: boolean // Binary reused from the artifact directory or compile cache
+    driver?: boolean // Built from a generated TM_TEST driver (output is framed per test file)
+}
+
+/*
+ Compiler flags and library flags resolved from a test's compiler.c settings
+ */
+type ResolvedFlags = {
+    flags: string[] // Compiler defaults and user flags, expanded and with relative paths resolved
+    libraryFlags: string[] // Libraries in the compiler's link syntax
+}
+
 /*
  Handler for executing C program tests (.tst.c files)
  Compiles C source to binary in artifact directory, then executes
  */
 export class CTestHandler extends BaseTestHandler {
     private artifactManager: ArtifactManager
+    // Result of build() when the test was compiled ahead of execution by the compile pool
+    private prebuilt?: CompileOutcome
+    // Checkpointed test process serving repeated runs (execution.forkServer with execution.repeat)
+    private forkServer?: ForkServer
+    // Compiler version banners used in compile cache keys, keyed by compiler path
+    private static compilerIdentities = new Map<string, Promise<string>>()
+    // Repository root containing a config directory (undefined outside a repository)
+    private static repositories = new Map<string, string | undefined>()
+    // Resolved flags by compiler.c settings object (replaced when watch mode reloads a config), then by
+    // compiler, profile and directory
+    private static resolvedFlags = new WeakMap<object, Map<string, Promise<ResolvedFlags>>>()
+    // Precompiled testme.h by config directory, compiler and flags (undefined if it could not be built)
+    private static precompiled = new Map<string, Promise<PrecompiledHeader | undefined>>()
 
     /*
      Creates a new C test handler with artifact management
@@ -44,6 +95,17 @@ export class CTestHandler extends BaseTestHandler {
         await this.artifactManager.createArtifactDir(file)
     }
 
+    /*
+     Compiles C test ahead of execution
+     Called by the runner's compile pool so compiles overlap with running other tests.
+     The result is consumed by the next execute() call.
+     @param file C test file to compile
+     @param config Test execution configuration
+     */
+    async build(file: TestFile, config: TestConfig): Promise<void> {
+        this.prebuilt = await this.compile(file, config)
+    }
+
     /*
      Compiles and executes C test, returning combined results
      @param file C test file to execute
@@ -51,8 +113,11 @@ export class CTestHandler extends BaseTestHandler {
      @returns Promise resolving to test results
      */
     async execute(file: TestFile, config: TestConfig): Promise<TestResult> {
-        // First compile the C program
-        const compileResult = await this.compile(file, config)
+        // First compile the C program (unless already compiled by build())
+        const compileResult = this.prebuilt ?? (await this.compile(file, config))
+        const repeat = config.execution?.repeat ?? 1
+        // Repeated runs (execution.repeat) reuse the first compile
+        this.prebuilt = repeat > 1 ? {...compileResult, duration: 0, output: ''} : undefined
         if (!compileResult.success) {
             return this.createTestResult(
                 file,
@@ -69,24 +134,54 @@ export class CTestHandler extends BaseTestHandler {
         }
 
         // Normal execution
+        const binaryPath = this.getBinaryPath(file, config)
+        const coverage = this.getInstrumentation(config)?.coverage
+        if (coverage) {
+            await Coverage.reset(binaryPath)
+        }
         const {result, duration} = await this.measureExecution(async () => {
-            const binaryPath = this.getBinaryPath(file)
-
+            const timeout = (config.execution?.timeout || 30) * 1000
+            const env = await this.getTestEnvironment(config, file, compileResult.compiler)
+
+            // Fork-server mode: start the binary once and fork a fresh child per repeated run
+            if (config.execution?.forkServer && repeat > 1 && !PlatformDetector.isWindows()) {
+                this.forkServer ??= new ForkServer(binaryPath, {cwd: file.directory, env, timeout, runs: repeat})
+                if (!this.forkServer.closed) {
+                    return await this.forkServer.run()
+                }
+            }
             return await this.runCommand(binaryPath, [], {
                 cwd: file.directory, // Always run test with CWD set to test directory
-                timeout: (config.execution?.timeout || 30) * 1000,
-                env: await this.getTestEnvironment(config, file, compileResult.compiler),
+                timeout,
+                env,
                 config,
                 description: `Test ${file.name}`,
+                logDir: file.artifactDir,
+                resultFile: join(file.artifactDir, RESULT_FILE),
             })
         })
 
+        // Count the coverage of this run before a passed test's artifacts are cleaned
+        if (coverage) {
+            await Coverage.collect(binaryPath)
+        }
+
         const totalDuration = compileResult.duration + duration
         const status = result.exitCode === 0 ? TestStatus.Passed : TestStatus.Failed
-        const output = this.combineOutputs(compileResult.output, result.stdout, result.stderr)
-        const error = result.exitCode !== 0 ? result.stderr : undefined
-
-        return this.createTestResult(file, status, totalDuration, output, error, result.exitCode)
+        // Drivers merge stderr into stdout, so failures are reported from the whole output
+        const stdout = compileResult.driver ? stripUnityFraming(result.stdout) : result.stdout
+        const output = this.combineOutputs(compileResult.output, stdout, result.stderr)
+        const error =
+            result.exitCode !== 0 ? (compileResult.driver ? stdout + result.stderr : result.stderr) : undefined
+
+        // Forked runs are children of the fork server, which does not report their resource usage
+        const resources = 'resources' in result ? result.resources : undefined
+        const testResult = this.createTestResult(file, status, totalDuration, output, error, result.exitCode, resources)
+        if ('assertions' in result && result.assertions) {
+            // Structured results from the result file replace counting ✓/✗ in the output
+            this.applyAssertionCounts(testResult, result.assertions)
+        }
+        return testResult
     }
 
     /*
@@ -102,267 +197,164 @@ export class CTestHandler extends BaseTestHandler {
 
     /*
      Compiles C source file to executable binary
-     Skips compilation if binary exists and is newer than source (unless --rebuild is set)
+     Skips compilation if the binary is newer than the source and every header it includes, and
+     the compile command is unchanged (unless --rebuild is set)
      @param file C test file to compile
      @param config Test configuration with compiler settings
      @returns Compilation result with success status, duration, and output
      */
-    private async compile(
-        file: TestFile,
-        config: TestConfig
-    ): Promise<{
-        success: boolean
-        duration: number
-        output: string
-        error?: string
-        compiler?: string
-        skipped?: boolean
-    }> {
-        const binaryPath = this.getBinaryPath(file)
+    protected async compile(file: TestFile, config: TestConfig): Promise<CompileOutcome> {
+        return await Trace.span(`compile ${file.name}`, 'compile', () => this.compileTest(file, config))
+    }
+
+    /*
+     Compiles a test (see compile())
+     @param file C test file to compile
+     @param config Test configuration with compiler settings
+     @returns Compilation result with success status, duration, and output
+     */
+    private async compileTest(file: TestFile, config: TestConfig): Promise<CompileOutcome> {
+        const binaryPath = this.getBinaryPath(file, config)
+        const baseDir = config.configDir || file.directory
+        const unit = await this.getCompileUnit(file)
+        const driver = unit.path !== file.path
 
-        // Check if we can skip compilation (binary exists and is newer than source)
+        // Get compiler configuration (auto-detect if not specified)
+        const compilerConfig = await CompilerManager.getDefaultCompilerConfig(
+            this.resolveCompilerName(config.compiler?.c?.compiler)
+        )
+        const compilerName = this.getCompilerName(compilerConfig.type)
+
+        // Sanitizer and coverage flags of an instrumented build (compiler.c.sanitize and compiler.c.coverage)
+        let instrumentation: Instrumentation | undefined
+        let instrumentFlags: string[] = []
+        try {
+            instrumentation = this.getInstrumentation(config)
+            if (instrumentation) {
+                instrumentFlags = CompilerManager.getInstrumentFlags(compilerConfig.type, instrumentation)
+            }
+        } catch (error) {
+            return {success: false, duration: 0, output: '', error: (error as Error).message, compiler: compilerName}
+        }
+
+        // Build the full compile command. Its hash invalidates the cached binary when the
+        // compiler, flags or libraries change.
+        const {args, preprocessArgs} = await this.buildCompileArgs(
+            unit,
+            config,
+            compilerConfig,
+            binaryPath,
+            instrumentFlags
+        )
+        const commandHash = this.hashCompileCommand(compilerConfig, args)
+
+        // Check if we can skip compilation (binary is newer than source and all headers it includes)
         if (!config.execution?.rebuild) {
-            const needsCompile = await this.needsRecompilation(file.path, binaryPath)
+            const needsCompile = await this.needsRecompilation(unit, config, binaryPath, commandHash)
             if (!needsCompile) {
-                // Get compiler info for environment setup (still needed for execution)
-                const compilerConfig = await CompilerManager.getDefaultCompilerConfig(
-                    this.resolveCompilerName(config.compiler?.c?.compiler)
-                )
-                const compilerName =
-                    compilerConfig.type === CompilerType.GCC
-                        ? 'gcc'
-                        : compilerConfig.type === CompilerType.Clang
-                          ? 'clang'
-                          : compilerConfig.type === CompilerType.MSVC
-                            ? 'msvc'
-                            : undefined
-
                 return {
                     success: true,
                     duration: 0,
-                    output: 'Using cached binary (source unchanged)',
+                    output: 'Using cached binary (sources and compile command unchanged)',
                     compiler: compilerName,
                     skipped: true,
+                    driver,
                 }
             }
         }
 
-        const {result, duration} = await this.measureExecution(async () => {
-            const baseDir = config.configDir || file.directory
-
-            // Get compiler configuration (auto-detect if not specified)
-            const compilerConfig = await CompilerManager.getDefaultCompilerConfig(
-                this.resolveCompilerName(config.compiler?.c?.compiler)
-            )
-
-            // Get compiler-specific or default flags and libraries
-            let userFlags: string[] = []
-            let rawLibraries: string[] = []
-
-            // Select flags based on detected compiler type
-            const cConfig = config.compiler?.c
-            if (cConfig) {
-                // Determine current platform
-                const platform = PlatformDetector.isWindows()
-                    ? 'windows'
-                    : PlatformDetector.isMacOS()
-                      ? 'macosx'
-                      : 'linux'
-
-                // Start with generic flags/libraries (if present)
-                userFlags = [...(cConfig.flags || [])]
-                rawLibraries = [...(cConfig.libraries || [])]
-
-                // Add compiler-specific config on top
-                if (compilerConfig.type === CompilerType.MSVC && cConfig.msvc) {
-                    if (cConfig.msvc.flags) userFlags.push(...cConfig.msvc.flags)
-                    if (cConfig.msvc.libraries) rawLibraries.push(...cConfig.msvc.libraries)
-                    // Check for platform-specific overrides
-                    const platformSettings = cConfig.msvc[platform]
-                    if (platformSettings) {
-                        if (platformSettings.flags) userFlags.push(...platformSettings.flags)
-                        if (platformSettings.libraries) rawLibraries.push(...platformSettings.libraries)
-                    }
-                } else if (compilerConfig.type === CompilerType.GCC && cConfig.gcc) {
-                    if (cConfig.gcc.flags) userFlags.push(...cConfig.gcc.flags)
-                    if (cConfig.gcc.libraries) rawLibraries.push(...cConfig.gcc.libraries)
-                    // Check for platform-specific overrides
-                    const platformSettings = cConfig.gcc[platform]
-                    if (platformSettings) {
-                        if (platformSettings.flags) userFlags.push(...platformSettings.flags)
-                        if (platformSettings.libraries) rawLibraries.push(...platformSettings.libraries)
-                    }
-                } else if (compilerConfig.type === CompilerType.Clang && cConfig.clang) {
-                    if (cConfig.clang.flags) userFlags.push(...cConfig.clang.flags)
-                    if (cConfig.clang.libraries) rawLibraries.push(...cConfig.clang.libraries)
-                    // Check for platform-specific overrides
-                    const platformSettings = cConfig.clang[platform]
-                    if (platformSettings) {
-                        if (platformSettings.flags) userFlags.push(...platformSettings.flags)
-                        if (platformSettings.libraries) rawLibraries.push(...platformSettings.libraries)
-                    }
-                }
-            }
-
-            // Merge compiler defaults with user flags (defaults first, then user overrides)
-            let flags = [...compilerConfig.flags, ...userFlags]
-
-            // Create special variables for expansion
-            const specialVars = GlobExpansion.createSpecialVariables(
-                file.artifactDir,
-                file.directory,
-                config.configDir,
-                compilerConfig.compiler,
-                config.profile
-            )
-
-            // Expand ${...} references in flags and libraries
-            const expandedFlags = await GlobExpansion.expandArray(flags, baseDir, specialVars)
-            const expandedLibraries = await GlobExpansion.expandArray(rawLibraries, baseDir, specialVars)
-
-            // Normalize rpath values for the current platform
-            const normalizedFlags = CompilerManager.normalizePlatformRpaths(expandedFlags)
-
-            // Convert relative paths to absolute paths since we compile from artifact directory
-            flags = this.resolveRelativePaths(normalizedFlags, baseDir)
-            const libraries = this.resolveRelativePaths(expandedLibraries, baseDir)
-
-            // Process libraries based on compiler type
-            const libraryFlags = CompilerManager.processLibraries(libraries, compilerConfig.type)
-
-            // Build compiler arguments based on compiler type
-            const args: string[] = []
-
-            if (compilerConfig.type === CompilerType.MSVC) {
-                // MSVC syntax: cl.exe [compiler flags] /Fe:output.exe input.c /link [linker flags]
-
-                // Separate compiler flags from linker flags
-                const compilerFlags: string[] = []
-                const linkerFlags: string[] = []
-
-                for (const flag of flags) {
-                    if (flag.startsWith('/LIBPATH:') || flag.endsWith('.lib') || flag.endsWith('.obj')) {
-                        linkerFlags.push(flag)
-                    } else {
-                        compilerFlags.push(flag)
+        // Fetch a ready binary from the shared compile cache instead of spawning the compiler.
+        // GCC coverage builds also need the .gcno notes written by the compiler, so they always compile.
+        const cacheConfig = config.compiler?.c?.cache
+        const gcov = instrumentation?.coverage && compilerConfig.type !== CompilerType.Clang
+        const cache = cacheConfig?.enable && !gcov ? new CompileCache(cacheConfig, baseDir) : undefined
+        let cacheKey: string | undefined
+        if (cache) {
+            const started = performance.now()
+            const preprocessed = await this.preprocess(unit, compilerConfig, preprocessArgs, baseDir)
+            if (preprocessed) {
+                cacheKey = await this.getCacheKey(unit, config, compilerConfig, args, preprocessed.source)
+                const hit = await cache.fetch(cacheKey, binaryPath)
+                if (hit) {
+                    await this.saveDependencies(
+                        unit,
+                        config,
+                        baseDir,
+                        commandHash,
+                        compilerConfig.type,
+                        preprocessed.includes
+                    )
+                    return {
+                        success: true,
+                        duration: performance.now() - started,
+                        output: `Using ${hit} compile cache binary (${cacheKey.slice(0, 12)})`,
+                        compiler: compilerName,
+                        skipped: true,
+                        driver,
                     }
                 }
-
-                // Add compiler flags
-                args.push(...compilerFlags)
-                args.push(`/I${file.directory}`) // Include test directory
-                args.push(`/Fe:${binaryPath}`)
-                // Specify unique PDB file in artifact directory to avoid parallel build conflicts
-                const pdbPath = join(file.artifactDir, basename(binaryPath, '.exe') + '.pdb')
-                args.push(`/Fd:${pdbPath}`)
-                // Specify object file output in artifact directory to avoid cluttering test directory
-                const objPath = join(file.artifactDir, basename(file.path, '.c') + '.obj')
-                args.push(`/Fo:${objPath}`)
-                args.push(file.path)
-
-                // Add linker options (everything after /link)
-                const homeDir = os.homedir()
-                args.push('/link')
-                args.push(`/LIBPATH:${homeDir}\\.local\\lib`)
-
-                // Add user's linker flags
-                if (linkerFlags.length > 0) {
-                    args.push(...linkerFlags)
-                }
-
-                // Add library flags
-                if (libraryFlags.length > 0) {
-                    args.push(...libraryFlags)
-                }
-            } else {
-                // GCC/Clang/MinGW syntax: gcc [flags] -I dir -o output input.c [libraries]
-                args.push(...flags)
-                args.push('-I', file.directory)
-                args.push('-o', binaryPath)
-                args.push(file.path)
-                args.push(...libraryFlags)
             }
+        }
 
+        const {result, duration} = await this.measureExecution(async () => {
             // Display compile command if showCommands or showWarnings is enabled
             if (config.execution?.showCommands || config.execution?.showWarnings) {
                 // Show full config only for --show (-s), not for --warning (-w)
                 // showWarnings is only set by -w, showCommands alone is set by -s
                 const showFullConfig = config.execution?.showCommands && !config.execution?.showWarnings
                 if (showFullConfig) {
-                    console.log(`📄 Config used for ${file.name}:`)
-                    console.log(this.formatConfig(config))
+                    Log.info(`📄 Config used for ${file.name}:`)
+                    Log.info(this.formatConfig(config))
                 }
-                console.log(`🔧 Compiler: ${compilerConfig.compiler} (${compilerConfig.type})`)
-                console.log(`📋 Compile command: ${compilerConfig.compiler} ${args.join(' ')}`)
+                Log.info(`🔧 Compiler: ${compilerConfig.compiler} (${compilerConfig.type})`)
+                Log.info(`📋 Compile command: ${compilerConfig.compiler} ${args.join(' ')}`)
 
                 // Show environment variables only for --show (-s), not for --warning (-w)
                 if (showFullConfig) {
-                    const compilerName =
-                        compilerConfig.type === CompilerType.GCC
-                            ? 'gcc'
-                            : compilerConfig.type === CompilerType.Clang
-                              ? 'clang'
-                              : compilerConfig.type === CompilerType.MSVC
-                                ? 'msvc'
-                                : undefined
                     const testEnv = await this.getTestEnvironment(config, file, compilerName)
                     if (Object.keys(testEnv).length > 0) {
-                        console.log(`\n🌍 TestMe environment variables:`)
+                        Log.info(`\n🌍 TestMe environment variables:`)
                         for (const [key, value] of Object.entries(testEnv)) {
-                            console.log(`   ${key}=${value}`)
+                            Log.info(`   ${key}=${value}`)
                         }
                     }
 
                     // Show full environment if verbose mode is enabled
                     if (config.output?.verbose) {
-                        console.log(`\n🌍 Full environment (${Object.keys(process.env).length} variables):`)
+                        Log.info(`\n🌍 Full environment (${Object.keys(process.env).length} variables):`)
                         const sortedKeys = Object.keys(process.env).sort()
                         for (const key of sortedKeys) {
-                            console.log(`   ${key}=${process.env[key]}`)
+                            Log.info(`   ${key}=${process.env[key]}`)
                         }
                     }
                 }
             }
 
-            // Build environment for MSVC if needed
-            let env: Record<string, string> | undefined = undefined
-            if (compilerConfig.type === CompilerType.MSVC && compilerConfig.env) {
-                // Filter out undefined values from process.env
-                env = {}
-                for (const [key, value] of Object.entries(process.env)) {
-                    if (value !== undefined) {
-                        env[key] = value
-                    }
-                }
-                if (compilerConfig.env.PATH) {
-                    env.PATH = `${compilerConfig.env.PATH};${process.env.PATH || ''}`
-                }
-                if (compilerConfig.env.INCLUDE) {
-                    env.INCLUDE = compilerConfig.env.INCLUDE
-                }
-                if (compilerConfig.env.LIB) {
-                    env.LIB = compilerConfig.env.LIB
-                }
-            }
-
             return await this.runCommand(compilerConfig.compiler, args, {
                 cwd: baseDir, // Compile from config directory so relative paths in flags work correctly
                 timeout: 60000, // 1 minute for compilation
-                env,
+                env: this.getCompilerEnvironment(compilerConfig),
                 description: `Compilation of ${file.name}`,
             })
         })
 
         const success = result.exitCode === 0
 
+        // MSVC writes /showIncludes notes to stdout. Collect them as dependencies and strip them from the output.
+        let stdout = result.stdout
+        let includes: string[] | undefined
+        if (compilerConfig.type === CompilerType.MSVC) {
+            ;({stdout, includes} = this.extractShowIncludes(result.stdout))
+        }
+
         // Build compilation output
-        let output = result.stdout || 'Compilation completed'
+        let output = stdout || 'Compilation completed'
 
         // If --warning is enabled, or both --show and --verbose are enabled, include full compilation output
         if ((config.execution?.showWarnings || (config.execution?.showCommands && config.output?.verbose)) && success) {
             const compileOutput: string[] = []
-            if (result.stdout && result.stdout.trim()) {
-                compileOutput.push(`STDOUT:\n${result.stdout}`)
+            if (stdout && stdout.trim()) {
+                compileOutput.push(`STDOUT:\n${stdout}`)
             }
             if (result.stderr && result.stderr.trim()) {
                 compileOutput.push(`STDERR (warnings):\n${result.stderr}`)
@@ -372,7 +364,7 @@ export class CTestHandler extends BaseTestHandler {
             }
         }
 
-        let error = result.exitCode !== 0 ? result.stderr : undefined
+        let error = result.exitCode !== 0 ? result.stderr || stdout : undefined
 
         // Enhance error messages for common compilation failures
         if (error) {
@@ -383,7 +375,7 @@ export class CTestHandler extends BaseTestHandler {
         const logContent = `Compiler: ${config.compiler?.c?.compiler || 'gcc'}
 Exit Code: ${result.exitCode}
 STDOUT:
-${result.stdout}
+${stdout}
 STDERR:
 ${result.stderr}`
 
@@ -393,20 +385,559 @@ ${result.stderr}`
             // Ignore write errors - compilation log is not critical
         }
 
-        // Get compiler name for special variable expansion
-        const compilerConfig = await CompilerManager.getDefaultCompilerConfig(
-            this.resolveCompilerName(config.compiler?.c?.compiler)
+        // Record the dependency set and command hash used to validate the cached binary
+        if (success) {
+            await this.saveDependencies(unit, config, baseDir, commandHash, compilerConfig.type, includes)
+            if (cache && cacheKey) {
+                await cache.store(cacheKey, binaryPath)
+            }
+        }
+
+        return {success, duration, output, error, compiler: compilerName, driver}
+    }
+
+    /*
+     Gets the source to compile for a C test
+     Tests written with TM_TEST() functions have no main(). They are compiled through a generated
+     driver in the artifact directory that includes the test and runs its tests with tUnityMain().
+     @param file C test file
+     @returns The test file, or a copy whose path is the generated driver
+     */
+    protected async getCompileUnit(file: TestFile): Promise<TestFile> {
+        const tests = findUnityTests(await Bun.file(file.path).text())
+        if (tests.length === 0) {
+            return file
+        }
+        const driverPath = this.artifactManager.getArtifactPath(file, basename(file.name, '.tst.c') + '.main.c')
+        await writeIfChanged(driverPath, generateDriver([{path: resolve(file.path), name: file.name, tests}]))
+        return {...file, path: driverPath}
+    }
+
+    /*
+     Builds compiler arguments for a C test
+     Adds the test's source, output and include directory to the resolved flags and libraries, plus
+     dependency tracking flags (-MMD on gcc/clang, /showIncludes on MSVC)
+     @param file C test file to compile
+     @param config Test configuration with compiler settings
+     @param compilerConfig Resolved compiler configuration
+     @param binaryPath Output binary path
+     @param instrumentFlags Sanitizer and coverage flags
+     @returns Compiler arguments, and preprocessor-only arguments used to key the compile cache
+     */
+    private async buildCompileArgs(
+        file: TestFile,
+        config: TestConfig,
+        compilerConfig: CompilerConfig,
+        binaryPath: string,
+        instrumentFlags: string[] = []
+    ): Promise<{args: string[]; preprocessArgs: string[]}> {
+        const resolved = await this.getResolvedFlags(file, config, compilerConfig)
+        const libraryFlags = resolved.libraryFlags
+        // Instrumentation flags follow the configured flags, so they are part of the command hash,
+        // the compile cache key and the precompiled header key
+        const flags = [...resolved.flags, ...instrumentFlags]
+
+        // Build compiler arguments based on compiler type
+        const args: string[] = []
+        const preprocessArgs: string[] = []
+
+        if (compilerConfig.type === CompilerType.MSVC) {
+            // MSVC syntax: cl.exe [compiler flags] /Fe:output.exe input.c /link [linker flags]
+
+            // Separate compiler flags from linker flags
+            const compilerFlags: string[] = []
+            const linkerFlags: string[] = []
+
+            for (const flag of flags) {
+                if (flag.startsWith('/LIBPATH:') || flag.endsWith('.lib') || flag.endsWith('.obj')) {
+                    linkerFlags.push(flag)
+                } else {
+                    compilerFlags.push(flag)
+                }
+            }
+
+            const pch = await this.getPrecompiledHeader(file, config, compilerConfig, compilerFlags)
+
+            // Add compiler flags (/showIncludes lists included headers for dependency tracking)
+            args.push(...compilerFlags)
+            if (pch) {
+                args.push(...pch.args)
+            }
+            args.push('/showIncludes')
+            args.push(`/I${file.directory}`) // Include test directory
+            // Preprocess to stdout without #line directives
+            preprocessArgs.push(...compilerFlags, '/EP', '/showIncludes', `/I${file.directory}`, file.path)
+            args.push(`/Fe:${binaryPath}`)
+            // Specify unique PDB file in artifact directory to avoid parallel build conflicts
+            const pdbPath = join(file.artifactDir, basename(binaryPath, '.exe') + '.pdb')
+            args.push(`/Fd:${pdbPath}`)
+            // Specify object file output in artifact directory to avoid cluttering test directory
+            const objPath = join(file.artifactDir, basename(file.path, '.c') + '.obj')
+            args.push(`/Fo:${objPath}`)
+            args.push(file.path)
+            if (pch) {
+                args.push(...pch.objects)
+            }
+
+            // Add linker options (everything after /link)
+            const homeDir = os.homedir()
+            args.push('/link')
+            args.push(`/LIBPATH:${homeDir}\\.local\\lib`)
+
+            // Add user's linker flags
+            if (linkerFlags.length > 0) {
+                args.push(...linkerFlags)
+            }
+
+            // Add library flags
+            if (libraryFlags.length > 0) {
+                args.push(...libraryFlags)
+            }
+        } else {
+            // GCC/Clang/MinGW syntax: gcc [flags] -I dir -o output input.c [libraries]
+            const compileFlags = flags.filter((flag) => !/^-(L|l|Wl,)/.test(flag))
+            const pch = await this.getPrecompiledHeader(file, config, compilerConfig, compileFlags)
+            // Cached binaries are shared across checkouts, so __FILE__ (used by every assertion) is
+            // made relative to the config directory in both the binary and the preprocessed source
+            const prefixMap = config.compiler?.c?.cache?.enable
+                ? [`-fmacro-prefix-map=${config.configDir || file.directory}=.`]
+                : []
+            args.push(...flags, ...prefixMap)
+            if (pch) {
+                args.push(...pch.args)
+            }
+            // Write a make-style depfile listing the user headers the test includes
+            args.push('-MMD', '-MF', this.getDepfilePath(file, config))
+            args.push('-I', file.directory)
+            args.push('-o', binaryPath)
+            args.push(file.path)
+            args.push(...libraryFlags)
+            // Preprocess to stdout without line markers (-P) so output doesn't depend on the checkout path
+            preprocessArgs.push(...flags, ...prefixMap, '-E', '-P', '-MMD', '-MF', this.getDepfilePath(file, config))
+            preprocessArgs.push('-I', file.directory, file.path)
+        }
+
+        return {args, preprocessArgs}
+    }
+
+    /*
+     Gets the precompiled testme.h for a test (compiler.c.pch)
+     The header is built once per config directory, compiler, flags and testme.h content, and kept in
+     .testme/.pch of the config directory for later runs. Tests that define macros before including
+     testme.h, or that have their own copy of testme.h, are compiled without it.
+     @param file C test file (or generated driver)
+     @param config Test configuration
+     @param compilerConfig Resolved compiler configuration
+     @param flags Compile flags (no linker flags)
+     @returns Arguments and objects for the precompiled header, or undefined to compile without one
+     */
+    private async getPrecompiledHeader(
+        file: TestFile,
+        config: TestConfig,
+        compilerConfig: CompilerConfig,
+        flags: string[]
+    ): Promise<PrecompiledHeader | undefined> {
+        if (!config.compiler?.c?.pch || !getPchName(compilerConfig.type)) {
+            return undefined
+        }
+        try {
+            if (
+                !canPrecompile(await Bun.file(file.path).text()) ||
+                (await Bun.file(join(file.directory, PCH_HEADER)).exists())
+            ) {
+                return undefined
+            }
+        } catch {
+            return undefined
+        }
+        const baseDir = config.configDir || file.directory
+        const key = [baseDir, compilerConfig.type, compilerConfig.compiler, ...flags].join('\0')
+        let header = CTestHandler.precompiled.get(key)
+        if (!header) {
+            header = this.buildPrecompiledHeader(baseDir, compilerConfig, flags)
+            CTestHandler.precompiled.set(key, header)
+        }
+        return await header
+    }
+
+    /*
+     Builds (or reuses from an earlier run) a precompiled testme.h
+     The testme.h the tests would include is found with the compiler's own include search, copied into
+     a directory named by the hash of the compiler, flags and header, and compiled there.
+     @param baseDir Config directory the compiler runs from
+     @param compilerConfig Resolved compiler configuration
+     @param flags Compile flags (no linker flags)
+     @returns Arguments and objects for the precompiled header, or undefined if it could not be built
+     */
+    private async buildPrecompiledHeader(
+        baseDir: string,
+        compilerConfig: CompilerConfig,
+        flags: string[]
+    ): Promise<PrecompiledHeader | undefined> {
+        const msvc = compilerConfig.type === CompilerType.MSVC
+        const env = this.getCompilerEnvironment(compilerConfig)
+        const root = join(baseDir, '.testme', PCH_DIR)
+        try {
+            // Locate testme.h through the include path of the flags
+            const locator = join(root, 'locate.c')
+            await writeIfChanged(locator, PCH_SOURCE)
+            const located = await this.runCommand(
+                compilerConfig.compiler,
+                msvc ? [...flags, '/Zs', '/showIncludes', locator] : [...flags, '-M', locator],
+                {cwd: baseDir, timeout: 60000, env, description: `Locating ${PCH_HEADER}`}
+            )
+            if (located.exitCode !== 0) {
+                return undefined
+            }
+            const includes = msvc
+                ? this.extractShowIncludes(located.stdout).includes
+                : this.parseDepfile(located.stdout)
+            const source = includes
+                .map((path) => resolve(baseDir, path))
+                .find((path) => basename(path) === PCH_HEADER)
+            if (!source) {
+                return undefined
+            }
+            const content = await Bun.file(source).text()
+
+            const hash = createHash('sha256')
+            hash.update([compilerConfig.type, compilerConfig.compiler, ...flags, source, content].join('\0'))
+            const dir = join(root, hash.digest('hex').slice(0, 16))
+            const header = join(dir, PCH_HEADER)
+            const pch = join(dir, getPchName(compilerConfig.type)!)
+            const object = join(dir, 'testme.pch.obj')
+            const result: PrecompiledHeader = msvc
+                ? {args: [`/I${dir}`, `/FI${PCH_HEADER}`, `/Yu${PCH_HEADER}`, `/Fp${pch}`], objects: [object]}
+                : {args: ['-include', header], objects: []}
+
+            if (await Bun.file(pch).exists()) {
+                return result
+            }
+            await writeIfChanged(header, content)
+            let built
+            if (msvc) {
+                const pchSource = join(dir, 'testme.pch.c')
+                await writeIfChanged(pchSource, PCH_SOURCE)
+                built = await this.runCommand(
+                    compilerConfig.compiler,
+                    [...flags, '/c', `/Yc${PCH_HEADER}`, `/Fp${pch}`, `/Fo${object}`, `/I${dir}`, pchSource],
+                    {cwd: baseDir, timeout: 60000, env, description: `Precompiling ${PCH_HEADER}`}
+                )
+            } else {
+                // Write under a temporary name so a concurrent run never reads a partial header
+                const temp = `${pch}.${process.pid}`
+                const args = [...flags, '-x', 'c-header', header, '-o', temp]
+                built = await this.runCommand(compilerConfig.compiler, args, {
+                    cwd: baseDir,
+                    timeout: 60000,
+                    env,
+                    description: `Precompiling ${PCH_HEADER}`,
+                })
+                if (built.exitCode === 0) {
+                    await rename(temp, pch)
+                }
+            }
+            return built.exitCode === 0 ? result : undefined
+        } catch {
+            // Compile without a precompiled header
+            return undefined
+        }
+    }
+
+    /*
+     Gets the resolved flags and libraries for a test, cached for the run
+     Tests sharing a config, compiler and profile share one resolution: the flag arrays are merged and
+     glob-expanded once. The test directory is part of the key only when the settings use ${TESTDIR}.
+     @param file C test file
+     @param config Test configuration with compiler settings
+     @param compilerConfig Resolved compiler configuration
+     @returns Resolved compiler and library flags
+     */
+    private getResolvedFlags(
+        file: TestFile,
+        config: TestConfig,
+        compilerConfig: CompilerConfig
+    ): Promise<ResolvedFlags> {
+        const settings = config.compiler?.c ?? config
+        const cache = CTestHandler.resolvedFlags.get(settings) ?? new Map<string, Promise<ResolvedFlags>>()
+        CTestHandler.resolvedFlags.set(settings, cache)
+        const baseDir = config.configDir || file.directory
+        const testDir = JSON.stringify(config.compiler?.c ?? {}).includes('${TESTDIR}') ? file.directory : ''
+        const key = [compilerConfig.type, compilerConfig.compiler, config.profile ?? '', baseDir, testDir].join('\0')
+        let resolved = cache.get(key)
+        if (!resolved) {
+            resolved = this.resolveFlags(file, config, compilerConfig)
+            cache.set(key, resolved)
+            resolved.catch(() => cache.delete(key))
+        }
+        return resolved
+    }
+
+    /*
+     Resolves compiler flags and libraries from compiler.c settings
+     Merges compiler defaults, generic and compiler/platform-specific flags and libraries, expands
+     ${...} references and converts relative paths to absolute paths
+     @param file C test file (provides ${TESTDIR})
+     @param config Test configuration with compiler settings
+     @param compilerConfig Resolved compiler configuration
+     @returns Resolved compiler and library flags
+     */
+    private async resolveFlags(
+        file: TestFile,
+        config: TestConfig,
+        compilerConfig: CompilerConfig
+    ): Promise<ResolvedFlags> {
+        const baseDir = config.configDir || file.directory
+
+        // Get compiler-specific or default flags and libraries
+        let userFlags: string[] = []
+        let rawLibraries: string[] = []
+
+        // Select flags based on detected compiler type
+        const cConfig = config.compiler?.c
+        if (cConfig) {
+            // Determine current platform
+            const platform = PlatformDetector.isWindows()
+                ? 'windows'
+                : PlatformDetector.isMacOS()
+                  ? 'macosx'
+                  : 'linux'
+
+            // Start with generic flags/libraries (if present)
+            userFlags = [...(cConfig.flags || [])]
+            rawLibraries = [...(cConfig.libraries || [])]
+
+            // Add compiler-specific config on top
+            if (compilerConfig.type === CompilerType.MSVC && cConfig.msvc) {
+                if (cConfig.msvc.flags) userFlags.push(...cConfig.msvc.flags)
+                if (cConfig.msvc.libraries) rawLibraries.push(...cConfig.msvc.libraries)
+                // Check for platform-specific overrides
+                const platformSettings = cConfig.msvc[platform]
+                if (platformSettings) {
+                    if (platformSettings.flags) userFlags.push(...platformSettings.flags)
+                    if (platformSettings.libraries) rawLibraries.push(...platformSettings.libraries)
+                }
+            } else if (compilerConfig.type === CompilerType.GCC && cConfig.gcc) {
+                if (cConfig.gcc.flags) userFlags.push(...cConfig.gcc.flags)
+                if (cConfig.gcc.libraries) rawLibraries.push(...cConfig.gcc.libraries)
+                // Check for platform-specific overrides
+                const platformSettings = cConfig.gcc[platform]
+                if (platformSettings) {
+                    if (platformSettings.flags) userFlags.push(...platformSettings.flags)
+                    if (platformSettings.libraries) rawLibraries.push(...platformSettings.libraries)
+                }
+            } else if (compilerConfig.type === CompilerType.Clang && cConfig.clang) {
+                if (cConfig.clang.flags) userFlags.push(...cConfig.clang.flags)
+                if (cConfig.clang.libraries) rawLibraries.push(...cConfig.clang.libraries)
+                // Check for platform-specific overrides
+                const platformSettings = cConfig.clang[platform]
+                if (platformSettings) {
+                    if (platformSettings.flags) userFlags.push(...platformSettings.flags)
+                    if (platformSettings.libraries) rawLibraries.push(...platformSettings.libraries)
+                }
+            }
+        }
+
+        // Merge compiler defaults with user flags (defaults first, then user overrides)
+        let flags = [...compilerConfig.flags, ...userFlags]
+
+        // Create special variables for expansion
+        const specialVars = GlobExpansion.createSpecialVariables(
+            file.artifactDir,
+            file.directory,
+            config.configDir,
+            compilerConfig.compiler,
+            config.profile
         )
-        const compilerName =
-            compilerConfig.type === CompilerType.GCC
-                ? 'gcc'
-                : compilerConfig.type === CompilerType.Clang
-                  ? 'clang'
-                  : compilerConfig.type === CompilerType.MSVC
-                    ? 'msvc'
-                    : undefined
-
-        return {success, duration, output, error, compiler: compilerName}
+
+        // Expand ${...} references in flags and libraries
+        const expandedFlags = await GlobExpansion.expandArray(flags, baseDir, specialVars)
+        const expandedLibraries = await GlobExpansion.expandArray(rawLibraries, baseDir, specialVars)
+
+        // Normalize rpath values for the current platform
+        const normalizedFlags = CompilerManager.normalizePlatformRpaths(expandedFlags)
+
+        // Convert relative paths to absolute paths since we compile from artifact directory
+        flags = this.resolveRelativePaths(normalizedFlags, baseDir)
+        const libraries = this.resolveRelativePaths(expandedLibraries, baseDir)
+
+        // Process libraries based on compiler type
+        const libraryFlags = CompilerManager.processLibraries(libraries, compilerConfig.type)
+
+        return {flags, libraryFlags}
+    }
+
+    /*
+     Builds the compiler process environment (MSVC needs PATH, INCLUDE and LIB from vcvars)
+     @param compilerConfig Resolved compiler configuration
+     @returns Environment for the compiler, or undefined to inherit the current environment
+     */
+    private getCompilerEnvironment(compilerConfig: CompilerConfig): Record<string, string> | undefined {
+        if (compilerConfig.type !== CompilerType.MSVC || !compilerConfig.env) {
+            return undefined
+        }
+        // Filter out undefined values from process.env
+        const env: Record<string, string> = {}
+        for (const [key, value] of Object.entries(process.env)) {
+            if (value !== undefined) {
+                env[key] = value
+            }
+        }
+        if (compilerConfig.env.PATH) {
+            env.PATH = `${compilerConfig.env.PATH};${process.env.PATH || ''}`
+        }
+        if (compilerConfig.env.INCLUDE) {
+            env.INCLUDE = compilerConfig.env.INCLUDE
+        }
+        if (compilerConfig.env.LIB) {
+            env.LIB = compilerConfig.env.LIB
+        }
+        return env
+    }
+
+    /*
+     Runs the preprocessor for a C test (used to key the compile cache)
+     Also writes the depfile (gcc/clang) or collects /showIncludes notes (MSVC) so a cache hit
+     records the same dependencies as a real compile
+     @param file C test file
+     @param compilerConfig Resolved compiler configuration
+     @param preprocessArgs Preprocessor arguments from buildCompileArgs()
+     @param baseDir Directory to run the preprocessor from
+     @returns Preprocessed source and MSVC includes, or null if preprocessing failed
+     */
+    private async preprocess(
+        file: TestFile,
+        compilerConfig: CompilerConfig,
+        preprocessArgs: string[],
+        baseDir: string
+    ): Promise<{source: string; includes?: string[]} | null> {
+        let result: {exitCode: number; stdout: string; stderr: string}
+        try {
+            result = await this.runCommand(compilerConfig.compiler, preprocessArgs, {
+                cwd: baseDir,
+                timeout: 60000,
+                env: this.getCompilerEnvironment(compilerConfig),
+                description: `Preprocessing of ${file.name}`,
+            })
+        } catch {
+            return null
+        }
+        if (result.exitCode !== 0) {
+            // Let the real compile report the error
+            return null
+        }
+        if (compilerConfig.type === CompilerType.MSVC) {
+            const fromStdout = this.extractShowIncludes(result.stdout)
+            const fromStderr = this.extractShowIncludes(result.stderr)
+            return {source: fromStdout.stdout, includes: [...fromStdout.includes, ...fromStderr.includes]}
+        }
+        return {source: result.stdout}
+    }
+
+    /*
+     Computes the compile cache key for a C test
+     Hashes the compiler identity, platform, compile arguments and preprocessed source (both with
+     checkout-specific directories replaced by placeholders) and any configured extra inputs.
+     Paths anywhere in the repository (e.g. -I../include) are checkout independent. Paths outside
+     it (a sibling checkout, $HOME) are hashed as given.
+     Rpaths are hashed as given: a binary from another checkout would load that checkout's libraries.
+     @param file C test file
+     @param config Test configuration
+     @param compilerConfig Resolved compiler configuration
+     @param args Compiler arguments
+     @param source Preprocessed source
+     @returns Hex digest identifying the binary
+     */
+    private async getCacheKey(
+        file: TestFile,
+        config: TestConfig,
+        compilerConfig: CompilerConfig,
+        args: string[],
+        source: string
+    ): Promise<string> {
+        const baseDir = config.configDir || file.directory
+        // Most specific first: the artifact directory is in the test directory, which is in the repository
+        const placeholders: [string | undefined, string][] = [
+            [file.artifactDir, '${ARTIFACTS}'],
+            [file.directory, '${TESTDIR}'],
+            [baseDir, '${CONFIGDIR}'],
+            [CTestHandler.findRepository(resolve(baseDir)), '${REPOSITORY}'],
+        ]
+        // Directories are only replaced as whole path components (/src/repo is not a prefix of /src/repo-lib)
+        const patterns = placeholders.flatMap(([dir, name]) =>
+            dir ? [{pattern: new RegExp(dir.replace(/[.*+?^${}()|[\]\\]/g, '\\$&') + '(?![\\w.-])', 'g'), name}] : []
+        )
+        const normalize = (text: string) =>
+            patterns.reduce((value, {pattern, name}) => value.replace(pattern, () => name), text)
+        const normalized = args.map((arg) => (arg.includes('-rpath') ? arg : normalize(arg)))
+
+        const hash = createHash('sha256')
+        hash.update(`${await this.getCompilerIdentity(compilerConfig)}\0${process.platform}\0${process.arch}\0`)
+        hash.update(normalized.join('\0'))
+        hash.update('\0')
+        // Paths the compiler could not make relative (e.g. __FILE__ with MSVC)
+        hash.update(normalize(source))
+
+        // Extra inputs (e.g. project libraries linked into the test) are hashed by content
+        const inputs = config.compiler?.c?.cache?.inputs
+        if (inputs && inputs.length > 0) {
+            const paths = [...new Set(await GlobExpansion.expandArray(inputs, baseDir))].sort()
+            for (const path of paths) {
+                try {
+                    hash.update(`\0${relative(baseDir, path)}\0`)
+                    hash.update(new Uint8Array(await Bun.file(resolve(baseDir, path)).arrayBuffer()))
+                } catch {
+                    hash.update('\0missing')
+                }
+            }
+        }
+        return hash.digest('hex')
+    }
+
+    /*
+     Finds the repository containing a directory: the nearest directory with a .git entry
+     @param dir Absolute directory path
+     @returns Repository root, or undefined outside a repository
+     */
+    private static findRepository(dir: string): string | undefined {
+        if (!this.repositories.has(dir)) {
+            let repository: string | undefined
+            for (let current = dir; ; current = dirname(current)) {
+                if (existsSync(join(current, '.git'))) {
+                    repository = current
+                    break
+                }
+                if (dirname(current) === current) {
+                    break
+                }
+            }
+            this.repositories.set(dir, repository)
+        }
+        return this.repositories.get(dir)
+    }
+
+    /*
+     Gets the compiler identity (version banner) used in compile cache keys
+     The banner is cached per compiler for the life of the process
+     @param compilerConfig Resolved compiler configuration
+     @returns Compiler version output
+     */
+    private async getCompilerIdentity(compilerConfig: CompilerConfig): Promise<string> {
+        let identity = CTestHandler.compilerIdentities.get(compilerConfig.compiler)
+        if (!identity) {
+            // cl.exe prints its banner to stderr when run without arguments
+            const args = compilerConfig.type === CompilerType.MSVC ? [] : ['--version']
+            const name = `${compilerConfig.type}\0${compilerConfig.compiler}`
+            identity = this.runCommand(compilerConfig.compiler, args, {
+                timeout: 10000,
+                env: this.getCompilerEnvironment(compilerConfig),
+                description: `Version of ${compilerConfig.compiler}`,
+            })
+                .then((result) => `${name}\0${result.stdout}${result.stderr}`)
+                .catch(() => name)
+            CTestHandler.compilerIdentities.set(compilerConfig.compiler, identity)
+        }
+        return identity
     }
 
     /*
@@ -430,33 +961,262 @@ ${result.stderr}`
 
     /*
      Gets the path where the compiled binary should be stored
+     Instrumented builds are named after their variant (math-asan-ubsan), so they are cached beside
+     the plain binary instead of replacing it
      @param file C test file
+     @param config Test configuration with compiler settings
      @returns Path to compiled binary in artifact directory (with .exe on Windows)
      */
-    private getBinaryPath(file: TestFile): string {
-        const baseName = basename(file.name, '.tst.c')
-        const binaryName = PermissionManager.addBinaryExtension(baseName)
+    protected getBinaryPath(file: TestFile, config: TestConfig): string {
+        const binaryName = PermissionManager.addBinaryExtension(this.getVariantBase(file, config))
         return this.artifactManager.getArtifactPath(file, binaryName)
     }
 
+    /*
+     Gets the instrumentation of a test build (compiler.c.sanitize and compiler.c.coverage)
+     @param config Test configuration with compiler settings
+     @returns Instrumentation, or undefined for a plain build
+     @throws Error for unknown or conflicting sanitizers
+     */
+    protected getInstrumentation(config: TestConfig): Instrumentation | undefined {
+        return CompilerManager.getInstrumentation(config.compiler?.c?.sanitize, config.compiler?.c?.coverage)
+    }
+
+    /*
+     Builds the test environment, adding the sanitizer options and coverage profile path of
+     instrumented builds
+     @param config Test configuration
+     @param file Test file
+     @param compiler Compiler name (TESTME_CC)
+     @returns Environment variables for the test
+     */
+    protected override async getTestEnvironment(
+        config: TestConfig,
+        file?: TestFile,
+        compiler?: string
+    ): Promise<Record<string, string>> {
+        const env = await super.getTestEnvironment(config, file, compiler)
+        let instrumentation: Instrumentation | undefined
+        try {
+            instrumentation = this.getInstrumentation(config)
+        } catch {
+            return env
+        }
+        if (instrumentation) {
+            Object.assign(env, CompilerManager.getSanitizerEnvironment(instrumentation, env))
+            if (instrumentation.coverage && file) {
+                Object.assign(env, Coverage.getEnvironment(this.getBinaryPath(file, config)))
+            }
+        }
+        return env
+    }
+
+    /*
+     Gets the base name of a test's build outputs, including the instrumentation variant
+     @param file C test file
+     @param config Test configuration with compiler settings
+     @returns Test name, with -<variant> for instrumented builds
+     */
+    private getVariantBase(file: TestFile, config: TestConfig): string {
+        return basename(file.name, '.tst.c') + this.getVariantSuffix(config)
+    }
+
+    /*
+     Gets the suffix naming a test's instrumented build outputs
+     Invalid instrumentation is reported by compile(), so here it names a plain build.
+     @param config Test configuration with compiler settings
+     @returns -<variant> for instrumented builds, or an empty string
+     */
+    private getVariantSuffix(config: TestConfig): string {
+        try {
+            const instrumentation = this.getInstrumentation(config)
+            return instrumentation ? `-${CompilerManager.getVariantName(instrumentation)}` : ''
+        } catch {
+            return ''
+        }
+    }
+
+    /*
+     Gets the compiler name passed to the test environment (TESTME_CC)
+     @param type Detected compiler type
+     @returns Compiler name or undefined for unknown compilers
+     */
+    private getCompilerName(type: CompilerType): string | undefined {
+        return type === CompilerType.GCC
+            ? 'gcc'
+            : type === CompilerType.Clang
+              ? 'clang'
+              : type === CompilerType.MSVC
+                ? 'msvc'
+                : undefined
+    }
+
+    /*
+     Gets the path of the make-style depfile written by gcc/clang (-MMD -MF)
+     @param file C test file
+     @param config Test configuration with compiler settings
+     @returns Path to the depfile in the artifact directory
+     */
+    private getDepfilePath(file: TestFile, config: TestConfig): string {
+        return this.artifactManager.getArtifactPath(file, this.getVariantBase(file, config) + '.d')
+    }
+
+    /*
+     Gets the name of the dependency record artifact of a test build
+     @param config Test configuration with compiler settings
+     @returns compile.deps, or compile-<variant>.deps for instrumented builds
+     */
+    private getDepsArtifact(config: TestConfig): string {
+        return CTestHandler.getDepsRecordName(this.getVariantSuffix(config))
+    }
+
+    /*
+     Gets the name of the dependency record artifact of a build variant
+     @param suffix Variant suffix (-<variant> for instrumented builds, empty for a plain build)
+     @returns compile.deps or compile-<variant>.deps
+     */
+    static getDepsRecordName(suffix: string): string {
+        return suffix ? DEPS_ARTIFACT.replace('.deps', `${suffix}.deps`) : DEPS_ARTIFACT
+    }
+
+    /*
+     Tests if an artifact is the dependency record of any build variant
+     @param name Artifact file name
+     @returns true for compile.deps and compile-<variant>.deps
+     */
+    static isDepsRecord(name: string): boolean {
+        return DEPS_PATTERN.test(name)
+    }
+
+    /*
+     Hashes the compile command so changes to the compiler, flags or libraries invalidate the cached binary
+     @param compilerConfig Resolved compiler configuration
+     @param args Compiler arguments
+     @returns Hex digest of the compile command
+     */
+    private hashCompileCommand(compilerConfig: CompilerConfig, args: string[]): string {
+        const hash = createHash('sha256')
+        hash.update(`${compilerConfig.type}\0${compilerConfig.compiler}\0`)
+        hash.update(args.join('\0'))
+        if (compilerConfig.env) {
+            hash.update(`\0${compilerConfig.env.INCLUDE || ''}\0${compilerConfig.env.LIB || ''}`)
+        }
+        return hash.digest('hex')
+    }
+
     /*
      Checks if the C source file needs to be recompiled
-     Compares modification times of source file and compiled binary
-     @param sourceFile Path to the C source file
+     Uses the dependency record saved by the last successful compile. Rebuilds if there is no record,
+     the compile command hash differs, or the source or any included header is missing or newer than the binary.
+     @param file C test file
+     @param config Test configuration with compiler settings
      @param binaryPath Path to the compiled binary
+     @param commandHash Hash of the current compile command
      @returns Promise resolving to true if recompilation is needed
      */
-    private async needsRecompilation(sourceFile: string, binaryPath: string): Promise<boolean> {
+    private async needsRecompilation(
+        file: TestFile,
+        config: TestConfig,
+        binaryPath: string,
+        commandHash: string
+    ): Promise<boolean> {
         try {
-            const [sourceStat, binaryStat] = await Promise.all([stat(sourceFile), stat(binaryPath)])
-            // Rebuild if source is newer than binary
-            return sourceStat.mtimeMs > binaryStat.mtimeMs
+            const deps = await this.artifactManager.readArtifact(file, this.getDepsArtifact(config))
+            const record = JSON.parse(deps) as {
+                hash?: string
+                dependencies?: string[]
+            }
+            if (record.hash !== commandHash || !Array.isArray(record.dependencies)) {
+                return true
+            }
+            const binaryStat = await stat(binaryPath)
+            const sources = [file.path, ...record.dependencies]
+            const stats = await Promise.all(sources.map((path) => stat(path)))
+            // Rebuild if the source or any header is newer than the binary
+            return stats.some((sourceStat) => sourceStat.mtimeMs > binaryStat.mtimeMs)
         } catch {
-            // Binary doesn't exist or other error, needs compilation
+            // Binary, record or a dependency doesn't exist, needs compilation
             return true
         }
     }
 
+    /*
+     Saves the dependency record used to validate the cached binary on the next run
+     @param file C test file
+     @param config Test configuration with compiler settings
+     @param baseDir Directory the compiler was run from (relative depfile paths resolve against it)
+     @param commandHash Hash of the compile command
+     @param type Compiler type
+     @param includes Headers reported by MSVC /showIncludes
+     */
+    private async saveDependencies(
+        file: TestFile,
+        config: TestConfig,
+        baseDir: string,
+        commandHash: string,
+        type: CompilerType,
+        includes?: string[]
+    ): Promise<void> {
+        try {
+            let dependencies: string[]
+            if (type === CompilerType.MSVC) {
+                dependencies = includes || []
+            } else {
+                dependencies = this.parseDepfile(await Bun.file(this.getDepfilePath(file, config)).text())
+            }
+            const sourcePath = resolve(file.path)
+            const unique = [...new Set(dependencies.map((dep) => resolve(baseDir, dep)))].filter(
+                (dep) => dep !== sourcePath
+            )
+            const record = {hash: commandHash, dependencies: unique}
+            const deps = JSON.stringify(record, null, 2)
+            await this.artifactManager.writeArtifact(file, this.getDepsArtifact(config), deps)
+        } catch {
+            // Missing depfile or write error - the next run will simply recompile
+        }
+    }
+
+    /*
+     Parses a make-style depfile ("target: dep1 dep2 \\\n dep3")
+     @param content Depfile content
+     @returns Dependency paths (target excluded)
+     */
+    private parseDepfile(content: string): string[] {
+        const dependencies: string[] = []
+        // Join continuation lines, then take everything after the first "target:" separator
+        const text = content.replace(/\\\r?\n/g, ' ')
+        for (const line of text.split(/\r?\n/)) {
+            const colon = line.search(/:(\s|$)/)
+            if (colon < 0) {
+                continue
+            }
+            // Split on unescaped whitespace ("\ " is an escaped space, "\#" a hash, "$$" a dollar)
+            for (const token of line.slice(colon + 1).match(/(?:\\ |\S)+/g) || []) {
+                dependencies.push(token.replace(/\\([ #])/g, '$1').replace(/\$\$/g, '$'))
+            }
+        }
+        return dependencies
+    }
+
+    /*
+     Extracts MSVC /showIncludes notes from compiler stdout
+     @param stdout Compiler stdout
+     @returns Stdout without the include notes, and the included header paths
+     */
+    private extractShowIncludes(stdout: string): {stdout: string; includes: string[]} {
+        const includes: string[] = []
+        const lines: string[] = []
+        for (const line of stdout.split(/\r?\n/)) {
+            const match = line.match(/^Note: including file:\s*(.+?)\s*$/)
+            if (match) {
+                includes.push(match[1])
+            } else {
+                lines.push(line)
+            }
+        }
+        return {stdout: lines.join('\n'), includes}
+    }
+
     /*
      Combines compilation and execution outputs into single formatted string
      @param compileOutput Output from compilation step
@@ -464,7 +1224,7 @@ ${result.stderr}`
      @param stderr Standard error from execution
      @returns Formatted combined output
      */
-    private combineOutputs(compileOutput: string, stdout: string, stderr: string): string {
+    protected combineOutputs(compileOutput: string, stdout: string, stderr: string): string {
         let output = ''
 
         if (compileOutput.trim()) {
@@ -649,7 +1409,7 @@ ${result.stderr}`
             const configFileName = `${testBaseName}.yml`
             const projectName = `${testBaseName}.xcodeproj`
 
-            console.log('🛠️  Generating Xcode project...')
+            Log.info('🛠️  Generating Xcode project...')
 
             // Run xcodegen to create the project
             const xcodegen = await this.runCommand('xcodegen', ['--spec', configFileName], {
@@ -662,18 +1422,18 @@ ${result.stderr}`
                 throw new Error(`xcodegen failed: ${xcodegen.stderr}`)
             }
 
-            console.log('🗑️  Removing pre-compiled executable...')
+            Log.info('🗑️  Removing pre-compiled executable...')
 
             // Remove the pre-compiled executable so Xcode compiles fresh
-            const binaryPath = this.getBinaryPath(file)
+            const binaryPath = this.getBinaryPath(file, config)
             try {
                 await Bun.$`rm -f ${binaryPath}`
-                console.log(`   Removed: ${binaryPath}`)
+                Log.info(`   Removed: ${binaryPath}`)
             } catch (error) {
                 console.warn(`   Warning: Could not remove ${binaryPath}: ${error}`)
             }
 
-            console.log('🚀 Opening Xcode project...')
+            Log.info('🚀 Opening Xcode project...')
 
             // Open the Xcode project
             const open = await this.runCommand('open', [projectName], {
@@ -715,19 +1475,19 @@ To debug:
         compileDuration: number,
         compiler?: string
     ): Promise<TestResult> {
-        const binaryPath = this.getBinaryPath(file)
+        const binaryPath = this.getBinaryPath(file, config)
 
         try {
-            console.log('🐛 Launching LLDB debugger...')
-            console.log(`Binary: ${binaryPath}`)
-            console.log('LLDB commands you can use:')
-            console.log('  (lldb) run       - Start the program')
-            console.log('  (lldb) b main    - Set breakpoint at main')
-            console.log('  (lldb) step      - Step through code')
-            console.log('  (lldb) continue  - Continue execution')
-            console.log('  (lldb) p var     - Print variable value')
-            console.log('  (lldb) quit      - Exit debugger')
-            console.log('')
+            Log.info('🐛 Launching LLDB debugger...')
+            Log.info(`Binary: ${binaryPath}`)
+            Log.info('LLDB commands you can use:')
+            Log.info('  (lldb) run       - Start the program')
+            Log.info('  (lldb) b main    - Set breakpoint at main')
+            Log.info('  (lldb) step      - Step through code')
+            Log.info('  (lldb) continue  - Continue execution')
+            Log.info('  (lldb) p var     - Print variable value')
+            Log.info('  (lldb) quit      - Exit debugger')
+            Log.info('')
 
             // Launch LLDB in interactive mode with stdin/stdout/stderr inheritance
             const testEnv = await this.getTestEnvironment(config, file, compiler)
@@ -778,19 +1538,19 @@ To debug:
         compileDuration: number,
         compiler?: string
     ): Promise<TestResult> {
-        const binaryPath = this.getBinaryPath(file)
+        const binaryPath = this.getBinaryPath(file, config)
 
         try {
-            console.log('🐛 Launching GDB debugger...')
-            console.log(`Binary: ${binaryPath}`)
-            console.log('GDB commands you can use:')
-            console.log('  (gdb) run       - Start the program')
-            console.log('  (gdb) break main - Set breakpoint at main')
-            console.log('  (gdb) step      - Step through code')
-            console.log('  (gdb) continue  - Continue execution')
-            console.log('  (gdb) print var - Print variable value')
-            console.log('  (gdb) quit      - Exit debugger')
-            console.log('')
+            Log.info('🐛 Launching GDB debugger...')
+            Log.info(`Binary: ${binaryPath}`)
+            Log.info('GDB commands you can use:')
+            Log.info('  (gdb) run       - Start the program')
+            Log.info('  (gdb) break main - Set breakpoint at main')
+            Log.info('  (gdb) step      - Step through code')
+            Log.info('  (gdb) continue  - Continue execution')
+            Log.info('  (gdb) print var - Print variable value')
+            Log.info('  (gdb) quit      - Exit debugger')
+            Log.info('')
 
             // Launch GDB in interactive mode with stdin/stdout/stderr inheritance
             const testEnv = await this.getTestEnvironment(config, file, compiler)
@@ -840,13 +1600,13 @@ To debug:
         config: TestConfig,
         compileDuration: number
     ): Promise<TestResult> {
-        const binaryPath = this.getBinaryPath(file)
+        const binaryPath = this.getBinaryPath(file, config)
 
         try {
-            console.log('🛠️  Preparing Visual Studio debugger...')
-            console.log(`📁 Binary: ${binaryPath}`)
-            console.log(`📄 Source: ${file.path}`)
-            console.log(`📂 Working Directory: ${file.directory}`)
+            Log.info('🛠️  Preparing Visual Studio debugger...')
+            Log.info(`📁 Binary: ${binaryPath}`)
+            Log.info(`📄 Source: ${file.path}`)
+            Log.info(`📂 Working Directory: ${file.directory}`)
 
             // Get compiler config to find devenv path from MSVC installation
             const compilerConfig = await CompilerManager.getDefaultCompilerConfig(
@@ -860,7 +1620,7 @@ To debug:
                 const derivedDevenv = this.findDevenvFromCompiler(compilerConfig.compiler)
                 if (derivedDevenv) {
                     devenvPath = derivedDevenv
-                    console.log(`🔍 Found Visual Studio at: ${devenvPath}`)
+                    Log.info(`🔍 Found Visual Studio at: ${devenvPath}`)
                 }
             }
 
@@ -871,7 +1631,7 @@ To debug:
             // Try to launch Visual Studio with debugger
             let vsOpened = false
             try {
-                console.log('🚀 Launching Visual Studio...')
+                Log.info('🚀 Launching Visual Studio...')
 
                 // Build environment for Visual Studio
                 // We only pass the PATH from testEnv, not the full environment
@@ -907,11 +1667,11 @@ To debug:
                 await new Promise((resolve) => setTimeout(resolve, 1500))
 
                 vsOpened = true
-                console.log('✅ Visual Studio launched')
+                Log.info('✅ Visual Studio launched')
             } catch (error) {
                 // Visual Studio devenv command not available
-                console.log('📋 Could not launch Visual Studio automatically')
-                console.log(`   Manually open Visual Studio and debug: ${binaryPath}`)
+                Log.info('📋 Could not launch Visual Studio automatically')
+                Log.info(`   Manually open Visual Studio and debug: ${binaryPath}`)
             }
 
             const output = `Visual Studio debug setup completed.
@@ -970,20 +1730,20 @@ ${vsOpened ? '3' : '4'}. Start debugging (F5)`
         compileDuration: number,
         compiler?: string
     ): Promise<TestResult> {
-        const binaryPath = this.getBinaryPath(file)
+        const binaryPath = this.getBinaryPath(file, config)
 
         try {
             // Create VS Code launch configuration
             const vscodeConfigCreated = await this.createVSCodeDebugConfig(file, config, compiler)
 
             if (vscodeConfigCreated) {
-                console.log('🛠️  VS Code debug configuration created')
-                console.log(`📁 Project location: ${file.artifactDir}`)
+                Log.info('🛠️  VS Code debug configuration created')
+                Log.info(`📁 Project location: ${file.artifactDir}`)
 
                 // Try to launch VS Code (optional - don't fail if not available)
                 let vscodeOpened = false
                 try {
-                    console.log('🚀 Opening VS Code...')
+                    Log.info('🚀 Opening VS Code...')
                     // Open the artifact directory and the test source file
                     const vscode = await this.runCommand('code', [file.artifactDir, file.path], {
                         cwd: file.directory,
@@ -992,12 +1752,12 @@ ${vsOpened ? '3' : '4'}. Start debugging (F5)`
 
                     if (vscode.exitCode === 0) {
                         vscodeOpened = true
-                        console.log('✅ VS Code opened successfully')
+                        Log.info('✅ VS Code opened successfully')
                     }
                 } catch (error) {
                     // VS Code CLI not available - provide manual instructions
-                    console.log("📋 VS Code 'code' command not found in PATH")
-                    console.log(`   Manually open this folder in VS Code: ${file.artifactDir}`)
+                    Log.info("📋 VS Code 'code' command not found in PATH")
+                    Log.info(`   Manually open this folder in VS Code: ${file.artifactDir}`)
                 }
 
                 const output = `VS Code debug configuration created successfully.
@@ -1043,7 +1803,7 @@ ${
             // Create .vscode directory if it doesn't exist
             await Bun.$`mkdir -p ${vscodeDir}`.quiet()
 
-            const binaryPath = this.getBinaryPath(file)
+            const binaryPath = this.getBinaryPath(file, config)
 
             // Use cppdbg debugger type for Windows (works with both GDB and MSVC)
             const debuggerType = 'cppdbg'
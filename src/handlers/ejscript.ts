@@ -38,6 +38,7 @@ export class EjscriptTestHandler extends BaseTestHandler {
                 env: testEnv,
                 config,
                 description: `Test ${file.name}`,
+                logDir: file.artifactDir,
             })
         })
 
@@ -45,7 +46,7 @@ export class EjscriptTestHandler extends BaseTestHandler {
         const output = this.combineOutput(result.stdout, result.stderr)
         const error = result.exitCode !== 0 ? result.stderr : undefined
 
-        return this.createTestResult(file, status, duration, output, error, result.exitCode)
+        return this.createTestResult(file, status, duration, output, error, result.exitCode, result.resources)
     }
 
     /*
@@ -1,6 +1,7 @@
 import type {TestFile, TestResult, TestConfig} from '../types.ts'
 import {TestStatus, TestType} from '../types.ts'
 import {BaseTestHandler} from './base.ts'
+import {Log} from '../utils/log.ts'
 
 /**
  * Handler for executing Go tests (.tst.go files)
@@ -47,6 +48,7 @@ export class GoTestHandler extends BaseTestHandler {
                 timeout: (config.execution?.timeout || 30) * 1000,
                 env: testEnv,
                 config,
+                logDir: file.artifactDir,
             })
         })
 
@@ -54,7 +56,7 @@ export class GoTestHandler extends BaseTestHandler {
         const output = this.combineOutput(result.stdout, result.stderr)
         const error = result.exitCode !== 0 ? result.stderr : undefined
 
-        return this.createTestResult(file, status, duration, output, error, result.exitCode)
+        return this.createTestResult(file, status, duration, output, error, result.exitCode, result.resources)
     }
 
     /**
@@ -68,8 +70,8 @@ export class GoTestHandler extends BaseTestHandler {
         try {
             const debuggerName = config.debug?.go || this.getDefaultDebugger()
 
-            console.log(`\n🐛 Launching ${debuggerName} debugger for: ${file.path}`)
-            console.log(`Working directory: ${file.directory}\n`)
+            Log.info(`\n🐛 Launching ${debuggerName} debugger for: ${file.path}`)
+            Log.info(`Working directory: ${file.directory}\n`)
 
             switch (debuggerName) {
                 case 'vscode':
@@ -104,15 +106,15 @@ export class GoTestHandler extends BaseTestHandler {
     private async launchVSCodeDebugger(file: TestFile, config: TestConfig): Promise<TestResult> {
         const startTime = performance.now()
 
-        console.log('VSCode Go debugging:')
-        console.log(`File: ${file.path}`)
-        console.log('\nInstructions:')
-        console.log('1. Open VSCode')
-        console.log('2. Install Go extension if not already installed')
-        console.log('3. Set breakpoints in your test file')
-        console.log('4. Run > Start Debugging (F5)')
-        console.log('5. Select "Go: Debug File" configuration\n')
-        console.log('Alternatively, use delve debugger: tm --debug with delve configured\n')
+        Log.info('VSCode Go debugging:')
+        Log.info(`File: ${file.path}`)
+        Log.info('\nInstructions:')
+        Log.info('1. Open VSCode')
+        Log.info('2. Install Go extension if not already installed')
+        Log.info('3. Set breakpoints in your test file')
+        Log.info('4. Run > Start Debugging (F5)')
+        Log.info('5. Select "Go: Debug File" configuration\n')
+        Log.info('Alternatively, use delve debugger: tm --debug with delve configured\n')
 
         const result = await this.runCommand('go', ['run', file.path], {
             cwd: file.directory,
@@ -137,16 +139,16 @@ export class GoTestHandler extends BaseTestHandler {
     private async launchDelveDebugger(file: TestFile, config: TestConfig): Promise<TestResult> {
         const startTime = performance.now()
 
-        console.log('Starting Delve debugger (dlv)...')
-        console.log(`File: ${file.path}`)
-        console.log('\nDebugger commands:')
-        console.log('  help - show help')
-        console.log('  break <line> - set breakpoint')
-        console.log('  continue - continue execution')
-        console.log('  next - step over')
-        console.log('  step - step into')
-        console.log('  print <var> - print variable')
-        console.log('  exit - exit debugger\n')
+        Log.info('Starting Delve debugger (dlv)...')
+        Log.info(`File: ${file.path}`)
+        Log.info('\nDebugger commands:')
+        Log.info('  help - show help')
+        Log.info('  break <line> - set breakpoint')
+        Log.info('  continue - continue execution')
+        Log.info('  next - step over')
+        Log.info('  step - step into')
+        Log.info('  print <var> - print variable')
+        Log.info('  exit - exit debugger\n')
 
         const result = await this.runCommand('dlv', ['debug', file.path], {
             cwd: file.directory,
@@ -172,7 +174,7 @@ export class GoTestHandler extends BaseTestHandler {
     private async launchCustomDebugger(file: TestFile, config: TestConfig, debuggerPath: string): Promise<TestResult> {
         const startTime = performance.now()
 
-        console.log(`Launching custom debugger: ${debuggerPath}`)
+        Log.info(`Launching custom debugger: ${debuggerPath}`)
         const result = await this.runCommand(debuggerPath, [file.path], {
             cwd: file.directory,
             env: await this.getTestEnvironment(config, file),
@@ -6,6 +6,7 @@ import {TypeScriptTestHandler} from './typescript.ts'
 import {EjscriptTestHandler} from './ejscript.ts'
 import {PythonTestHandler} from './python.ts'
 import {GoTestHandler} from './go.ts'
+import {UnityTestHandler} from './unity.ts'
 
 /*
  Creates and returns all available test handlers
@@ -32,4 +33,5 @@ export {
     EjscriptTestHandler,
     PythonTestHandler,
     GoTestHandler,
+    UnityTestHandler,
 }
@@ -1,6 +1,7 @@
 import type {TestFile, TestResult, TestConfig} from '../types.ts'
 import {TestStatus, TestType} from '../types.ts'
 import {BaseTestHandler} from './base.ts'
+import {Log} from '../utils/log.ts'
 
 /**
  * Handler for executing Python tests (.tst.py files)
@@ -49,6 +50,7 @@ export class PythonTestHandler extends BaseTestHandler {
                 timeout: (config.execution?.timeout || 30) * 1000,
                 env: testEnv,
                 config,
+                logDir: file.artifactDir,
             })
         })
 
@@ -56,7 +58,7 @@ export class PythonTestHandler extends BaseTestHandler {
         const output = this.combineOutput(result.stdout, result.stderr)
         const error = result.exitCode !== 0 ? result.stderr : undefined
 
-        return this.createTestResult(file, status, duration, output, error, result.exitCode)
+        return this.createTestResult(file, status, duration, output, error, result.exitCode, result.resources)
     }
 
     /**
@@ -70,8 +72,8 @@ export class PythonTestHandler extends BaseTestHandler {
         try {
             const debuggerName = config.debug?.py || this.getDefaultDebugger()
 
-            console.log(`\n🐛 Launching ${debuggerName} debugger for: ${file.path}`)
-            console.log(`Working directory: ${file.directory}\n`)
+            Log.info(`\n🐛 Launching ${debuggerName} debugger for: ${file.path}`)
+            Log.info(`Working directory: ${file.directory}\n`)
 
             switch (debuggerName) {
                 case 'vscode':
@@ -106,15 +108,15 @@ export class PythonTestHandler extends BaseTestHandler {
     private async launchVSCodeDebugger(file: TestFile, config: TestConfig): Promise<TestResult> {
         const startTime = performance.now()
 
-        console.log('VSCode Python debugging:')
-        console.log(`File: ${file.path}`)
-        console.log('\nInstructions:')
-        console.log('1. Open VSCode')
-        console.log('2. Install Python extension if not already installed')
-        console.log('3. Set breakpoints in your test file')
-        console.log('4. Run > Start Debugging (F5)')
-        console.log('5. Select "Python File" configuration\n')
-        console.log('Alternatively, use pdb debugger: tm --debug with pdb configured\n')
+        Log.info('VSCode Python debugging:')
+        Log.info(`File: ${file.path}`)
+        Log.info('\nInstructions:')
+        Log.info('1. Open VSCode')
+        Log.info('2. Install Python extension if not already installed')
+        Log.info('3. Set breakpoints in your test file')
+        Log.info('4. Run > Start Debugging (F5)')
+        Log.info('5. Select "Python File" configuration\n')
+        Log.info('Alternatively, use pdb debugger: tm --debug with pdb configured\n')
 
         const pythonCommand = await this.getPythonCommand()
         const result = await this.runCommand(pythonCommand, [file.path], {
@@ -140,16 +142,16 @@ export class PythonTestHandler extends BaseTestHandler {
     private async launchPdbDebugger(file: TestFile, config: TestConfig): Promise<TestResult> {
         const startTime = performance.now()
 
-        console.log('Starting Python debugger (pdb)...')
-        console.log(`File: ${file.path}`)
-        console.log('\nDebugger commands:')
-        console.log('  h - help')
-        console.log('  b <line> - set breakpoint')
-        console.log('  c - continue')
-        console.log('  n - next line')
-        console.log('  s - step into')
-        console.log('  p <var> - print variable')
-        console.log('  q - quit\n')
+        Log.info('Starting Python debugger (pdb)...')
+        Log.info(`File: ${file.path}`)
+        Log.info('\nDebugger commands:')
+        Log.info('  h - help')
+        Log.info('  b <line> - set breakpoint')
+        Log.info('  c - continue')
+        Log.info('  n - next line')
+        Log.info('  s - step into')
+        Log.info('  p <var> - print variable')
+        Log.info('  q - quit\n')
 
         const pythonCommand = await this.getPythonCommand()
         const result = await this.runCommand(pythonCommand, ['-m', 'pdb', file.path], {
@@ -176,7 +178,7 @@ export class PythonTestHandler extends BaseTestHandler {
     private async launchCustomDebugger(file: TestFile, config: TestConfig, debuggerPath: string): Promise<TestResult> {
         const startTime = performance.now()
 
-        console.log(`Launching custom debugger: ${debuggerPath}`)
+        Log.info(`Launching custom debugger: ${debuggerPath}`)
         const result = await this.runCommand(debuggerPath, [file.path], {
             cwd: file.directory,
             env: await this.getTestEnvironment(config, file),
@@ -57,6 +57,7 @@ export class ShellTestHandler extends BaseTestHandler {
                 env: testEnv,
                 config,
                 description: `Test ${file.name}`,
+                logDir: file.artifactDir,
             })
         })
 
@@ -64,6 +65,6 @@ export class ShellTestHandler extends BaseTestHandler {
         const output = this.combineOutput(result.stdout, result.stderr)
         const error = result.exitCode !== 0 ? result.stderr : undefined
 
-        return this.createTestResult(file, status, duration, output, error, result.exitCode)
+        return this.createTestResult(file, status, duration, output, error, result.exitCode, result.resources)
     }
 }
@@ -2,6 +2,9 @@ import type {TestFile, TestResult, TestConfig} from '../types.ts'
 import {TestStatus, TestType} from '../types.ts'
 import {BaseTestHandler} from './base.ts'
 import {PlatformDetector} from '../platform/detector.ts'
+import {JsWorkerPool} from '../utils/js-pool.ts'
+import {RESULT_FILE} from '../utils/result-channel.ts'
+import {Log} from '../utils/log.ts'
 import * as path from 'path'
 import * as fs from 'fs'
 import * as os from 'os'
@@ -11,6 +14,9 @@ import * as os from 'os'
  Uses Bun runtime to execute TypeScript test files directly (with transpilation)
  */
 export class TypeScriptTestHandler extends BaseTestHandler {
+    // Directories where the testme module link has already been verified
+    private static linkedDirs = new Set<string>()
+
     /*
      Checks if this handler can process the given test file
      @param file Test file to check
@@ -42,14 +48,23 @@ export class TypeScriptTestHandler extends BaseTestHandler {
         // Display environment info if showCommands is enabled
         await this.displayEnvironmentInfo(config, file, testEnv)
 
+        // In-process mode runs the test on a warm worker thread and receives structured results
+        const inProcess = await JsWorkerPool.accepts(file, config)
+        const timeout = (config.execution?.timeout || 30) * 1000
+
         const {result, duration} = await this.measureExecution(async () => {
+            if (inProcess) {
+                return await JsWorkerPool.run(file, {env: testEnv, timeout, config})
+            }
             // Bun can execute TypeScript files directly
             return await this.runCommand('bun', [file.path], {
                 cwd: file.directory,
-                timeout: (config.execution?.timeout || 30) * 1000,
+                timeout,
                 env: testEnv,
                 config,
                 description: `Test ${file.name}`,
+                logDir: file.artifactDir,
+                resultFile: path.join(file.artifactDir, RESULT_FILE),
             })
         })
 
@@ -57,7 +72,14 @@ export class TypeScriptTestHandler extends BaseTestHandler {
         const output = this.combineOutput(result.stdout, result.stderr)
         const error = result.exitCode !== 0 ? result.stderr : undefined
 
-        return this.createTestResult(file, status, duration, output, error, result.exitCode)
+        // In-process runs share the runner's process, so resource usage is only measured for spawned tests
+        const resources = 'resources' in result ? result.resources : undefined
+        const testResult = this.createTestResult(file, status, duration, output, error, result.exitCode, resources)
+        if (result.assertions) {
+            // Structured results (worker messages or the result file) replace counting ✓/✗ in the output
+            this.applyAssertionCounts(testResult, result.assertions)
+        }
+        return testResult
     }
 
     /*
@@ -73,6 +95,10 @@ export class TypeScriptTestHandler extends BaseTestHandler {
         if (!linkDir) {
             return // No suitable directory found
         }
+        if (TypeScriptTestHandler.linkedDirs.has(linkDir)) {
+            return // Already verified during this run
+        }
+        TypeScriptTestHandler.linkedDirs.add(linkDir)
 
         const testmeModulePath = path.join(linkDir, 'node_modules', 'testme')
 
@@ -143,8 +169,8 @@ export class TypeScriptTestHandler extends BaseTestHandler {
         try {
             const debuggerName = config.debug?.ts || this.getDefaultDebugger()
 
-            console.log(`\n🐛 Launching ${debuggerName} debugger for: ${file.path}`)
-            console.log(`Working directory: ${file.directory}\n`)
+            Log.info(`\n🐛 Launching ${debuggerName} debugger for: ${file.path}`)
+            Log.info(`Working directory: ${file.directory}\n`)
 
             switch (debuggerName) {
                 case 'vscode':
@@ -182,20 +208,20 @@ export class TypeScriptTestHandler extends BaseTestHandler {
         const startTime = performance.now()
         const editorName = editorCommand === 'cursor' ? 'Cursor' : 'VSCode'
 
-        console.log(`Starting test with Bun debugger in ${editorName}...`)
-        console.log(`File: ${file.path}\n`)
+        Log.info(`Starting test with Bun debugger in ${editorName}...`)
+        Log.info(`File: ${file.path}\n`)
 
         // Create .vscode directory and launch.json
         await this.createVSCodeConfig(file)
 
-        console.log(`Opening ${editorName} workspace...`)
-        console.log('\nPrerequisites:')
-        console.log('- Install Bun extension: https://marketplace.visualstudio.com/items?itemName=oven.bun-vscode')
-        console.log('\nInstructions:')
-        console.log(`1. ${editorName} will open with your test directory`)
-        console.log('2. Open the test file and set breakpoints')
-        console.log('3. Press F5 or Run > Start Debugging')
-        console.log('4. Select "Debug Bun Test" configuration\n')
+        Log.info(`Opening ${editorName} workspace...`)
+        Log.info('\nPrerequisites:')
+        Log.info('- Install Bun extension: https://marketplace.visualstudio.com/items?itemName=oven.bun-vscode')
+        Log.info('\nInstructions:')
+        Log.info(`1. ${editorName} will open with your test directory`)
+        Log.info('2. Open the test file and set breakpoints')
+        Log.info('3. Press F5 or Run > Start Debugging')
+        Log.info('4. Select "Debug Bun Test" configuration\n')
 
         // Find the editor executable
         const debuggers = await PlatformDetector.detectDebuggers()
@@ -212,8 +238,8 @@ export class TypeScriptTestHandler extends BaseTestHandler {
         })
 
         // Wait for user to set up debugging in VSCode
-        console.log('\nWaiting for you to start debugging in VSCode...')
-        console.log('The test will run when you start the debugger (F5)\n')
+        Log.info('\nWaiting for you to start debugging in VSCode...')
+        Log.info('The test will run when you start the debugger (F5)\n')
 
         // Run test normally - user will attach debugger
         const result = await this.runCommand('bun', [file.path], {
@@ -260,9 +286,9 @@ export class TypeScriptTestHandler extends BaseTestHandler {
 
         // Write or update launch.json
         if (fs.existsSync(launchJsonPath)) {
-            console.log('Updating existing .vscode/launch.json...')
+            Log.info('Updating existing .vscode/launch.json...')
         } else {
-            console.log('Creating .vscode/launch.json...')
+            Log.info('Creating .vscode/launch.json...')
         }
 
         fs.writeFileSync(launchJsonPath, JSON.stringify(launchConfig, null, 4))
@@ -278,7 +304,7 @@ export class TypeScriptTestHandler extends BaseTestHandler {
     private async launchCustomDebugger(file: TestFile, config: TestConfig, debuggerPath: string): Promise<TestResult> {
         const startTime = performance.now()
 
-        console.log(`Launching custom debugger: ${debuggerPath}`)
+        Log.info(`Launching custom debugger: ${debuggerPath}`)
         const result = await this.runCommand(debuggerPath, [file.path], {
             cwd: file.directory,
             env: await this.getTestEnvironment(config, file),
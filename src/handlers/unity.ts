@@ -0,0 +1,235 @@
+import type {TestFile, TestResult, TestConfig} from '../types.ts'
+import {TestStatus, TestType} from '../types.ts'
+import {CTestHandler} from './c.ts'
+import type {CompileOutcome} from './c.ts'
+import {Coverage} from '../utils/coverage.ts'
+import {canInclude, findUnityTests, generateDriver, parseUnityOutput, writeIfChanged} from '../utils/unity.ts'
+import {join, resolve} from 'path'
+
+// Artifact directory of the shared driver (hidden so it cannot clash with a test's artifact directory)
+const UNITY_DIR = '.unity'
+
+// Driver exit status when a test file exceeds TESTME_UNITY_TIMEOUT (128 + SIGALRM)
+const TIMEOUT_STATUS = 142
+
+/*
+ A C test file in a unity batch and its TM_TEST functions
+ */
+type UnityMember = {
+    file: TestFile
+    tests: string[]
+}
+
+/*
+ Handler for unity builds (compiler.c.unity)
+ C tests in one directory written with TM_TEST() are compiled into a single driver binary and run
+ in one process, so compile, link and spawn overhead is paid once per directory instead of per file.
+ One instance is shared by every test in the batch: the first build() compiles the driver, the first
+ execute() runs it, and every execute() returns that test's share of the output.
+ */
+export class UnityTestHandler extends CTestHandler {
+    private unit: TestFile
+    private members: Map<string, UnityMember>
+    private preparing?: Promise<void>
+    private building?: Promise<CompileOutcome>
+    private running?: Promise<Map<string, TestResult>>
+
+    /*
+     Creates a handler for the TM_TEST files of one directory
+     @param directory Test directory
+     @param members Test files in the batch and their tests
+     */
+    constructor(directory: string, members: UnityMember[]) {
+        super()
+        const artifactDir = UnityTestHandler.getArtifactDir(directory)
+        this.unit = {
+            path: join(artifactDir, 'unity.main.c'),
+            name: 'unity.tst.c',
+            extension: '.c',
+            type: TestType.C,
+            directory,
+            artifactDir,
+        }
+        this.members = new Map(members.map((member) => [member.file.name, member]))
+    }
+
+    /*
+     Gets the artifact directory of the shared driver of a directory
+     @param directory Test directory
+     @returns Path of the driver's artifact directory
+     */
+    static getArtifactDir(directory: string): string {
+        return join(directory, '.testme', UNITY_DIR)
+    }
+
+    /*
+     Groups C tests written with TM_TEST() into one batch per directory
+     Directories with a single such test, and files whose path cannot be included, are left to the
+     regular C handler.
+     @param tests Tests to schedule
+     @returns Shared batch handler for each batched test
+     */
+    static async plan(tests: TestFile[]): Promise<Map<TestFile, UnityTestHandler>> {
+        const byDirectory = new Map<string, UnityMember[]>()
+        for (const file of tests) {
+            if (file.type !== TestType.C || !canInclude(file.path)) {
+                continue
+            }
+            let names: string[]
+            try {
+                names = findUnityTests(await Bun.file(file.path).text())
+            } catch {
+                continue
+            }
+            if (names.length > 0) {
+                const members = byDirectory.get(file.directory) || []
+                members.push({file, tests: names})
+                byDirectory.set(file.directory, members)
+            }
+        }
+        const handlers = new Map<TestFile, UnityTestHandler>()
+        for (const [directory, members] of byDirectory) {
+            if (members.length > 1) {
+                const handler = new UnityTestHandler(directory, members)
+                for (const member of members) {
+                    handlers.set(member.file, handler)
+                }
+            }
+        }
+        return handlers
+    }
+
+    /*
+     Creates the artifact directories for the test and the shared driver
+     @param file C test file to prepare
+     */
+    override async prepare(file: TestFile): Promise<void> {
+        await super.prepare(file)
+        await (this.preparing ??= super.prepare(this.unit))
+    }
+
+    /*
+     Compiles the shared driver (once for the whole batch)
+     @param _file C test file in the batch
+     @param config Test execution configuration
+     */
+    override async build(_file: TestFile, config: TestConfig): Promise<void> {
+        await (this.building ??= this.compile(this.unit, config))
+    }
+
+    /*
+     Returns the result of a test in the batch, running the shared driver on first use
+     If the files cannot be compiled together, the test is compiled and run on its own.
+     @param file C test file in the batch
+     @param config Test execution configuration
+     @returns Promise resolving to test results
+     */
+    override async execute(file: TestFile, config: TestConfig): Promise<TestResult> {
+        if (config.execution?.debugMode) {
+            return await super.execute(file, config)
+        }
+        await (this.preparing ??= super.prepare(this.unit))
+        const compiled = await (this.building ??= this.compile(this.unit, config))
+        if (!compiled.success) {
+            // Typically files defining the same file-scope names - fall back to one binary per file
+            const result = await super.execute(file, config)
+            const note = `Unity build failed (see ${join(this.unit.artifactDir, 'compile.log')}), compiled separately`
+            return {...result, output: `${note}\n\n${result.output}`}
+        }
+        const results = await (this.running ??= this.runDriver(config, compiled))
+        return results.get(file.name) ?? this.createErrorResult(file, 'Test was not run by the unity driver')
+    }
+
+    /*
+     Compiles the batch through a driver including every member, or a member alone after a failed unity build
+     @param file The batch unit or a member test file
+     @returns Test file whose path is the driver to compile
+     */
+    protected override async getCompileUnit(file: TestFile): Promise<TestFile> {
+        if (file !== this.unit) {
+            return await super.getCompileUnit(file)
+        }
+        const units = [...this.members.values()].map(({file, tests}) => ({
+            path: resolve(file.path),
+            name: file.name,
+            tests,
+        }))
+        await writeIfChanged(this.unit.path, generateDriver(units))
+        return this.unit
+    }
+
+    /*
+     Runs the driver and splits its output into per-test results
+     If the driver stops inside a file (crash, exit() or timeout), that file fails and the driver is
+     restarted for the files that did not run. The driver limits each file to execution.timeout
+     (TESTME_UNITY_TIMEOUT); the process timeout only guards platforms without alarm().
+     @param config Test execution configuration
+     @param compiled Result of compiling the driver
+     @returns Results by test file name
+     */
+    private async runDriver(config: TestConfig, compiled: CompileOutcome): Promise<Map<string, TestResult>> {
+        const results = new Map<string, TestResult>()
+        const binaryPath = this.getBinaryPath(this.unit, config)
+        const env = await this.getTestEnvironment(config, this.unit, compiled.compiler)
+        const timeout = (config.execution?.timeout || 30) * 1000
+        env.TESTME_UNITY_TIMEOUT = String(Math.ceil(timeout / 1000))
+        const coverage = this.getInstrumentation(config)?.coverage
+        let pending = [...this.members.keys()]
+        if (coverage) {
+            await Coverage.reset(binaryPath)
+        }
+
+        while (pending.length > 0) {
+            const {result, duration} = await this.measureExecution(async () => {
+                return await this.runCommand(binaryPath, pending, {
+                    cwd: this.unit.directory, // Always run tests with CWD set to the test directory
+                    timeout: timeout * pending.length,
+                    env,
+                    config,
+                    description: `Unity test of ${pending.length} file(s)`,
+                    logDir: this.unit.artifactDir,
+                })
+            })
+            let accounted = 0
+            for (const section of parseUnityOutput(result.stdout)) {
+                const member = this.members.get(section.name)
+                if (!member || results.has(section.name)) {
+                    continue
+                }
+                const elapsed = section.complete ? section.duration : Math.max(0, duration - accounted)
+                accounted += elapsed
+                const stopped = section.complete
+                    ? ''
+                    : result.exitCode === TIMEOUT_STATUS
+                      ? `\n${result.stderr}\n${section.name} timed out after ${timeout / 1000}s`
+                      : `\n${result.stderr}\nStopped with exit code ${result.exitCode}`
+                const output = this.combineOutputs(compiled.output, section.output + stopped, '')
+                const exitCode = section.complete ? (section.failed ? 1 : 0) : result.exitCode
+                const status = section.failed ? TestStatus.Failed : TestStatus.Passed
+                const error = section.failed ? (section.output + stopped).trim() : undefined
+                results.set(section.name, this.createTestResult(member.file, status, elapsed, output, error, exitCode))
+            }
+
+            const remaining = pending.filter((name) => !results.has(name))
+            if (remaining.length === pending.length) {
+                // The driver failed before starting any test (e.g. a missing shared library)
+                const output = this.combineOutputs(compiled.output, result.stdout, result.stderr)
+                const error = result.stderr || `Unity driver exited with code ${result.exitCode}`
+                for (const name of remaining) {
+                    const file = this.members.get(name)!.file
+                    results.set(
+                        name,
+                        this.createTestResult(file, TestStatus.Error, duration, output, error, result.exitCode)
+                    )
+                }
+                break
+            }
+            pending = remaining
+        }
+        // Restarted drivers add to the same coverage data, which is counted once for the batch
+        if (coverage) {
+            await Coverage.collect(binaryPath)
+        }
+        return results
+    }
+}
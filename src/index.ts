@@ -4,10 +4,18 @@ import {CliParser} from './cli.ts'
 import {ConfigManager} from './config.ts'
 import {TestRunner} from './runner.ts'
 import {ServiceManager} from './services.ts'
+import {SharedServices} from './services/shared.ts'
 import {TestDiscovery} from './discovery.ts'
 import {VERSION} from './version.ts'
-import type {TestConfig, TestFile} from './types.ts'
+import {loadReports, selectShard} from './utils/shards.ts'
+import {DependencyGraph, TestWatcher} from './watch.ts'
+import {GROUP_LANE, Trace} from './utils/trace.ts'
+import {StreamReport} from './utils/stream-report.ts'
+import {Coverage} from './utils/coverage.ts'
+import {RunBudget} from './utils/run-budget.ts'
+import type {TestConfig, TestFile, TestResult} from './types.ts'
 import {TestStatus} from './types.ts'
+import {Log} from './utils/log.ts'
 import {resolve, relative, join, sep} from 'path'
 import {writeFile} from 'fs/promises'
 import {existsSync} from 'fs'
@@ -127,11 +135,11 @@ async function handleInit(): Promise<void> {
 `
 
     await writeFile(configPath, defaultConfig, 'utf-8')
-    console.log('✓ Created testme.json5')
-    console.log('\nNext steps:')
-    console.log('  1. Edit testme.json5 to configure your test environment')
-    console.log('  2. Create test files with .tst.* extension (e.g., math.tst.c)')
-    console.log('  3. Run tests with: tm')
+    Log.info('✓ Created testme.json5')
+    Log.info('\nNext steps:')
+    Log.info('  1. Edit testme.json5 to configure your test environment')
+    Log.info('  2. Create test files with .tst.* extension (e.g., math.tst.c)')
+    Log.info('  3. Run tests with: tm')
 }
 
 /*
@@ -248,18 +256,53 @@ try {
     }
 
     await writeFile(filePath, template, 'utf-8')
-    console.log(`✓ Created ${baseName}${extension}`)
-    console.log('\nNext steps:')
-    console.log(`  1. Edit ${baseName}${extension} to add your tests`)
-    console.log('  2. Run tests with: tm')
+    Log.info(`✓ Created ${baseName}${extension}`)
+    Log.info('\nNext steps:')
+    Log.info(`  1. Edit ${baseName}${extension} to add your tests`)
+    Log.info('  2. Run tests with: tm')
 }
 
+/*
+ State kept across runs in watch mode
+ */
+type WatchState = {
+    selected?: Set<string> // Paths of the tests to re-run (undefined runs all tests)
+    started: Map<string, Record<string, string>> // Config dirs with running services -> environment script variables
+    rootConfig?: TestConfig // Root configuration, set once global prep has run
+}
+
+/*
+ State shared by the configuration groups of one run
+ */
+type GroupRun = {
+    rootDir: string // Root directory for test discovery
+    patterns: string[] // CLI test patterns
+    options: any // CLI options
+    invocationDir: string // Directory where tm was invoked (before chdir)
+    watch?: WatchState // Watch mode state
+    services: Promise<void> // Resolves when the last group waiting to run a setup service has stopped it
+}
+
+/*
+ Results of one configuration group
+ */
+type GroupOutcome = {
+    results: TestResult[]
+    exitCode: number
+}
+
+// Configuration groups run one at a time unless execution.groups is set. One group at a time keeps
+// each group's console output together; running more groups at once is opt-in
+const DEFAULT_GROUPS = 1
+
 class TestMeApp {
     private runner: TestRunner
     private serviceManagers: Map<string, ServiceManager> = new Map()
     private globalServiceManager: ServiceManager | null = null
+    private sharedServices = new SharedServices() // Setup services shared by groups (services.share)
     private shouldStop: boolean = false
     private interruptCount: number = 0
+    private wakeWatcher: (() => void) | null = null
 
     constructor() {
         this.runner = new TestRunner()
@@ -276,12 +319,14 @@ class TestMeApp {
             this.interruptCount++
 
             if (this.interruptCount === 1) {
-                // First Ctrl+C: stop gracefully
-                console.log('\n\n⚠️  Interrupt received. Stopping tests and cleaning up...')
+                // First Ctrl+C: kill running tests and compiles, then clean up services
+                Log.info('\n\n⚠️  Interrupt received. Stopping tests and cleaning up...')
                 this.shouldStop = true
+                this.runner.cancel('interrupt')
+                this.wakeWatcher?.()
             } else {
                 // Second Ctrl+C: force exit immediately
-                console.log('\n\n🛑 Force quit. Exiting immediately.')
+                Log.info('\n\n🛑 Force quit. Exiting immediately.')
                 process.exit(130) // 128 + SIGINT(2)
             }
         })
@@ -404,6 +449,7 @@ class TestMeApp {
      @param baseConfig Base configuration to inherit from
      @param options CLI options
      @param invocationDir Original directory where tm was invoked (before chdir)
+     @param watch Watch mode state - selects tests to re-run and keeps services running between runs
      @returns Exit code
      */
     private async executeHierarchically(
@@ -411,25 +457,47 @@ class TestMeApp {
         patterns: string[],
         baseConfig: TestConfig,
         options: any,
-        invocationDir: string
+        invocationDir: string,
+        watch?: WatchState
     ): Promise<number> {
         // Discover all tests in the directory tree using config patterns
         // This ensures we find all potential test files based on their extensions
-        const allTests = await TestDiscovery.discoverTests({
-            rootDir,
-            patterns: baseConfig.patterns?.include || [],
-            excludePatterns: baseConfig.patterns?.exclude || [],
-        })
+        const allTests = await Trace.span('discovery', 'discovery', () =>
+            TestDiscovery.discoverTests({
+                rootDir,
+                patterns: baseConfig.patterns?.include || [],
+                excludePatterns: baseConfig.patterns?.exclude || [],
+                index: baseConfig.patterns?.index,
+            })
+        )
 
         // If CLI patterns are provided, apply them as an additional filter
-        const filteredTests =
+        let filteredTests =
             patterns.length > 0 ? TestDiscovery.filterTestsByPatterns(allTests, patterns, rootDir) : allTests
 
+        // Keep only this node's share of the tests when sharding across CI nodes
+        if (options.shard) {
+            const {index, total} = options.shard
+            filteredTests = await selectShard(filteredTests, options.shard, rootDir, options.shardTimings)
+            // stderr keeps this out of the report when stdout is redirected (tm --shard 1/4 > s1.json)
+            if (!options.quiet) {
+                console.error(`\nShard ${index}/${total}: ${filteredTests.length} test(s)`)
+            }
+        }
+
+        // In watch mode, re-run only the tests affected by the latest changes
+        if (watch?.selected) {
+            const selected = watch.selected
+            filteredTests = filteredTests.filter((test) => selected.has(test.path))
+        }
+
         if (filteredTests.length === 0) {
-            if (patterns.length > 0) {
-                console.log(`No tests matching pattern(s): ${patterns.join(', ')}`)
+            if (watch?.selected) {
+                Log.info('No tests affected')
+            } else if (patterns.length > 0) {
+                Log.info(`No tests matching pattern(s): ${patterns.join(', ')}`)
             } else {
-                console.log('No tests discovered')
+                Log.info('No tests discovered')
             }
             return 0
         }
@@ -439,221 +507,488 @@ class TestMeApp {
 
         // Load the root (shallowest) configuration for global services
         // This finds the closest testme.json5 to the filesystem root from all test directories
-        const rootConfig = await ConfigManager.findRootConfig(testDirectories)
+        const rootConfig = await Trace.span('root config', 'config', () =>
+            ConfigManager.findRootConfig(testDirectories)
+        )
 
         // Group tests by their configuration directory
-        const testGroups = await this.groupTestsByConfig(filteredTests)
+        const testGroups = await Trace.span('group by config', 'config', () =>
+            this.groupTestsByConfig(filteredTests)
+        )
 
-        console.log(`\nDiscovered ${filteredTests.length} test(s) in ${testGroups.size} configuration group(s)`)
+        Log.info(`\nDiscovered ${filteredTests.length} test(s) in ${testGroups.size} configuration group(s)`)
 
         // Run global prep once before all test groups (if configured in root config)
-        if (!options.noServices && rootConfig.services?.globalPrep) {
+        // In watch mode it only runs before the first run
+        if (!options.noServices && rootConfig.services?.globalPrep && !watch?.rootConfig) {
             // Apply CLI overrides to rootConfig so verbose mode works for global prep
             const rootConfigWithOverrides = this.applyCliOverrides(rootConfig, options)
-            await this.getGlobalServiceManager(rootConfig.configDir || rootDir).runGlobalPrep(rootConfigWithOverrides)
+            await Trace.span('globalPrep', 'services', () =>
+                this.getGlobalServiceManager(rootConfig.configDir || rootDir).runGlobalPrep(rootConfigWithOverrides)
+            )
+        }
+        if (watch) {
+            watch.rootConfig ??= rootConfig
         }
 
-        let allResults: any[] = []
-        let totalExitCode = 0
+        // Run configuration groups concurrently (execution.groups in the root config). Groups share one
+        // budget of worker and compile slots, so while one group runs a slow prep or starts its services,
+        // the tests of groups that are ready keep the workers busy.
+        const runConfig = this.applyCliOverrides(baseConfig, options)
+        const concurrency = Math.min(this.getGroupConcurrency(runConfig), testGroups.size)
+        const run: GroupRun = {rootDir, patterns, options, invocationDir, watch, services: Promise.resolve()}
+        const outcomes: (GroupOutcome | undefined)[] = []
+        const queue = [...testGroups].entries()
+        let failure: {error: unknown} | undefined
+
+        // Shared services outlive their groups while other groups may still start them (in watch mode,
+        // until it exits). Once every group is past its setup, each stops when its last group finishes.
+        let pendingSetups = testGroups.size
+        if (!watch) {
+            this.sharedServices.retain()
+        }
+        const runGroups = async () => {
+            for (const [index, [configDir, tests]] of queue) {
+                // Stop starting groups on Ctrl+C or when a group fails to start its services
+                if (this.shouldStop || failure) {
+                    break
+                }
+                let setupDone = false
+                const servicesStarted = async () => {
+                    if (setupDone) {
+                        return
+                    }
+                    setupDone = true
+                    if (--pendingSetups === 0 && !watch) {
+                        await this.sharedServices.unretain()
+                    }
+                }
+                try {
+                    const name = `Group ${relative(rootDir, configDir) || '.'}`
+                    outcomes[index] = await Trace.lane(GROUP_LANE + index, name, () =>
+                        this.runGroup(configDir, tests, run, servicesStarted)
+                    )
+                } catch (error) {
+                    failure ??= {error}
+                } finally {
+                    await servicesStarted()
+                }
+            }
+        }
 
-        // Execute each configuration group
-        for (const [configDir, tests] of testGroups) {
-            // Check if we should stop (Ctrl+C pressed)
-            if (this.shouldStop) {
-                break
+        if (concurrency > 1) {
+            const workers = RunBudget.getWorkers(runConfig.execution)
+            this.runner.setBudget(new RunBudget(workers, RunBudget.getCompiles(runConfig.execution)))
+        }
+        try {
+            await Promise.all(Array.from({length: concurrency}, runGroups))
+        } finally {
+            this.runner.setBudget(undefined)
+            if (!watch) {
+                await this.sharedServices.stopAll()
             }
+        }
+        if (failure) {
+            throw failure.error
+        }
 
-            // Get configuration for this group
-            const groupConfig = await ConfigManager.findConfig(configDir)
+        // Results are reported in group order, whichever group finished first
+        const allResults: TestResult[] = []
+        let totalExitCode = 0
+        for (const outcome of outcomes) {
+            if (outcome) {
+                allResults.push(...outcome.results)
+                if (outcome.exitCode !== 0) {
+                    totalExitCode = outcome.exitCode
+                }
+            }
+        }
 
-            // Apply CLI overrides to group config
-            let mergedConfig = this.applyCliOverrides(groupConfig, options)
+        // Run global cleanup once after all test groups (if configured in root config)
+        if (!watch && !options.noServices && rootConfig.services?.globalCleanup) {
+            // Apply CLI overrides to rootConfig so verbose mode works for global cleanup
+            const rootConfigWithOverrides = this.applyCliOverrides(rootConfig, options)
+            const allTestsPassed = totalExitCode === 0
+            await Trace.span('globalCleanup', 'services', () =>
+                this.getGlobalServiceManager(rootConfig.configDir || rootDir).runGlobalCleanup(
+                    rootConfigWithOverrides,
+                    allTestsPassed
+                )
+            )
+        }
 
-            // Check if tests are disabled for this directory
-            if (mergedConfig.enable === false) {
-                if (mergedConfig.output?.verbose) {
-                    console.log(`\n🚫 Tests disabled in: ${relative(rootDir, configDir) || '.'}`)
-                }
-                continue
+        // Report final results
+        if (!this.isQuietMode(baseConfig)) {
+            const started = performance.now()
+            this.runner.reportFinalResults(allResults, baseConfig, rootDir)
+            Trace.record('report', 'report', started, performance.now())
+        }
+
+        // If --continue flag is set, always return 0 (success)
+        return options.continue ? 0 : totalExitCode
+    }
+
+    /*
+     Runs one configuration group: skip, environment, prep and setup services, the tests, then cleanup
+     @param configDir Configuration directory of the group
+     @param tests Tests in the group
+     @param run State shared by the groups of the run
+     @param servicesStarted Called once the group's services are running, before its tests
+     @returns Results and exit code of the group, or undefined if the group is disabled or not selected
+     */
+    private async runGroup(
+        configDir: string,
+        tests: TestFile[],
+        run: GroupRun,
+        servicesStarted: () => Promise<void>
+    ): Promise<GroupOutcome | undefined> {
+        const {rootDir, patterns, options, invocationDir, watch} = run
+
+        // Get configuration for this group
+        const groupConfig = await ConfigManager.findConfig(configDir)
+
+        // Apply CLI overrides to group config
+        let mergedConfig = this.applyCliOverrides(groupConfig, options)
+
+        // Check if tests are disabled for this directory
+        if (mergedConfig.enable === false) {
+            if (mergedConfig.output?.verbose) {
+                Log.info(`\n🚫 Tests disabled in: ${relative(rootDir, configDir) || '.'}`)
             }
+            return undefined
+        }
 
-            // Filter manual tests - only run if explicitly named or invoked from within the manual directory
-            let filteredTests = tests
-            if (mergedConfig.enable === 'manual') {
-                // Check if tm was invoked from within this config directory (use invocationDir, not cwd after chdir)
-                const isInvokedFromManualDir = invocationDir === configDir || invocationDir.startsWith(configDir + sep)
+        // Filter manual tests - only run if explicitly named or invoked from within the manual directory
+        let filteredTests = tests
+        if (mergedConfig.enable === 'manual') {
+            // Check if tm was invoked from within this config directory (use invocationDir, not cwd after chdir)
+            const isInvokedFromManualDir = invocationDir === configDir || invocationDir.startsWith(configDir + sep)
 
-                // Check if any patterns were provided
-                const hasExplicitPatterns = patterns.length > 0 && patterns.some((p) => this.isExplicitPattern(p))
+            // Check if any patterns were provided
+            const hasExplicitPatterns = patterns.length > 0 && patterns.some((p) => this.isExplicitPattern(p))
 
-                if (isInvokedFromManualDir && patterns.length === 0) {
-                    // Invoked from manual directory without patterns - run all tests in this group
-                    // This is treated as an explicit manual invocation
-                    if (mergedConfig.output?.verbose) {
-                        console.log(
-                            `\n✓ Running manual tests in: ${relative(rootDir, configDir) || '.'} (invoked from manual directory)`
-                        )
-                    }
-                } else if (hasExplicitPatterns) {
-                    // Only include tests that match explicit patterns
-                    filteredTests = tests.filter((test) =>
-                        patterns.some((pattern) => {
-                            if (!this.isExplicitPattern(pattern)) {
-                                return false
-                            }
+            if (isInvokedFromManualDir && patterns.length === 0) {
+                // Invoked from manual directory without patterns - run all tests in this group
+                // This is treated as an explicit manual invocation
+                if (mergedConfig.output?.verbose) {
+                    Log.info(
+                        `\n✓ Running manual tests in: ${relative(rootDir, configDir) || '.'} (invoked from manual directory)`
+                    )
+                }
+            } else if (hasExplicitPatterns) {
+                // Only include tests that match explicit patterns
+                filteredTests = tests.filter((test) =>
+                    patterns.some((pattern) => {
+                        if (!this.isExplicitPattern(pattern)) {
+                            return false
+                        }
 
-                            // For manual tests NOT invoked from manual directory,
-                            // require that the pattern explicitly includes the directory path
-                            if (!isInvokedFromManualDir) {
-                                // Get relative path from rootDir to configDir
-                                const relativeConfigDir =
-                                    configDir === rootDir ? '' : configDir.replace(rootDir + sep, '').replace(/\\/g, '/')
-                                const normalizedPattern = pattern.replace(/\\/g, '/')
-
-                                // If we have a config directory (not root), check if pattern references it
-                                if (relativeConfigDir) {
-                                    // Pattern must include the config directory path
-                                    // Examples: "fuzz/tls", "fuzz/tls.tst.c"
-                                    const configDirWithSlash = relativeConfigDir + '/'
-                                    if (
-                                        !normalizedPattern.startsWith(configDirWithSlash) &&
-                                        normalizedPattern !== relativeConfigDir
-                                    ) {
-                                        // Pattern doesn't reference this manual directory, skip this test
-                                        return false
-                                    }
+                        // For manual tests NOT invoked from manual directory,
+                        // require that the pattern explicitly includes the directory path
+                        if (!isInvokedFromManualDir) {
+                            // Get relative path from rootDir to configDir
+                            const relativeConfigDir =
+                                configDir === rootDir ? '' : configDir.replace(rootDir + sep, '').replace(/\\/g, '/')
+                            const normalizedPattern = pattern.replace(/\\/g, '/')
+
+                            // If we have a config directory (not root), check if pattern references it
+                            if (relativeConfigDir) {
+                                // Pattern must include the config directory path
+                                // Examples: "fuzz/tls", "fuzz/tls.tst.c"
+                                const configDirWithSlash = relativeConfigDir + '/'
+                                if (
+                                    !normalizedPattern.startsWith(configDirWithSlash) &&
+                                    normalizedPattern !== relativeConfigDir
+                                ) {
+                                    // Pattern doesn't reference this manual directory, skip this test
+                                    return false
                                 }
                             }
+                        }
 
-                            return this.testMatchesExplicitPattern(test, pattern, rootDir)
-                        })
-                    )
+                        return this.testMatchesExplicitPattern(test, pattern, rootDir)
+                    })
+                )
 
-                    if (filteredTests.length === 0) {
-                        if (mergedConfig.output?.verbose) {
-                            console.log(
-                                `\n⏭️  Skipping manual tests in: ${relative(rootDir, configDir) || '.'} (not explicitly named)`
-                            )
-                        }
-                        continue
-                    }
-                } else {
-                    // No explicit patterns and not invoked from manual directory - skip all manual tests
+                if (filteredTests.length === 0) {
                     if (mergedConfig.output?.verbose) {
-                        console.log(
+                        Log.info(
                             `\n⏭️  Skipping manual tests in: ${relative(rootDir, configDir) || '.'} (not explicitly named)`
                         )
                     }
-                    continue
+                    return undefined
                 }
+            } else {
+                // No explicit patterns and not invoked from manual directory - skip all manual tests
+                if (mergedConfig.output?.verbose) {
+                    Log.info(
+                        `\n⏭️  Skipping manual tests in: ${relative(rootDir, configDir) || '.'} (not explicitly named)`
+                    )
+                }
+                return undefined
             }
+        }
 
-            // Check if depth requirement is met
-            const requiredDepth = mergedConfig.depth ?? 0
-            const currentDepth = options.depth ?? 0
-            if (currentDepth < requiredDepth) {
+        // Check if depth requirement is met
+        const requiredDepth = mergedConfig.depth ?? 0
+        const currentDepth = options.depth ?? 0
+        if (currentDepth < requiredDepth) {
+            if (mergedConfig.output?.verbose) {
+                Log.info(
+                    `\n⏭️  Skipping tests in: ${relative(rootDir, configDir) || '.'} (requires --depth ${requiredDepth}, current: ${currentDepth})`
+                )
+            }
+            return undefined
+        }
+
+        // Check if tests should be skipped via skip script
+        if (!options.noServices && mergedConfig.services?.skip) {
+            const skipResult = await Trace.span('skip', 'services', () =>
+                this.getServiceManager(configDir, rootDir).runSkip(mergedConfig)
+            )
+            if (skipResult.shouldSkip) {
                 if (mergedConfig.output?.verbose) {
-                    console.log(
-                        `\n⏭️  Skipping tests in: ${relative(rootDir, configDir) || '.'} (requires --depth ${requiredDepth}, current: ${currentDepth})`
+                    Log.info(
+                        `\n⏭️  Skipping tests in: ${relative(rootDir, configDir) || '.'} - ${skipResult.message || 'Skip script returned non-zero'}`
                     )
                 }
-                continue
+                // Add skipped results for these tests
+                const skippedResults = filteredTests.map((test) => ({
+                    file: test,
+                    status: TestStatus.Skipped,
+                    duration: 0,
+                    output: skipResult.message || 'Skip script returned non-zero',
+                }))
+                return {results: skippedResults, exitCode: 0}
             }
+        }
 
-            // Check if tests should be skipped via skip script
-            if (!options.noServices && mergedConfig.services?.skip) {
-                const skipResult = await this.getServiceManager(configDir, rootDir).runSkip(mergedConfig)
-                if (skipResult.shouldSkip) {
-                    if (mergedConfig.output?.verbose) {
-                        console.log(
-                            `\n⏭️  Skipping tests in: ${relative(rootDir, configDir) || '.'} - ${skipResult.message || 'Skip script returned non-zero'}`
-                        )
-                    }
-                    // Add skipped results for these tests
-                    const skippedResults = filteredTests.map((test) => ({
-                        file: test,
-                        status: TestStatus.Skipped,
-                        duration: 0,
-                        output: skipResult.message || 'Skip script returned non-zero',
-                    }))
-                    allResults.push(...skippedResults)
-                    continue
+        // Show parallel execution info if enabled
+        const isParallel = mergedConfig.execution?.parallel !== false
+        const workers = RunBudget.getWorkers(mergedConfig.execution)
+        const actualWorkers = Math.min(workers, filteredTests.length)
+        const locationStr = relative(rootDir, configDir) || '.'
+
+        if (isParallel && actualWorkers > 1) {
+            Log.info(`\n🧪 Running ${filteredTests.length} test(s) with ${actualWorkers} in parallel`)
+        } else {
+            Log.info(`\n🧪 Running ${filteredTests.length} test(s) in: ${locationStr}`)
+        }
+
+        let groupExitCode = 0
+        let results: TestResult[] = []
+        let releaseServices: (() => void) | undefined
+        let sharedKey: string | undefined
+        try {
+            // Run services for this configuration group
+            // In watch mode, services started by an earlier run are still running and are reused
+            const servicesRunning = watch?.started.has(configDir) === true
+            let envVars: Record<string, string> = watch?.started.get(configDir) || {}
+
+            // Environment script runs first and its variables are merged into the config
+            if (!servicesRunning && !options.noServices && mergedConfig.services?.environment) {
+                envVars = await Trace.span('environment', 'services', () =>
+                    this.getServiceManager(configDir, rootDir).runEnvironment(mergedConfig)
+                )
+            }
+            // Merge environment variables from script into config
+            if (Object.keys(envVars).length > 0) {
+                mergedConfig = {
+                    ...mergedConfig,
+                    environment: {
+                        ...mergedConfig.environment,
+                        ...envVars,
+                    },
                 }
             }
 
-            // Show parallel execution info if enabled
-            const isParallel = mergedConfig.execution?.parallel !== false
-            const workers = mergedConfig.execution?.workers || 4
-            const actualWorkers = Math.min(workers, filteredTests.length)
-            const locationStr = relative(rootDir, configDir) || '.'
-
-            if (isParallel && actualWorkers > 1) {
-                console.log(`\n🧪 Running ${filteredTests.length} test(s) with ${actualWorkers} in parallel`)
-            } else {
-                console.log(`\n🧪 Running ${filteredTests.length} test(s) in: ${locationStr}`)
+            if (!servicesRunning && !options.noServices && mergedConfig.services?.prep) {
+                await Trace.span('prep', 'services', () =>
+                    this.getServiceManager(configDir, rootDir).runPrep(mergedConfig)
+                )
             }
 
-            let groupExitCode = 0
-            try {
-                // Run services for this configuration group
-                // Environment script runs first and its variables are merged into the config
-                if (!options.noServices && mergedConfig.services?.environment) {
-                    const envVars = await this.getServiceManager(configDir, rootDir).runEnvironment(mergedConfig)
-                    // Merge environment variables from script into config
-                    if (Object.keys(envVars).length > 0) {
-                        mergedConfig = {
-                            ...mergedConfig,
-                            environment: {
-                                ...mergedConfig.environment,
-                                ...envVars,
-                            },
-                        }
+            if (!servicesRunning && !options.noServices && mergedConfig.services?.setup) {
+                const serviceManager = this.getServiceManager(configDir, rootDir)
+                const key = await serviceManager.getShareKey(mergedConfig)
+                if (key) {
+                    // Shared service: started by the first group with the same command and environment
+                    await Trace.span('setup', 'services', () =>
+                        this.sharedServices.acquire(key, mergedConfig, () => serviceManager.createSharedManager())
+                    )
+                    sharedKey = key
+                } else {
+                    // One group at a time runs a setup service (watch mode keeps every group's service running)
+                    if (!watch) {
+                        releaseServices = await this.lockServices(run)
                     }
+                    await Trace.span('setup', 'services', () => serviceManager.runSetup(mergedConfig))
                 }
+            }
+            watch?.started.set(configDir, envVars)
+            await servicesStarted()
 
-                if (!options.noServices && mergedConfig.services?.prep) {
-                    await this.getServiceManager(configDir, rootDir).runPrep(mergedConfig)
+            // Execute tests in this group
+            results = await this.runner.executeTestsWithConfig(filteredTests, mergedConfig, rootDir)
+            groupExitCode = this.runner.getExitCode(results)
+        } finally {
+            try {
+                // Cleanup for this configuration group (deferred until watch mode exits)
+                if (!watch && !options.noServices && mergedConfig.services?.cleanup) {
+                    const allTestsPassed = groupExitCode === 0
+                    await Trace.span('cleanup', 'services', () =>
+                        this.getServiceManager(configDir, rootDir).runCleanup(mergedConfig, allTestsPassed)
+                    )
+                } else if (releaseServices) {
+                    await this.getServiceManager(configDir, rootDir).killSetup(mergedConfig)
                 }
-
-                if (!options.noServices && mergedConfig.services?.setup) {
-                    await this.getServiceManager(configDir, rootDir).runSetup(mergedConfig)
+            } finally {
+                releaseServices?.()
+                // Shared services stop after the cleanup of their last group (kept running in watch mode)
+                if (sharedKey && !watch) {
+                    await this.sharedServices.release(sharedKey)
                 }
+            }
+        }
+        return {results, exitCode: groupExitCode}
+    }
 
-                // Execute tests in this group
-                const results = await this.runner.executeTestsWithConfig(filteredTests, mergedConfig, rootDir)
+    /*
+     Waits until no other group is running a setup service
+     Setup services of different groups never run together, as they may bind the same ports or share state.
+     Other groups' prep scripts and tests keep running meanwhile.
+     @param run State shared by the groups of the run
+     @returns Releases the setup service turn to the next group
+     */
+    private async lockServices(run: GroupRun): Promise<() => void> {
+        const previous = run.services
+        let release!: () => void
+        run.services = new Promise<void>((resolve) => (release = resolve))
+        await previous
+        return release
+    }
+
+    /*
+     Gets how many configuration groups may run at once
+     Step and debug modes prompt the user per test, so they run groups one at a time.
+     @param config Root configuration with CLI overrides applied
+     @returns Number of concurrently running groups
+     */
+    private getGroupConcurrency(config: TestConfig): number {
+        const execution = config.execution
+        if (execution?.stepMode || execution?.debugMode || execution?.parallel === false) {
+            return 1
+        }
+        return Math.max(1, execution?.groups ?? DEFAULT_GROUPS)
+    }
 
-                allResults.push(...results)
-                groupExitCode = this.runner.getExitCode(results)
-                if (groupExitCode !== 0) {
-                    totalExitCode = groupExitCode
+    /*
+     Runs tests, then watches for changes and re-runs the tests affected by each change
+     Services are started once and kept running until watching is interrupted with Ctrl+C.
+     @param rootDir Root directory for test discovery
+     @param patterns Test patterns to filter
+     @param baseConfig Base configuration
+     @param options CLI options
+     @param invocationDir Original directory where tm was invoked (before chdir)
+     @returns Exit code of the last run
+     */
+    private async watchTests(
+        rootDir: string,
+        patterns: string[],
+        baseConfig: TestConfig,
+        options: any,
+        invocationDir: string
+    ): Promise<number> {
+        const state: WatchState = {started: new Map()}
+        const discover = () =>
+            TestDiscovery.discoverTests({
+                rootDir,
+                patterns: baseConfig.patterns?.include || [],
+                excludePatterns: baseConfig.patterns?.exclude || [],
+                index: baseConfig.patterns?.index,
+            })
+        let changes: string[] = []
+        const watcher = new TestWatcher(rootDir, (paths) => {
+            changes.push(...paths)
+            this.wakeWatcher?.()
+        })
+        watcher.start()
+
+        let exitCode = 0
+        try {
+            exitCode = await this.executeHierarchically(rootDir, patterns, baseConfig, options, invocationDir, state)
+            let tests = await discover()
+            let graph = await DependencyGraph.build(tests)
+            watcher.watchDependencies(graph.files())
+
+            while (!this.shouldStop) {
+                if (changes.length === 0) {
+                    Log.info('\n👀 Watching for changes (Ctrl+C to exit)...')
+                    await new Promise<void>((wake) => (this.wakeWatcher = wake))
+                    this.wakeWatcher = null
+                    continue
                 }
-            } finally {
-                // Cleanup for this configuration group
-                if (!options.noServices && mergedConfig.services?.cleanup) {
-                    const allTestsPassed = groupExitCode === 0
-                    await this.getServiceManager(configDir, rootDir).runCleanup(mergedConfig, allTestsPassed)
+                const batch = changes
+                changes = []
+
+                // Config files are re-read on the next run, other cached state stays resident
+                if (batch.some((path) => path.endsWith('testme.json5'))) {
+                    ConfigManager.clearCache()
+                }
+                tests = await discover()
+                const affected = graph.affected(batch, tests)
+                const selected = new Set(tests.filter((test) => affected.has(test.path)).map((test) => test.path))
+                if (selected.size === 0) {
+                    continue
                 }
+                Log.info(`\n🔄 ${batch.length} file(s) changed, re-running ${selected.size} test(s)`)
+                state.selected = selected
+                exitCode = await this.executeHierarchically(rootDir, patterns, baseConfig, options, invocationDir, state)
+
+                // Rebuild after the run so newly compiled C tests contribute their header dependencies
+                graph = await DependencyGraph.build(tests)
+                watcher.watchDependencies(graph.files())
             }
+        } finally {
+            watcher.close()
+            await this.stopWatchServices(state, rootDir, options, exitCode === 0)
         }
+        return exitCode
+    }
 
-        // Run global cleanup once after all test groups (if configured in root config)
-        if (!options.noServices && rootConfig.services?.globalCleanup) {
-            // Apply CLI overrides to rootConfig so verbose mode works for global cleanup
-            const rootConfigWithOverrides = this.applyCliOverrides(rootConfig, options)
-            const allTestsPassed = totalExitCode === 0
+    /*
+     Stops services kept running by watch mode
+     @param state Watch mode state
+     @param rootDir Root directory for test discovery
+     @param options CLI options
+     @param allTestsPassed Whether the last run passed
+     */
+    private async stopWatchServices(
+        state: WatchState,
+        rootDir: string,
+        options: any,
+        allTestsPassed: boolean
+    ): Promise<void> {
+        if (options.noServices) {
+            return
+        }
+        for (const configDir of state.started.keys()) {
+            const groupConfig = this.applyCliOverrides(await ConfigManager.findConfig(configDir), options)
+            const serviceManager = this.getServiceManager(configDir, rootDir)
+            if (groupConfig.services?.cleanup) {
+                await serviceManager.runCleanup(groupConfig, allTestsPassed)
+            } else {
+                await serviceManager.killSetup(groupConfig)
+            }
+        }
+        await this.sharedServices.stopAll()
+        const rootConfig = state.rootConfig
+        if (rootConfig?.services?.globalCleanup) {
             await this.getGlobalServiceManager(rootConfig.configDir || rootDir).runGlobalCleanup(
-                rootConfigWithOverrides,
+                this.applyCliOverrides(rootConfig, options),
                 allTestsPassed
             )
         }
-
-        // Report final results
-        if (!this.isQuietMode(baseConfig)) {
-            this.runner.reportFinalResults(allResults, baseConfig, rootDir)
-        }
-
-        // If --continue flag is set, always return 0 (success)
-        return options.continue ? 0 : totalExitCode
     }
 
     /*
@@ -799,6 +1134,15 @@ class TestMeApp {
             }
         }
 
+        if (options.repeat !== undefined) {
+            mergedConfig.execution = {
+                ...mergedConfig.execution,
+                timeout: mergedConfig.execution?.timeout ?? 30000,
+                parallel: mergedConfig.execution?.parallel ?? true,
+                repeat: options.repeat,
+            }
+        }
+
         if (options.duration !== undefined) {
             mergedConfig.execution = {
                 ...mergedConfig.execution,
@@ -834,6 +1178,26 @@ class TestMeApp {
             }
         }
 
+        if (options.saveBaseline) {
+            mergedConfig.execution = {
+                ...mergedConfig.execution,
+                timeout: mergedConfig.execution?.timeout ?? 30,
+                parallel: mergedConfig.execution?.parallel ?? true,
+                saveBaseline: true,
+            }
+        }
+
+        if (options.sanitize || options.coverage) {
+            mergedConfig.compiler = {
+                ...mergedConfig.compiler,
+                c: {
+                    ...mergedConfig.compiler?.c,
+                    ...(options.sanitize && {sanitize: options.sanitize}),
+                    ...(options.coverage && {coverage: true}),
+                },
+            }
+        }
+
         if (options.profile !== undefined) {
             mergedConfig.profile = options.profile
         }
@@ -864,13 +1228,13 @@ class TestMeApp {
 
             // Handle help option
             if (options.help) {
-                console.log(CliParser.getUsage())
+                Log.info(CliParser.getUsage())
                 return 0
             }
 
             // Handle version option
             if (options.version) {
-                console.log(`tm version ${VERSION}`)
+                Log.info(`tm version ${VERSION}`)
                 return 0
             }
 
@@ -889,6 +1253,23 @@ class TestMeApp {
             // Capture invocation directory before chdir
             const invocationDir = process.cwd()
 
+            // Record run phases and test stages for --trace (the file is written when the run ends)
+            if (options.trace) {
+                Trace.start(resolve(invocationDir, options.trace))
+            }
+
+            // Stream results to --ndjson and --junit reports as tests complete (closed when the run ends)
+            if (options.ndjson || options.junit) {
+                await StreamReport.start({
+                    ndjson: options.ndjson && resolve(invocationDir, options.ndjson),
+                    junit: options.junit && resolve(invocationDir, options.junit),
+                    rootDir: invocationDir,
+                })
+            }
+
+            // Coverage of C tests built with compiler.c.coverage or --coverage (written when the run ends)
+            Coverage.start(join(invocationDir, '.testme', 'lcov.info'), options.quiet)
+
             // Handle chdir option
             if (options.chdir) {
                 try {
@@ -898,10 +1279,10 @@ class TestMeApp {
                 }
             }
 
-            // Load configuration
+            // Load configuration (copied: the CLI overrides below must not change the cached config)
             config = options.config
                 ? await ConfigManager.loadConfigFromFile(options.config)
-                : await ConfigManager.findConfig(process.cwd())
+                : {...(await ConfigManager.findConfig(process.cwd()))}
 
             // Apply verbose flag from CLI - enables detailed output and TESTME_VERBOSE
             if (options.verbose) {
@@ -995,6 +1376,16 @@ class TestMeApp {
                 }
             }
 
+            // Apply repeat flag from CLI - runs each test N times
+            if (options.repeat !== undefined) {
+                config.execution = {
+                    ...config.execution,
+                    timeout: config.execution?.timeout ?? 30,
+                    parallel: config.execution?.parallel ?? true,
+                    repeat: options.repeat,
+                }
+            }
+
             // Apply duration flag from CLI - sets duration count
             if (options.duration !== undefined) {
                 config.execution = {
@@ -1017,14 +1408,27 @@ class TestMeApp {
 
             const rootDir = resolve(process.cwd())
 
+            // JSON output reserves stdout for the final report (e.g. tm --shard 1/4 > s1.json),
+            // so progress and summary messages are written to stderr
+            if (config.output?.format === 'json') {
+                Log.useStream(process.stderr)
+            }
+
             // Handle clean option
             if (options.clean) {
-                console.log('Cleaning test artifacts...')
+                Log.info('Cleaning test artifacts...')
                 await this.runner.cleanArtifacts(rootDir)
-                console.log('✓ All test artifacts cleaned')
+                Log.info('✓ All test artifacts cleaned')
                 return 0
             }
 
+            // Handle merge option - combine per-shard JSON reports into one final report
+            if (options.merge) {
+                const results = await loadReports(options.patterns.map((file: string) => resolve(invocationDir, file)))
+                this.runner.reportFinalResults(results, config, rootDir)
+                return options.continue ? 0 : this.runner.getExitCode(results)
+            }
+
             // Handle list option
             if (options.list) {
                 // Use config patterns for discovery, then filter by CLI patterns if provided
@@ -1033,6 +1437,7 @@ class TestMeApp {
                         rootDir,
                         patterns: config.patterns?.include || [],
                         excludePatterns: config.patterns?.exclude || [],
+                        index: config.patterns?.index,
                     },
                     config,
                     invocationDir,
@@ -1042,7 +1447,7 @@ class TestMeApp {
             }
 
             // Execute tests hierarchically with proper configuration and services handling
-            console.log(`\n🧪 Test runner starting in: ${rootDir}`)
+            Log.info(`\n🧪 Test runner starting in: ${rootDir}`)
 
             // Apply quiet mode to base config if needed
             if (options.quiet) {
@@ -1069,6 +1474,9 @@ class TestMeApp {
                 }
             }
 
+            if (options.watch) {
+                return await this.watchTests(rootDir, options.patterns, config, options, invocationDir)
+            }
             return await this.executeHierarchically(rootDir, options.patterns, config, options, invocationDir)
         } catch (error) {
             // Only run cleanup if parsing completed and services were potentially started
@@ -1100,6 +1508,11 @@ class TestMeApp {
                 this.handleError(error, parsingComplete)
             }
             return 1
+        } finally {
+            await this.runner.flushArtifacts()
+            await Coverage.finish()
+            await StreamReport.finish()
+            await Trace.write()
         }
     }
 
@@ -11,6 +11,11 @@
 
 /*********************************** Includes *********************************/
 
+#if defined(__linux__) && defined(__STRICT_ANSI__) && !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+    //  Expose POSIX APIs such as clock_gettime() when compiling with -std=c99
+    #define _POSIX_C_SOURCE 200809L
+#endif
+
 #ifdef _WIN32
     //  Disable security warnings for standard C functions on Windows
     #undef   _CRT_SECURE_NO_DEPRECATE
@@ -20,17 +25,37 @@
     #define  _WINSOCK_DEPRECATED_NO_WARNINGS 1
     #include <winsock2.h>
     #include <windows.h>
+    #include <io.h>
 #else
+    #include <fcntl.h>
+    #include <pthread.h>
+    #include <sched.h>
+    #include <signal.h>
     #include <unistd.h>
+    #include <sys/wait.h>
 #endif
 
+#include <errno.h>
+#include <setjmp.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
+#include <time.h>
 #include <sys/types.h>
 
+#if defined(__linux__) && !defined(TM_NO_PERF) && (defined(_GNU_SOURCE) || defined(_DEFAULT_SOURCE) || \
+    !(defined(__STRICT_ANSI__) || defined(_POSIX_C_SOURCE) || defined(_XOPEN_SOURCE)))
+    //  Hardware performance counters for tPerfBegin()/tPerfEnd(). syscall() is only declared with the
+    //  default or GNU feature set, not under strict ISO C or an explicit POSIX/XOPEN level.
+    #define TM_PERF 1
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+#endif
+
 #if defined(__linux__)
 #define true 1
 #define false 0
@@ -55,6 +80,57 @@ extern "C" {
     #define TM_UNUSED
 #endif
 
+//  Thread-local storage for the state of tStress() threads
+#if defined(_MSC_VER)
+    #define TM_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__) || defined(__clang__)
+    #define TM_THREAD_LOCAL __thread
+#else
+    #define TM_THREAD_LOCAL _Thread_local
+#endif
+
+/*
+    Atomic operations on long values shared by tStress() threads (counters, flags and the report lock)
+ */
+#if defined(__GNUC__) || defined(__clang__)
+    #define TM_ATOMIC_ADD(p, n)     __atomic_fetch_add((p), (n), __ATOMIC_SEQ_CST)
+    #define TM_ATOMIC_GET(p)        __atomic_load_n((p), __ATOMIC_SEQ_CST)
+    #define TM_ATOMIC_SET(p, v)     __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+    #define TM_ATOMIC_SWAP(p, v)    __atomic_exchange_n((p), (v), __ATOMIC_SEQ_CST)
+#elif defined(_MSC_VER)
+    #define TM_ATOMIC_ADD(p, n)     InterlockedExchangeAdd((volatile LONG*) (p), (LONG) (n))
+    #define TM_ATOMIC_GET(p)        InterlockedCompareExchange((volatile LONG*) (p), 0, 0)
+    #define TM_ATOMIC_SET(p, v)     InterlockedExchange((volatile LONG*) (p), (LONG) (v))
+    #define TM_ATOMIC_SWAP(p, v)    InterlockedExchange((volatile LONG*) (p), (LONG) (v))
+#else
+    //  No atomics: tStress() runs, but its counters and the report lock are not thread-safe
+    #define TM_ATOMIC_ADD(p, n)     (*(p) += (n))
+    #define TM_ATOMIC_GET(p)        (*(p))
+    #define TM_ATOMIC_SET(p, v)     (*(p) = (v))
+    #define TM_ATOMIC_SWAP(p, v)    tAtomicSwap((p), (v))
+    TM_UNUSED static long tAtomicSwap(volatile long *p, long v) { long old = *p; *p = v; return old; }
+#endif
+
+/*
+    Unity test state. In a TM_TEST driver (TM_UNITY), a failed assertion ends the current
+    TM_TEST function instead of the process so the remaining tests still run.
+ */
+#if TM_UNITY
+static jmp_buf  tmUnityJump;
+static int      tmUnityActive = 0;
+#endif
+
+/*
+    tStress() thread state. In a stress thread, a failed assertion ends the thread instead of the process
+    and passing assertions are counted silently.
+ */
+static TM_THREAD_LOCAL jmp_buf  *tmStressJump = NULL;  // Failure handler of a stress thread (NULL elsewhere)
+static TM_THREAD_LOCAL long     tmStressPasses = 0;    // Passing assertions of a stress thread
+static TM_THREAD_LOCAL int      tmStressIndex = -1;    // Index of a stress thread (-1 elsewhere)
+
+//  Serializes assertion reports (output and result records) from concurrent threads
+static volatile long            tmReportLock = 0;
+
 /*********************************** Functions *********************************/
 
 /**
@@ -86,6 +162,14 @@ TM_UNUSED static void texit(int success) {
             sleep(300);
 #endif
     } else {
+        if (tmStressJump) {
+            longjmp(*tmStressJump, 1);
+        }
+#if TM_UNITY
+        if (tmUnityActive) {
+            longjmp(tmUnityJump, 1);
+        }
+#endif
         exit(1);
     }
 }
@@ -135,8 +219,184 @@ int thas(const char *key)
     return tgeti(key, 0);
 }
 
+/*
+    Quiet-pass mode state. When TESTME_QUIET_PASS is set, passing assertions only increment a counter
+    and a single "TESTME_PASSED=N" summary line is emitted at exit. Failures are always reported in full.
+ */
+static int  tmQuietPass = -1;
+static long tmPassCount = 0;
+
+/*
+    Structured result channel. When TESTME_RESULT_FILE is set, each reported assertion is also appended
+    to that file as one NDJSON record, so the runner counts results without scanning the output:
+        {"type":"assert","passed":true,"location":"math.tst.c@12","message":"...","time":1.250}
+    Time is in milliseconds since the first record. Quiet-pass mode writes {"type":"passed","count":N} at exit.
+    Records are buffered to keep a write per assertion off the hot path. The buffer is flushed when an
+    assertion fails, before a fork-server checkpoint forks and by exit(). A test that crashes can lose
+    buffered passing records, but it fails by its exit status regardless.
+ */
+static FILE     *tmResults = NULL;
+static int      tmResultsState = -1;
+static uint64_t tmResultsStarted = 0;
+
+TM_UNUSED static uint64_t tBenchNow(void);
+
+/**
+    Flush pending result records.
+ */
+TM_UNUSED static void tResultFlush(void)
+{
+    if (tmResults) {
+        fflush(tmResults);
+    }
+}
+
+/**
+    Get the result channel, opening it on first use.
+    @return Result file or NULL if TESTME_RESULT_FILE is not set.
+ */
+TM_UNUSED static FILE *tResultChannel(void)
+{
+    const char  *path;
+
+    if (tmResultsState < 0) {
+        tmResultsState = 0;
+        if ((path = getenv("TESTME_RESULT_FILE")) != 0 && *path) {
+            if ((tmResults = fopen(path, "a")) != 0) {
+                tmResultsStarted = tBenchNow();
+                tmResultsState = 1;
+            }
+        }
+    }
+    return tmResults;
+}
+
+/**
+    Write a string as a JSON string literal.
+    @param fp Output file.
+    @param str String to write. NULL is written as an empty string.
+ */
+TM_UNUSED static void tJsonString(FILE *fp, const char *str)
+{
+    const unsigned char *cp;
+
+    fputc('"', fp);
+    for (cp = (const unsigned char*) (str ? str : ""); *cp; cp++) {
+        if (*cp == '"' || *cp == '\\') {
+            fputc('\\', fp);
+            fputc(*cp, fp);
+        } else if (*cp < 0x20) {
+            fprintf(fp, "\\u%04x", *cp);
+        } else {
+            fputc(*cp, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+/**
+    Append an assertion record to the result channel (if enabled).
+    @param success Assertion outcome.
+    @param loc Assertion location.
+    @param message Assertion message.
+ */
+TM_UNUSED static void tResultRecord(int success, const char *loc, const char *message)
+{
+    FILE    *fp;
+
+    if ((fp = tResultChannel()) == 0) {
+        return;
+    }
+    fprintf(fp, "{\"type\":\"assert\",\"passed\":%s,\"location\":", success ? "true" : "false");
+    tJsonString(fp, loc);
+    fputs(",\"message\":", fp);
+    tJsonString(fp, message);
+    fprintf(fp, ",\"time\":%.3f}\n", (double) (tBenchNow() - tmResultsStarted) / 1e6);
+    if (!success) {
+        //  The failure may end the test through texit() or a debugger break
+        fflush(fp);
+    }
+}
+
+/**
+    Emit the quiet-pass summary line. Registered via atexit() when quiet-pass mode is enabled.
+ */
+TM_UNUSED static void tQuietSummary(void)
+{
+    FILE    *fp;
+
+    printf("TESTME_PASSED=%ld\n", tmPassCount);
+    fflush(stdout);
+    if ((fp = tResultChannel()) != 0) {
+        fprintf(fp, "{\"type\":\"passed\",\"count\":%ld}\n", tmPassCount);
+        fflush(fp);
+    }
+}
+
+/**
+    Test if passing assertions should be counted silently (TESTME_QUIET_PASS).
+    The environment is consulted once and the result cached.
+    @return 1 if quiet-pass mode is enabled, 0 otherwise.
+ */
+TM_UNUSED static int tQuietPass(void)
+{
+    const char  *value;
+
+    if (tmQuietPass < 0) {
+        value = getenv("TESTME_QUIET_PASS");
+        tmQuietPass = (value && *value && strcmp(value, "0") != 0) ? 1 : 0;
+#if !TM_UNITY
+        //  TM_TEST drivers emit the summary after each test file instead
+        if (tmQuietPass) {
+            atexit(tQuietSummary);
+        }
+#endif
+    }
+    return tmQuietPass;
+}
+
+/**
+    Count a passing assertion without reporting it, in quiet-pass mode and in tStress() threads.
+    @return 1 if the pass was counted and should not be reported, 0 otherwise.
+ */
+TM_UNUSED static int tSilentPass(void)
+{
+    if (tmStressJump) {
+        tmStressPasses++;
+        return 1;
+    }
+    if (tQuietPass()) {
+        tmPassCount++;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+    Acquire the report lock. Reports are short, so waiting threads yield instead of blocking.
+ */
+TM_UNUSED static void tReportLock(void)
+{
+    while (TM_ATOMIC_SWAP(&tmReportLock, 1)) {
+#if _WIN32
+        SwitchToThread();
+#else
+        sched_yield();
+#endif
+    }
+}
+
+/**
+    Release the report lock.
+ */
+TM_UNUSED static void tReportUnlock(void)
+{
+    TM_ATOMIC_SET(&tmReportLock, 0);
+}
+
 /**
     Emit a pass/fail message based on the success of the test.
+    Safe to call from several threads: reports are serialized.
     @param success The success of the test.
     @param loc The location of the test.
     @param fmt Message to emit
@@ -147,6 +407,9 @@ TM_UNUSED static void tReport(int success, const char *loc, const char *expected
     char        buf[TM_MAX_BUFFER];
     char        tmp[TM_MAX_BUFFER];
 
+    if (success && tSilentPass()) {
+        return;
+    }
     if (fmt && *fmt) {
         va_start(ap, fmt);
         vsnprintf(tmp, sizeof(tmp), fmt, ap);
@@ -163,14 +426,18 @@ TM_UNUSED static void tReport(int success, const char *loc, const char *expected
             snprintf(buf, sizeof(buf), "Test failed at %s", loc);
         }
     }
+    tReportLock();
+    tResultRecord(success, loc, buf);
     if (success) {
         printf("✓ %s\n", buf);
         fflush(stdout);
+        tReportUnlock();
     } else {
         if (!expected) expected = "(NULL)";
         if (!received) received = "(NULL)";
         fprintf(stderr, "✗ %s at %s\nExpected: %s\nReceived: %s\n", buf, loc, expected, received);
         fflush(stderr);
+        tReportUnlock();
         texit(success);
     }
 }
@@ -185,7 +452,9 @@ TM_UNUSED static void tReport(int success, const char *loc, const char *expected
     Helper macro for int comparisons, converting integers to strings for reporting
  */
 #define tReportInt(success, loc, received, expected, ...) \
-    if (1) { \
+    if ((success) && tSilentPass()) { \
+        /* Counted */ \
+    } else { \
         char ebuf[80], rbuf[80]; \
         snprintf(ebuf, sizeof(ebuf), "%d", (int)(expected)); \
         snprintf(rbuf, sizeof(rbuf), "%d", (int)(received)); \
@@ -196,7 +465,9 @@ TM_UNUSED static void tReport(int success, const char *loc, const char *expected
     Helper macro for long comparisons, converting to strings for reporting
  */
 #define tReportLong(success, loc, received, expected, ...) \
-    if (1) { \
+    if ((success) && tSilentPass()) { \
+        /* Counted */ \
+    } else { \
         char ebuf[80], rbuf[80]; \
         snprintf(ebuf, sizeof(ebuf), "%ld", (long)(expected)); \
         snprintf(rbuf, sizeof(rbuf), "%ld", (long)(received)); \
@@ -207,7 +478,9 @@ TM_UNUSED static void tReport(int success, const char *loc, const char *expected
     Helper macro for long long comparisons, converting to strings for reporting
  */
 #define tReportLongLong(success, loc, received, expected, ...) \
-    if (1) { \
+    if ((success) && tSilentPass()) { \
+        /* Counted */ \
+    } else { \
         char ebuf[80], rbuf[80]; \
         snprintf(ebuf, sizeof(ebuf), "%lld", (long long)(expected)); \
         snprintf(rbuf, sizeof(rbuf), "%lld", (long long)(received)); \
@@ -218,7 +491,9 @@ TM_UNUSED static void tReport(int success, const char *loc, const char *expected
     Helper macro for size_t/ptrdiff_t comparisons, converting to strings for reporting
  */
 #define tReportSize(success, loc, received, expected, ...) \
-    if (1) { \
+    if ((success) && tSilentPass()) { \
+        /* Counted */ \
+    } else { \
         char ebuf[80], rbuf[80]; \
         snprintf(ebuf, sizeof(ebuf), "%td", (ptrdiff_t)(expected)); \
         snprintf(rbuf, sizeof(rbuf), "%td", (ptrdiff_t)(received)); \
@@ -229,7 +504,9 @@ TM_UNUSED static void tReport(int success, const char *loc, const char *expected
     Helper macro for unsigned int comparisons, converting to strings for reporting
  */
 #define tReportUnsigned(success, loc, received, expected, ...) \
-    if (1) { \
+    if ((success) && tSilentPass()) { \
+        /* Counted */ \
+    } else { \
         char ebuf[80], rbuf[80]; \
         snprintf(ebuf, sizeof(ebuf), "%u", (unsigned int)(expected)); \
         snprintf(rbuf, sizeof(rbuf), "%u", (unsigned int)(received)); \
@@ -240,7 +517,9 @@ TM_UNUSED static void tReport(int success, const char *loc, const char *expected
     Helper macro for pointer comparisons, converting to strings for reporting
  */
 #define tReportPtr(success, loc, received, expected, ...) \
-    if (1) { \
+    if ((success) && tSilentPass()) { \
+        /* Counted */ \
+    } else { \
         char ebuf[80], rbuf[80]; \
         snprintf(ebuf, sizeof(ebuf), "%p", (void*)(expected)); \
         snprintf(rbuf, sizeof(rbuf), "%p", (void*)(received)); \
@@ -777,6 +1056,954 @@ static inline void twrite(const char *fmt, ...) {
                                 int _r = (E) != 0; \
                                 tReportString(_r, TM_LOC, "true", _r ? "true" : "false", __VA_ARGS__); \
                             } else
+/******************************** Benchmarking *******************************/
+
+//  Maximum number of timed samples per benchmark
+#define TM_BENCH_MAX_SAMPLES 100
+
+//  Default number of timed samples (override with TESTME_BENCH_SAMPLES)
+#define TM_BENCH_SAMPLES     20
+
+//  Default measurement time per benchmark in milliseconds (override with TESTME_BENCH_TIME)
+#define TM_BENCH_TIME        200
+
+//  Number of untimed warmup batches run after calibration
+#define TM_BENCH_WARMUP      2
+
+//  Benchmark phases
+#define TM_BENCH_INIT        0
+#define TM_BENCH_CALIBRATE   1
+#define TM_BENCH_WARM        2
+#define TM_BENCH_SAMPLE      3
+
+/**
+    Benchmark state used by tbench() and tBenchmark().
+    The iteration count per batch is calibrated so each timed sample runs for roughly
+    TESTME_BENCH_TIME / TESTME_BENCH_SAMPLES milliseconds.
+ */
+typedef struct TmBench {
+    const char  *name;                          // Benchmark name
+    int         phase;                          // Current phase (TM_BENCH_*)
+    int         count;                          // Batches completed in the current phase
+    int         samples;                        // Number of timed samples to collect
+    uint64_t    batch;                          // Iterations per batch
+    uint64_t    target;                         // Target nanoseconds per sample
+    uint64_t    started;                        // Start time of the current batch
+    uint64_t    iterations;                     // Total timed iterations
+    double      nsPerOp;                        // Mean nanoseconds per operation (set on completion)
+    double      times[TM_BENCH_MAX_SAMPLES];    // Nanoseconds per operation for each sample
+} TmBench;
+
+/**
+    Get a monotonic high-resolution timestamp.
+    Uses QueryPerformanceCounter on Windows and clock_gettime(CLOCK_MONOTONIC) elsewhere.
+    @return Time in nanoseconds from an arbitrary origin.
+ */
+TM_UNUSED static uint64_t tBenchNow(void)
+{
+#if _WIN32
+    static LARGE_INTEGER    freq;
+    LARGE_INTEGER           now;
+
+    if (freq.QuadPart == 0) {
+        QueryPerformanceFrequency(&freq);
+    }
+    QueryPerformanceCounter(&now);
+    return (uint64_t) (now.QuadPart / freq.QuadPart) * 1000000000ULL +
+        (uint64_t) (now.QuadPart % freq.QuadPart) * 1000000000ULL / (uint64_t) freq.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+#else
+    //  Fallback when POSIX clocks are not exposed (low resolution)
+    return (uint64_t) ((double) clock() * 1e9 / CLOCKS_PER_SEC);
+#endif
+}
+
+/**
+    Prevent the compiler from optimizing away a value computed in a benchmark.
+    @param value Value to keep alive. Must be an lvalue for portability with MSVC.
+    Example: int r = compute(); tDoNotOptimize(r);
+ */
+#if defined(__GNUC__) || defined(__clang__)
+    #define tDoNotOptimize(value) __asm__ __volatile__("" : : "r,m"(value) : "memory")
+#else
+    static const void * volatile tmBenchSink;
+    #define tDoNotOptimize(value) (tmBenchSink = (const void*) &(value))
+#endif
+
+/**
+    Initialize benchmark state.
+    @param name Benchmark name used in reports.
+    @return Initialized benchmark state.
+ */
+TM_UNUSED static TmBench tBenchBegin(const char *name)
+{
+    TmBench     bench;
+    int         time;
+
+    memset(&bench, 0, sizeof(bench));
+    bench.name = name ? name : "benchmark";
+    bench.phase = TM_BENCH_INIT;
+    bench.batch = 1;
+    bench.samples = tgeti("TESTME_BENCH_SAMPLES", TM_BENCH_SAMPLES);
+    if (bench.samples < 1) {
+        bench.samples = 1;
+    } else if (bench.samples > TM_BENCH_MAX_SAMPLES) {
+        bench.samples = TM_BENCH_MAX_SAMPLES;
+    }
+    time = tgeti("TESTME_BENCH_TIME", TM_BENCH_TIME);
+    if (time < 1) {
+        time = 1;
+    }
+    bench.target = (uint64_t) time * 1000000ULL / (uint64_t) bench.samples;
+    if (bench.target < 1000) {
+        bench.target = 1000;
+    }
+    return bench;
+}
+
+/**
+    Write a benchmark name as a JSON string.
+    @param name Name to write.
+ */
+TM_UNUSED static void tBenchWriteName(const char *name)
+{
+    tJsonString(stdout, name);
+}
+
+/**
+    Compute and emit benchmark statistics.
+    Prints a human readable summary and a machine readable "TESTME_BENCH {json}" record
+    that the runner collects from the test output.
+    @param bench Completed benchmark state.
+ */
+TM_UNUSED static void tBenchReport(TmBench *bench)
+{
+    double  *times, value, sum, mean, opsPerSec, p50, p90, p99;
+    int     i, j, n;
+
+    times = bench->times;
+    n = bench->count;
+
+    //  Insertion sort (n <= TM_BENCH_MAX_SAMPLES)
+    for (i = 1; i < n; i++) {
+        value = times[i];
+        for (j = i - 1; j >= 0 && times[j] > value; j--) {
+            times[j + 1] = times[j];
+        }
+        times[j + 1] = value;
+    }
+    for (sum = 0, i = 0; i < n; i++) {
+        sum += times[i];
+    }
+    mean = sum / n;
+    opsPerSec = mean > 0 ? 1e9 / mean : 0;
+
+    //  Nearest-rank percentiles
+    p50 = times[(int) ((n - 1) * 0.50 + 0.5)];
+    p90 = times[(int) ((n - 1) * 0.90 + 0.5)];
+    p99 = times[(int) ((n - 1) * 0.99 + 0.5)];
+    bench->nsPerOp = mean;
+
+    printf("bench %s: %.3f ns/op, %.0f ops/sec (p50 %.3f, p90 %.3f, p99 %.3f ns, %d samples x %llu iterations)\n",
+        bench->name, mean, opsPerSec, p50, p90, p99, n, (unsigned long long) bench->batch);
+    printf("TESTME_BENCH {\"name\":");
+    tBenchWriteName(bench->name);
+    printf(",\"nsPerOp\":%.3f,\"opsPerSec\":%.3f,\"min\":%.3f,\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,"
+        "\"max\":%.3f,\"samples\":%d,\"iterations\":%llu}\n",
+        mean, opsPerSec, times[0], p50, p90, p99, times[n - 1], n, (unsigned long long) bench->iterations);
+    fflush(stdout);
+}
+
+/**
+    Advance the benchmark state machine. Called before each batch of iterations.
+    Calibrates the batch size, runs warmup batches, then records timed samples.
+    @param bench Benchmark state from tBenchBegin().
+    @return 1 if another batch of bench->batch iterations should be run, 0 when complete.
+ */
+TM_UNUSED static int tBenchNext(TmBench *bench)
+{
+    uint64_t    elapsed;
+
+    elapsed = tBenchNow() - bench->started;
+
+    switch (bench->phase) {
+    case TM_BENCH_INIT:
+        bench->phase = TM_BENCH_CALIBRATE;
+        break;
+
+    case TM_BENCH_CALIBRATE:
+        if (elapsed >= bench->target || bench->batch >= (1ULL << 40)) {
+            //  Scale the batch so one sample takes about the target time
+            if (elapsed > 0) {
+                bench->batch = (uint64_t) ((double) bench->batch * (double) bench->target / (double) elapsed);
+            }
+            if (bench->batch < 1) {
+                bench->batch = 1;
+            }
+            bench->phase = TM_BENCH_WARM;
+            bench->count = 0;
+        } else if (elapsed * 10 < bench->target) {
+            bench->batch *= 10;
+        } else {
+            bench->batch *= 2;
+        }
+        break;
+
+    case TM_BENCH_WARM:
+        if (++bench->count >= TM_BENCH_WARMUP) {
+            bench->phase = TM_BENCH_SAMPLE;
+            bench->count = 0;
+        }
+        break;
+
+    case TM_BENCH_SAMPLE:
+        bench->times[bench->count++] = (double) elapsed / (double) bench->batch;
+        bench->iterations += bench->batch;
+        if (bench->count >= bench->samples) {
+            tBenchReport(bench);
+            return 0;
+        }
+        break;
+    }
+    bench->started = tBenchNow();
+    return 1;
+}
+
+/**
+    Benchmark a block of code. The block is run repeatedly and timed.
+    @param name Benchmark name used in reports.
+    Example: tbench("parse") { int r = parse(input); tDoNotOptimize(r); }
+ */
+#define tbench(name) \
+    for (TmBench _tmb = tBenchBegin(name); tBenchNext(&_tmb); ) \
+        for (uint64_t _tmi = 0; _tmi < _tmb.batch; _tmi++)
+
+/**
+    Benchmark a function.
+    @param name Benchmark name used in reports.
+    @param fn Function to benchmark. Called repeatedly with arg.
+    @param arg Argument passed to fn.
+    @return Mean nanoseconds per operation.
+    Example: tBenchmark("hash", hashOnce, &ctx);
+ */
+TM_UNUSED static double tBenchmark(const char *name, void (*fn)(void *arg), void *arg)
+{
+    TmBench     bench;
+    uint64_t    i;
+
+    bench = tBenchBegin(name);
+    while (tBenchNext(&bench)) {
+        for (i = 0; i < bench.batch; i++) {
+            fn(arg);
+        }
+    }
+    return bench.nsPerOp;
+}
+
+/**************************** Performance Counters ****************************/
+/*
+    tPerfBegin(name) / tPerfEnd() measure a region of code with hardware performance counters. On Linux,
+    perf_event_open counts the cycles, instructions, cache misses and branch misses of the calling thread
+    in user space. Elsewhere, or where counters are unavailable (containers, virtual machines,
+    kernel.perf_event_paranoid), only the elapsed time is recorded. Each region writes a
+    "TESTME_PERF {json}" record that the runner collects from the test output, like benchmarks.
+    Define TM_NO_PERF to record time only.
+ */
+
+//  Maximum depth of nested regions
+#define TM_PERF_DEPTH       8
+
+//  Number of hardware counters (cycles, instructions, cache misses, branch misses)
+#define TM_PERF_COUNTERS    4
+
+/**
+    Region started by tPerfBegin()
+ */
+typedef struct TmPerfRegion {
+    const char  *name;                          // Region name
+    int         counted;                        // Counters were read when the region started
+    uint64_t    started;                        // Start time in nanoseconds
+    uint64_t    enabled;                        // Counter group time enabled when the region started
+    uint64_t    running;                        // Counter group time running when the region started
+    uint64_t    values[TM_PERF_COUNTERS];       // Counter values when the region started (by group slot)
+} TmPerfRegion;
+
+/**
+    Performance counter state. Counters are opened by the first region of a process, so a forked child
+    (fork-server runs) opens its own.
+ */
+typedef struct TmPerf {
+    long            pid;                        // Process that opened the counters (0 if not opened)
+    int             leader;                     // Counter group leader descriptor or -1
+    int             fds[TM_PERF_COUNTERS];      // Counter descriptors or -1 if unavailable
+    int             slots[TM_PERF_COUNTERS];    // Position of each counter in a group read or -1
+    int             depth;                      // Number of open regions
+    TmPerfRegion    regions[TM_PERF_DEPTH];     // Open regions, innermost last
+} TmPerf;
+
+/**
+    Get the performance counter state.
+    @return Process-wide counter state.
+ */
+TM_UNUSED static TmPerf *tPerfState(void)
+{
+    static TmPerf   perf;
+
+    return &perf;
+}
+
+/**
+    Get the JSON name of a counter.
+    @param counter Counter index.
+    @return Name used in TESTME_PERF records.
+ */
+TM_UNUSED static const char *tPerfCounterName(int counter)
+{
+    switch (counter) {
+    case 0: return "cycles";
+    case 1: return "instructions";
+    case 2: return "cacheMisses";
+    default: return "branchMisses";
+    }
+}
+
+#if TM_PERF
+/**
+    Open the hardware counters as one group so they are scheduled together.
+    Counters the CPU or kernel does not provide are skipped. Other counters still count.
+    @param perf Counter state.
+ */
+TM_UNUSED static void tPerfOpen(TmPerf *perf)
+{
+    struct perf_event_attr  attr;
+    uint64_t                configs[TM_PERF_COUNTERS];
+    unsigned long           flags;
+    int                     i, fd, slot;
+
+    //  Descriptors inherited from a parent process count the parent's thread
+    for (i = 0; perf->pid && i < TM_PERF_COUNTERS; i++) {
+        if (perf->fds[i] >= 0) {
+            close(perf->fds[i]);
+        }
+    }
+    configs[0] = PERF_COUNT_HW_CPU_CYCLES;
+    configs[1] = PERF_COUNT_HW_INSTRUCTIONS;
+    configs[2] = PERF_COUNT_HW_CACHE_MISSES;
+    configs[3] = PERF_COUNT_HW_BRANCH_MISSES;
+#ifdef PERF_FLAG_FD_CLOEXEC
+    flags = PERF_FLAG_FD_CLOEXEC;
+#else
+    flags = 0;
+#endif
+    perf->pid = (long) getpid();
+    perf->leader = -1;
+    for (i = 0, slot = 0; i < TM_PERF_COUNTERS; i++) {
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[i];
+        attr.disabled = perf->leader < 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        fd = (int) syscall(__NR_perf_event_open, &attr, 0, -1, perf->leader, flags);
+        perf->fds[i] = fd;
+        perf->slots[i] = fd >= 0 ? slot++ : -1;
+        if (fd >= 0 && perf->leader < 0) {
+            perf->leader = fd;
+        }
+    }
+    if (perf->leader >= 0) {
+        ioctl(perf->leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(perf->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+/**
+    Read the counter group.
+    @param perf Counter state.
+    @param values Receives the counter values by group slot.
+    @param enabled Receives the time the group has been enabled.
+    @param running Receives the time the group has been counting (less than enabled when multiplexed).
+    @return 1 if the counters were read, 0 if they are unavailable.
+ */
+TM_UNUSED static int tPerfRead(TmPerf *perf, uint64_t *values, uint64_t *enabled, uint64_t *running)
+{
+    uint64_t    data[3 + TM_PERF_COUNTERS];
+    uint64_t    i;
+
+    if (perf->leader < 0 || read(perf->leader, data, sizeof(data)) < (ssize_t) (3 * sizeof(uint64_t))) {
+        return 0;
+    }
+    *enabled = data[1];
+    *running = data[2];
+    for (i = 0; i < data[0] && i < TM_PERF_COUNTERS; i++) {
+        values[i] = data[3 + i];
+    }
+    return 1;
+}
+#endif /* TM_PERF */
+
+/**
+    Start a measured region. Regions may nest up to TM_PERF_DEPTH deep and must be ended by tPerfEnd().
+    @param name Region name used in reports. Records of regions with the same name are combined by the runner.
+    Example: tPerfBegin("parse"); parse(input); tPerfEnd();
+ */
+TM_UNUSED static void tPerfBegin(const char *name)
+{
+    TmPerf          *perf;
+    TmPerfRegion    *region;
+
+    perf = tPerfState();
+    if (perf->depth++ >= TM_PERF_DEPTH) {
+        return;
+    }
+    region = &perf->regions[perf->depth - 1];
+    region->name = name ? name : "region";
+    region->counted = 0;
+#if TM_PERF
+    if (perf->pid != (long) getpid()) {
+        tPerfOpen(perf);
+    }
+    region->counted = tPerfRead(perf, region->values, &region->enabled, &region->running);
+#endif
+    region->started = tBenchNow();
+}
+
+/**
+    End the innermost region started by tPerfBegin() and write its "TESTME_PERF {json}" record.
+    The record has the elapsed nanoseconds and each available counter. Counters are scaled by the time
+    the group was enabled over the time it was counting, when the kernel multiplexed them.
+ */
+TM_UNUSED static void tPerfEnd(void)
+{
+    TmPerf          *perf;
+    TmPerfRegion    *region;
+    uint64_t        elapsed;
+
+    perf = tPerfState();
+    if (perf->depth <= 0 || --perf->depth >= TM_PERF_DEPTH) {
+        return;
+    }
+    region = &perf->regions[perf->depth];
+    elapsed = tBenchNow() - region->started;
+    printf("TESTME_PERF {\"name\":");
+    tJsonString(stdout, region->name);
+    printf(",\"ns\":%llu", (unsigned long long) elapsed);
+#if TM_PERF
+    {
+        uint64_t    values[TM_PERF_COUNTERS], enabled, running;
+        double      scale;
+        int         i, slot;
+
+        if (region->counted && tPerfRead(perf, values, &enabled, &running) && running > region->running) {
+            scale = (double) (enabled - region->enabled) / (double) (running - region->running);
+            for (i = 0; i < TM_PERF_COUNTERS; i++) {
+                if ((slot = perf->slots[i]) >= 0) {
+                    printf(",\"%s\":%.0f", tPerfCounterName(i), (double) (values[slot] - region->values[slot]) * scale);
+                }
+            }
+        }
+    }
+#endif
+    printf("}\n");
+    fflush(stdout);
+}
+
+/*********************************** Stress ***********************************/
+/*
+    tStress(fn, arg, threads) runs a test body on several threads at once to expose races and lock
+    contention. Each thread calls fn(arg) repeatedly for TESTME_DURATION seconds (tm --duration) or, if no
+    duration is set, TESTME_ITERATIONS times (tm --iterations). Assertions may be used in fn: passes are
+    counted silently per thread, and the first failure is reported (serialized with other threads) and
+    stops every thread. A summary with the total throughput is reported when all threads finish.
+ */
+
+//  Maximum number of stress threads
+#define TM_STRESS_MAX_THREADS   256
+
+//  Iterations between duration checks
+#define TM_STRESS_CHECK         64
+
+/**
+    State shared by the threads of a tStress() run
+ */
+typedef struct TmStress {
+    void            (*fn)(void *arg);           // Test body
+    void            *arg;                       // Argument passed to fn
+    int64_t         iterations;                 // Iterations per thread when no duration is set
+    uint64_t        deadline;                   // End time from tBenchNow(), or 0 to run iterations
+    volatile long   failures;                   // Threads stopped by a failed assertion
+    volatile long   stop;                       // Set by the first failure to stop every thread
+} TmStress;
+
+/**
+    Thread handle of a stress thread
+ */
+#if _WIN32
+typedef HANDLE TmThread;
+#else
+typedef pthread_t TmThread;
+#endif
+
+/**
+    One tStress() thread
+ */
+typedef struct TmStressWorker {
+    TmStress    *stress;                        // Shared state
+    int         index;                          // Thread index returned by tStressThread()
+    int64_t     iterations;                     // Iterations completed by this thread
+    long        passes;                         // Passing assertions counted by this thread
+    char        pad[64];                        // Keep each thread's counters on their own cache line
+} TmStressWorker;
+
+/**
+    Get the index of the calling stress thread.
+    @return Index from 0 to threads - 1, or -1 outside tStress().
+ */
+TM_UNUSED static int tStressThread(void)
+{
+    return tmStressIndex;
+}
+
+/**
+    Get the number of online CPU cores.
+    @return Core count, at least 1.
+ */
+TM_UNUSED static int tStressCpus(void)
+{
+#if _WIN32
+    SYSTEM_INFO     info;
+
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int) info.dwNumberOfProcessors : 1;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long    count;
+
+    count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int) count : 1;
+#else
+    return 1;
+#endif
+}
+
+/**
+    Run the test body until the duration or iteration count is reached or another thread fails.
+    @param worker Stress thread.
+ */
+TM_UNUSED static void tStressLoop(TmStressWorker *worker)
+{
+    TmStress    *stress;
+
+    stress = worker->stress;
+    while (!TM_ATOMIC_GET(&stress->stop)) {
+        if (stress->deadline) {
+            if (worker->iterations % TM_STRESS_CHECK == 0 && tBenchNow() >= stress->deadline) {
+                break;
+            }
+        } else if (worker->iterations >= stress->iterations) {
+            break;
+        }
+        stress->fn(stress->arg);
+        worker->iterations++;
+    }
+}
+
+/**
+    Run a stress thread. A failed assertion in the test body returns here through texit().
+    @param worker Stress thread.
+ */
+TM_UNUSED static void tStressWork(TmStressWorker *worker)
+{
+    jmp_buf     jump;
+
+    tmStressIndex = worker->index;
+    tmStressPasses = 0;
+    tmStressJump = &jump;
+    if (setjmp(jump) == 0) {
+        tStressLoop(worker);
+    } else {
+        TM_ATOMIC_ADD(&worker->stress->failures, 1);
+        TM_ATOMIC_SET(&worker->stress->stop, 1);
+    }
+    tmStressJump = NULL;
+    tmStressIndex = -1;
+    worker->passes = tmStressPasses;
+}
+
+#if _WIN32
+TM_UNUSED static DWORD WINAPI tStressMain(LPVOID data)
+{
+    tStressWork((TmStressWorker*) data);
+    return 0;
+}
+#else
+TM_UNUSED static void *tStressMain(void *data)
+{
+    tStressWork((TmStressWorker*) data);
+    return NULL;
+}
+#endif
+
+/**
+    Run a test body concurrently on several threads.
+    On POSIX, link with -lpthread if the C library does not include threads (glibc before 2.34).
+    @param fn Test body. Called repeatedly with arg on every thread. Use tStressThread() for the thread index.
+    @param arg Argument passed to fn.
+    @param threads Number of threads. Zero or less uses one thread per CPU core.
+    @return Total iterations completed by all threads.
+    Example: tStress(pushPop, &queue, 8);
+ */
+TM_UNUSED static int64_t tStress(void (*fn)(void *arg), void *arg, int threads)
+{
+    TmStress        stress;
+    TmStressWorker  *workers;
+    const char      *duration;
+    uint64_t        started;
+    int64_t         total;
+    double          seconds;
+    long            passes;
+    int             i, running;
+    TmThread        *handles;
+
+    if (threads <= 0) {
+        threads = tStressCpus();
+    } else if (threads > TM_STRESS_MAX_THREADS) {
+        threads = TM_STRESS_MAX_THREADS;
+    }
+    memset(&stress, 0, sizeof(stress));
+    stress.fn = fn;
+    stress.arg = arg;
+    stress.iterations = tgeti("TESTME_ITERATIONS", 1);
+    if (stress.iterations < 1) {
+        stress.iterations = 1;
+    }
+
+    //  Initialize state created on first use before the threads share it
+    tQuietPass();
+    tResultChannel();
+
+    workers = (TmStressWorker*) calloc((size_t) threads, sizeof(TmStressWorker));
+    handles = (TmThread*) calloc((size_t) threads, sizeof(TmThread));
+    if (!workers || !handles) {
+        free(workers);
+        free(handles);
+        tReport(0, "tStress", "memory", "none", "Cannot allocate %d stress threads", threads);
+        return 0;
+    }
+    started = tBenchNow();
+    if ((duration = getenv("TESTME_DURATION")) != 0 && atof(duration) > 0) {
+        stress.deadline = started + (uint64_t) (atof(duration) * 1e9);
+    }
+    for (i = 0; i < threads; i++) {
+        workers[i].stress = &stress;
+        workers[i].index = i;
+#if _WIN32
+        if ((handles[i] = CreateThread(NULL, 0, tStressMain, &workers[i], 0, NULL)) == NULL) {
+            break;
+        }
+#else
+        if (pthread_create(&handles[i], NULL, tStressMain, &workers[i]) != 0) {
+            break;
+        }
+#endif
+    }
+    running = i;
+    if (running < threads) {
+        //  Stop the threads already running: the run is reported as failed below
+        TM_ATOMIC_SET(&stress.stop, 1);
+    }
+    for (i = 0; i < running; i++) {
+#if _WIN32
+        WaitForSingleObject(handles[i], INFINITE);
+        CloseHandle(handles[i]);
+#else
+        pthread_join(handles[i], NULL);
+#endif
+    }
+    seconds = (double) (tBenchNow() - started) / 1e9;
+
+    for (total = 0, passes = 0, i = 0; i < running; i++) {
+        total += workers[i].iterations;
+        passes += workers[i].passes;
+    }
+    free(workers);
+    free(handles);
+    if (tQuietPass()) {
+        tmPassCount += passes;
+    }
+    printf("stress: %d threads, %lld iterations in %.3fs (%.0f iterations/sec), %ld assertions passed, %ld failed\n",
+        running, (long long) total, seconds, seconds > 0 ? (double) total / seconds : 0.0, passes,
+        stress.failures);
+    fflush(stdout);
+
+    if (running < threads) {
+        tReport(0, "tStress", "threads started", "thread creation failed", "Cannot start stress thread %d of %d",
+            running + 1, threads);
+    } else {
+        tReport(stress.failures == 0, "tStress", "no failures", "assertion failed",
+            "Stress test: %d threads, %lld iterations", threads, (long long) total);
+    }
+    return total;
+}
+
+/************************************ Unity ***********************************/
+/*
+    Tests may be written as TM_TEST(name) { ... } functions instead of main(). TestMe compiles
+    such files through a generated driver that defines TM_UNITY and calls tUnityMain(). With
+    compiler.c.unity, all TM_TEST files in a directory are compiled into one driver binary.
+    TM_UNIT prefixes the function names so equal test names in different files do not collide.
+ */
+#ifndef TM_UNIT
+    #define TM_UNIT tm_test_
+#endif
+#define TM_TEST_FN2(unit, name) unit##name
+#define TM_TEST_FN(unit, name)  TM_TEST_FN2(unit, name)
+#define TM_TEST(name)           TM_UNUSED static void TM_TEST_FN(TM_UNIT, name)(void)
+
+#if TM_UNITY
+/**
+    Test function registered in a generated driver
+ */
+typedef struct TmUnityTest {
+    const char  *file;          /**< Test file base name */
+    const char  *name;          /**< Test function name */
+    void        (*fn)(void);    /**< Test function */
+} TmUnityTest;
+
+/**
+    Test if a test was selected on the command line.
+    @param test Test to check.
+    @param argc Argument count. With no arguments, all tests are selected.
+    @param argv Arguments: file names ("math.tst.c"), test names ("add") or both ("math.tst.c:add").
+    @return 1 if the test should run.
+ */
+TM_UNUSED static int tUnitySelected(const TmUnityTest *test, int argc, char **argv)
+{
+    char    qualified[TM_MAX_BUFFER];
+    int     i;
+
+    if (argc <= 1) {
+        return 1;
+    }
+    snprintf(qualified, sizeof(qualified), "%s:%s", test->file, test->name);
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], test->file) == 0 || strcmp(argv[i], test->name) == 0 ||
+                strcmp(argv[i], qualified) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#if !_WIN32
+/**
+    End a driver whose current test file exceeded TESTME_UNITY_TIMEOUT (SIGALRM handler).
+    Exit status 142 (128 + SIGALRM) tells TestMe the file timed out. Only async-signal-safe calls are used.
+ */
+TM_UNUSED static void tUnityTimeout(int sig)
+{
+    static const char   msg[] = "\nTest file timed out\n";
+
+    (void) sig;
+    if (write(1, msg, sizeof(msg) - 1) < 0) {
+        //  Nothing more can be reported
+    }
+    _exit(142);
+}
+#endif
+
+/**
+    Run the selected tests of a driver, one test file at a time.
+    Output for each file is framed by TESTME_UNITY_BEGIN and TESTME_UNITY_END lines so TestMe can
+    report every file separately. Stderr is merged into stdout to keep the framing in order.
+    TESTME_UNITY_TIMEOUT sets the time limit of each test file in seconds (POSIX only).
+    @param tests Tests grouped by file.
+    @param count Number of tests.
+    @param argc Argument count.
+    @param argv Test selection (see tUnitySelected).
+    @return Zero if all selected tests passed.
+ */
+TM_UNUSED static int tUnityMain(const TmUnityTest *tests, size_t count, int argc, char **argv)
+{
+    const char  *file;
+    FILE        *fp;
+    uint64_t    started;
+    size_t      i, j, k;
+    int         failed, selected, status, timeout;
+
+    fflush(stdout);
+    fflush(stderr);
+#if _WIN32
+    _dup2(_fileno(stdout), _fileno(stderr));
+    timeout = 0;
+#else
+    dup2(fileno(stdout), fileno(stderr));
+    timeout = getenv("TESTME_UNITY_TIMEOUT") ? atoi(getenv("TESTME_UNITY_TIMEOUT")) : 0;
+    if (timeout > 0) {
+        signal(SIGALRM, tUnityTimeout);
+    }
+#endif
+    status = 0;
+    for (i = 0; i < count; i = j) {
+        file = tests[i].file;
+        selected = 0;
+        for (j = i; j < count && strcmp(tests[j].file, file) == 0; j++) {
+            selected |= tUnitySelected(&tests[j], argc, argv);
+        }
+        if (!selected) {
+            continue;
+        }
+        printf("TESTME_UNITY_BEGIN %s\n", file);
+        fflush(stdout);
+        started = tBenchNow();
+        failed = 0;
+#if !_WIN32
+        if (timeout > 0) {
+            alarm((unsigned) timeout);
+        }
+#endif
+        for (k = i; k < j; k++) {
+            if (tUnitySelected(&tests[k], argc, argv)) {
+                tmUnityActive = 1;
+                if (setjmp(tmUnityJump) == 0) {
+                    tests[k].fn();
+                } else {
+                    failed = 1;
+                }
+                tmUnityActive = 0;
+            }
+        }
+#if !_WIN32
+        alarm(0);
+#endif
+        fflush(stdout);
+        fflush(stderr);
+        if (tQuietPass()) {
+            printf("TESTME_PASSED=%ld\n", tmPassCount);
+            if ((fp = tResultChannel()) != 0) {
+                fprintf(fp, "{\"type\":\"passed\",\"count\":%ld}\n", tmPassCount);
+            }
+            tmPassCount = 0;
+        }
+        printf("TESTME_UNITY_END %s %d %.3f\n", file, failed, (double) (tBenchNow() - started) / 1e6);
+        fflush(stdout);
+        status |= failed;
+    }
+    return status;
+}
+#endif /* TM_UNITY */
+
+/********************************* Fork Server ********************************/
+/*
+    Fork-server mode (execution.forkServer). When TESTME_FORK_SERVER is set, the test process stops
+    at a checkpoint and forks a fresh child for each "run" command read from stdin. The child returns
+    from the checkpoint and runs the test, so repeated runs skip exec, dynamic loading and startup
+    work done before the checkpoint. After each child exits, the server writes a TESTME_FORK_EXIT
+    line with the child's exit status to stdout and stderr. TESTME_FORK_SERVER holds the per-run
+    timeout in seconds, enforced in the child with alarm(). The server removes TESTME_FORK_SERVER from
+    the environment before the first fork, so other checkpoints in the process (a second translation
+    unit) and programs the test runs do not become fork servers themselves.
+
+    The checkpoint runs automatically before main(). Define TM_FORK_CHECKPOINT before including
+    testme.h to call tForkServer() later instead, e.g. after expensive one-time setup in main().
+ */
+#if !_WIN32
+/**
+    Read one command line from the runner without stdio buffering (the child must not inherit unread input).
+    @param buf Command buffer.
+    @param size Size of buf.
+    @return 1 if a command was read, 0 at end of input.
+ */
+TM_UNUSED static int tForkCommand(char *buf, size_t size)
+{
+    size_t  len;
+    ssize_t rc;
+    char    c;
+
+    for (len = 0; ; ) {
+        rc = read(0, &c, 1);
+        if (rc < 0 && errno == EINTR) {
+            continue;
+        }
+        if (rc <= 0) {
+            return 0;
+        }
+        if (c == '\n') {
+            break;
+        }
+        if (len + 1 < size) {
+            buf[len++] = c;
+        }
+    }
+    buf[len] = '\0';
+    return 1;
+}
+
+/**
+    Enter fork-server mode if requested by the runner.
+    Returns immediately in a normal run. In fork-server mode, only forked children return; the
+    server exits when the runner closes stdin or sends "quit".
+ */
+TM_UNUSED static void tForkServer(void)
+{
+    char    command[32], *value;
+    pid_t   pid;
+    int     fd, status, code, timeout;
+
+    //  The environment is process-wide: once removed, every later checkpoint returns immediately
+    if ((value = getenv("TESTME_FORK_SERVER")) == NULL) {
+        return;
+    }
+    timeout = atoi(value);
+    unsetenv("TESTME_FORK_SERVER");
+    fflush(stdout);
+    fflush(stderr);
+    //  Children must not inherit (and re-write) records buffered before the checkpoint
+    tResultFlush();
+    while (tForkCommand(command, sizeof(command)) && strcmp(command, "run") == 0) {
+        if ((pid = fork()) < 0) {
+            fprintf(stderr, "Cannot fork test process\n");
+            exit(2);
+        }
+        if (pid == 0) {
+            if ((fd = open("/dev/null", O_RDONLY)) >= 0) {
+                dup2(fd, 0);
+                close(fd);
+            }
+            if (timeout > 0) {
+                alarm((unsigned) timeout);
+            }
+            return;
+        }
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+        }
+        code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+        printf("\nTESTME_FORK_EXIT %d\n", code);
+        fflush(stdout);
+        fprintf(stderr, "\nTESTME_FORK_EXIT %d\n", code);
+        fflush(stderr);
+    }
+    exit(0);
+}
+
+#if !defined(TM_FORK_CHECKPOINT) && (defined(__GNUC__) || defined(__clang__))
+/**
+    Automatic checkpoint before main()
+ */
+__attribute__((constructor)) static void tForkServerInit(void)
+{
+    tForkServer();
+}
+#endif
+#else
+#define tForkServer()
+#endif /* !_WIN32 */
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,7 +3,7 @@
     Provides a familiar testing API while using TestMe's infrastructure
 */
 
-import {getStack, isInTestContext} from './index.js'
+import {getStack, isInTestContext, tnotify} from './index.js'
 
 /**
     Deep equality comparison for objects, arrays, and primitives
@@ -251,10 +251,12 @@ class ExpectMatcher {
     */
     createResult(name, pass, message) {
         const success = this.isNot ? !pass : pass
-        if (!success) {
+        const prefix = this.isNot ? 'not ' : ''
+        if (success) {
+            tnotify('assert', true, {message: `expect(...).${prefix}${name}`})
+        } else {
             const stack = getStack()
             const loc = `${stack.filename}:${stack.line}`
-            const prefix = this.isNot ? 'not ' : ''
             const errorMsg = `${message} at ${loc}\n   Matcher: expect(...).${prefix}${name}`
 
             //  If we're inside a test() block, throw an error so test() can catch it
@@ -262,6 +264,7 @@ class ExpectMatcher {
             if (isInTestContext()) {
                 throw new Error(errorMsg)
             } else {
+                tnotify('assert', false, {location: loc, message})
                 console.error(`✗ ${message} at ${loc}`)
                 console.error(`   Matcher: expect(...).${prefix}${name}`)
                 process.exit(1)
@@ -9,6 +9,7 @@
 
 //  Import Jest/Vitest-compatible expect() API
 import {expect} from './expect.js'
+import {openSync, writeSync} from 'fs'
 
 let exitCode = 0
 let testContext = {
@@ -24,6 +25,60 @@ let testContext = {
     queuedTests: [],
     inTest: false,
     collectingTests: false,
+    running: 0,
+}
+
+//  Hooks installed by tm when the test runs in-process on a worker thread (execution.inProcess)
+//  Results are sent as structured messages and tm waits until all describe() and test() calls finish
+const tm = globalThis.__testme
+if (tm) {
+    tm.active = () => testContext.running
+    tm.exitCode = () => exitCode
+}
+
+//  Structured result channel (TESTME_RESULT_FILE): one NDJSON record per assertion and test() block
+//  Records are written synchronously so they survive the immediate exit on a failed assertion
+let resultFd
+const resultStarted = performance.now()
+
+function tchannel() {
+    if (resultFd === undefined) {
+        const path = process.env.TESTME_RESULT_FILE
+        resultFd = null
+        if (path) {
+            try {
+                resultFd = openSync(path, 'a')
+            } catch {
+                //  Fall back to counting markers in the output
+            }
+        }
+    }
+    return resultFd
+}
+
+/**
+    Report a structured assertion or test result to tm
+    @param type 'assert' or 'test'
+    @param passed Result outcome
+    @param details Optional location, message or test name
+*/
+export function tnotify(type, passed, details = {}) {
+    tm?.notify({type, passed})
+    const fd = tchannel()
+    if (fd !== null) {
+        const time = Math.round((performance.now() - resultStarted) * 1000) / 1000
+        writeSync(fd, JSON.stringify({type, passed, ...details, time}) + '\n')
+    }
+}
+
+function tbegin() {
+    testContext.running++
+}
+
+function tend() {
+    if (--testContext.running === 0) {
+        tm?.idle?.()
+    }
 }
 
 function tdepth() {
@@ -132,6 +187,7 @@ function treport(success, stack, message, received, expected) {
     if (!message) {
         message = `Test ${success ? 'passed' : 'failed'}`
     }
+    tnotify('assert', success, {location: loc, message})
     if (success) {
         console.log(`✓ ${message} at ${loc}`)
     } else {
@@ -326,6 +382,18 @@ function getIndent() {
     @param {Function} fn - Function containing tests
 */
 async function describe(name, fn) {
+    tbegin()
+    try {
+        await runDescribe(name, fn)
+    } finally {
+        tend()
+    }
+}
+
+/**
+    Internal function to run a describe block
+*/
+async function runDescribe(name, fn) {
     const indent = getIndent()
     console.log(`${indent}${name}`)
 
@@ -441,7 +509,12 @@ async function test(name, fn) {
         })
     } else {
         //  Run immediately if not in a describe block
-        await runTest(name, fn, indent)
+        tbegin()
+        try {
+            await runTest(name, fn, indent)
+        } finally {
+            tend()
+        }
     }
 }
 
@@ -484,12 +557,14 @@ async function runTest(name, fn, indent) {
         }
 
         testContext.passedTests++
+        tnotify('test', true, {name})
         console.log(`${indent}✓ ${name}`)
     } catch (error) {
         //  Clear test context flag on error
         testContext.inTest = false
 
         testContext.failedTests++
+        tnotify('test', false, {name})
         console.error(`${indent}✗ ${name}`)
 
         //  Try to extract a better location from the error stack if message shows "unknown file"
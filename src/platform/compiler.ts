@@ -23,6 +23,32 @@ export interface CompilerConfig {
     }
 }
 
+/*
+ Instrumentation of a C test build (compiler.c.sanitize, compiler.c.coverage, --sanitize and --coverage)
+ */
+export interface Instrumentation {
+    sanitize: string[] // Sanitizers, sorted and without duplicates
+    coverage: boolean // Line coverage (gcov data on GCC, source-based coverage on Clang)
+}
+
+// Sanitizers and their short names in variant binary names
+const SANITIZERS: Record<string, string> = {
+    address: 'asan',
+    leak: 'lsan',
+    memory: 'msan',
+    thread: 'tsan',
+    undefined: 'ubsan',
+}
+
+// Sanitizers that cannot be linked into the same binary
+const SANITIZER_CONFLICTS = [
+    ['address', 'thread'],
+    ['address', 'memory'],
+    ['leak', 'thread'],
+    ['leak', 'memory'],
+    ['memory', 'thread'],
+]
+
 export interface CompileResult {
     success: boolean
     outputPath: string
@@ -527,4 +553,113 @@ export class CompilerManager {
             })
         }
     }
+
+    /*
+     Validates and normalizes build instrumentation
+     @param sanitize Sanitizer names (address, undefined, thread, leak, memory)
+     @param coverage Collect line coverage
+     @returns Instrumentation, or undefined for a plain build
+     @throws Error for unknown or conflicting sanitizers
+     */
+    static getInstrumentation(sanitize: string[] = [], coverage = false): Instrumentation | undefined {
+        const names = [...new Set(sanitize.map((name) => name.trim().toLowerCase()).filter(Boolean))].sort()
+        const unknown = names.filter((name) => !SANITIZERS[name])
+        if (unknown.length > 0) {
+            throw new Error(
+                `Unknown sanitizer ${unknown.join(', ')} (expected: ${Object.keys(SANITIZERS).join(', ')})`
+            )
+        }
+        const conflict = SANITIZER_CONFLICTS.find(([a, b]) => names.includes(a!) && names.includes(b!))
+        if (conflict) {
+            throw new Error(`The ${conflict[0]} and ${conflict[1]} sanitizers cannot be combined`)
+        }
+        if (names.length === 0 && !coverage) {
+            return undefined
+        }
+        return {sanitize: names, coverage}
+    }
+
+    /*
+     Gets the name of an instrumented build variant
+     Instrumented binaries are named after their variant (math-asan-ubsan), so plain and instrumented
+     builds of a test are cached side by side and switching profiles never forces a rebuild
+     @param instrumentation Build instrumentation
+     @returns Variant name such as asan-ubsan or cov
+     */
+    static getVariantName(instrumentation: Instrumentation): string {
+        const parts = instrumentation.sanitize.map((name) => SANITIZERS[name]!)
+        if (instrumentation.coverage) {
+            parts.push('cov')
+        }
+        return parts.join('-')
+    }
+
+    /*
+     Gets the compiler and linker flags for build instrumentation
+     @param type Compiler type
+     @param instrumentation Build instrumentation
+     @returns Flags added after the configured flags (compile and link in one step)
+     @throws Error if the compiler does not support the instrumentation
+     */
+    static getInstrumentFlags(type: CompilerType, instrumentation: Instrumentation): string[] {
+        const {sanitize, coverage} = instrumentation
+        const flags: string[] = []
+
+        if (type === CompilerType.MSVC) {
+            // MSVC only has AddressSanitizer and no coverage instrumentation
+            const unsupported = sanitize.filter((name) => name !== 'address')
+            if (unsupported.length > 0 || coverage) {
+                throw new Error(
+                    `MSVC does not support ${[...unsupported, ...(coverage ? ['coverage'] : [])].join(', ')}`
+                )
+            }
+            if (sanitize.length > 0) {
+                flags.push('/fsanitize=address', '/Zi')
+            }
+            return flags
+        }
+        if (type === CompilerType.Unknown) {
+            throw new Error('Sanitizers and coverage require GCC, Clang or MSVC')
+        }
+        if (sanitize.includes('memory') && type !== CompilerType.Clang) {
+            throw new Error('The memory sanitizer requires Clang')
+        }
+        if (sanitize.length > 0) {
+            // Keep frame pointers for stack traces, and fail on the first report of any sanitizer
+            flags.push(`-fsanitize=${sanitize.join(',')}`, '-fno-omit-frame-pointer', '-fno-sanitize-recover=all')
+        }
+        if (coverage) {
+            if (type === CompilerType.Clang) {
+                flags.push('-fprofile-instr-generate', '-fcoverage-mapping')
+            } else {
+                flags.push('--coverage')
+            }
+        }
+        return flags
+    }
+
+    /*
+     Gets the runtime options of the sanitizers in a build
+     Reports include stack traces, and TSan stops at the first data race like the other sanitizers
+     (built with -fno-sanitize-recover). Options already set in the test environment are kept.
+     @param instrumentation Build instrumentation
+     @param env Test environment
+     @returns Sanitizer option variables to add to the environment
+     */
+    static getSanitizerEnvironment(
+        instrumentation: Instrumentation,
+        env: Record<string, string>
+    ): Record<string, string> {
+        const options: Record<string, string> = {}
+        const defaults: [string, string, string][] = [
+            ['undefined', 'UBSAN_OPTIONS', 'print_stacktrace=1'],
+            ['thread', 'TSAN_OPTIONS', 'halt_on_error=1'],
+        ]
+        for (const [sanitizer, name, value] of defaults) {
+            if (instrumentation.sanitize.includes(sanitizer) && env[name] === undefined && !process.env[name]) {
+                options[name] = value
+            }
+        }
+        return options
+    }
 }
@@ -5,6 +5,7 @@
 
 import {join} from 'path'
 import {readdir} from 'fs/promises'
+import os from 'os'
 
 // Cache for findInPath results to avoid repeated subprocess spawns
 const findInPathCache = new Map<string, string | null>()
@@ -139,6 +140,23 @@ export class PlatformDetector {
         return this.isMacOS() || this.isLinux()
     }
 
+    /*
+     Gets the number of CPU cores available to this process
+     @returns Core count (at least 1)
+     */
+    static getCpuCount(): number {
+        const count = typeof os.availableParallelism === 'function' ? os.availableParallelism() : os.cpus().length
+        return Math.max(1, count || 1)
+    }
+
+    /*
+     Gets the free system memory
+     @returns Free memory in megabytes
+     */
+    static getFreeMemory(): number {
+        return Math.floor(os.freemem() / (1024 * 1024))
+    }
+
     /*
      Detects all available C compilers on the system
      @returns Promise resolving to array of compiler information
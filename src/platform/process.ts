@@ -20,6 +20,56 @@ export class ProcessManager {
         }
     }
 
+    /*
+     Kills a process and all its descendants immediately (no graceful shutdown)
+     On Unix, each process is stopped as it is found so it cannot start more children, then all are killed.
+     @param pid Process ID of the tree root
+     @returns Promise that resolves when the kill signals have been sent
+     */
+    static async killProcessTree(pid: number): Promise<void> {
+        if (PlatformDetector.isWindows()) {
+            return this.killProcessWindows(pid, false)
+        }
+        const tree = [pid]
+        for (let i = 0; i < tree.length; i++) {
+            try {
+                process.kill(tree[i]!, 'SIGSTOP')
+            } catch {
+                continue // Already exited
+            }
+            tree.push(...(await this.getChildren(tree[i]!)))
+        }
+        for (const target of tree) {
+            try {
+                process.kill(target, 'SIGKILL')
+            } catch {
+                // Already exited
+            }
+        }
+    }
+
+    /*
+     Gets the child processes of a process on Unix
+     @param pid Parent process ID
+     @returns Child process IDs (empty if pgrep is unavailable)
+     */
+    private static async getChildren(pid: number): Promise<number[]> {
+        try {
+            const proc = Bun.spawn(['pgrep', '-P', pid.toString()], {
+                stdout: 'pipe',
+                stderr: 'ignore',
+            })
+            const output = await new Response(proc.stdout).text()
+            await proc.exited
+            return output
+                .split('\n')
+                .map((line) => parseInt(line, 10))
+                .filter((child) => child > 0)
+        } catch {
+            return []
+        }
+    }
+
     /*
      Kills a process on Windows using taskkill
      @param pid Process ID to kill
@@ -2,6 +2,10 @@ import type {TestResult, TestFile, TestConfig} from './types.ts'
 import {TestStatus} from './types.ts'
 import {relative} from 'path'
 import {isInteractiveTTY, writeOverwritable, clearCurrentLine} from './utils/tty.ts'
+import {Trace} from './utils/trace.ts'
+import {formatResourceUsage} from './utils/resource-usage.ts'
+import {addStats, emptyStats, StreamReport, toReportEntry} from './utils/stream-report.ts'
+import {Log} from './utils/log.ts'
 
 export class TestReporter {
     private config: TestConfig
@@ -28,15 +32,15 @@ export class TestReporter {
 
     reportDiscoveredTests(results: TestResult[]): void {
         if (!results.length) {
-            console.log('No tests discovered')
+            Log.info('No tests discovered')
             return
         }
 
-        console.log(`\nDiscovered ${results.length} test(s):`)
+        Log.info(`\nDiscovered ${results.length} test(s):`)
 
         for (const result of results) {
             const relativePath = this.getRelativePath(result.file.path)
-            console.log(`  ${relativePath}`)
+            Log.info(`  ${relativePath}`)
         }
     }
 
@@ -69,6 +73,9 @@ export class TestReporter {
         // Remove this test from running set
         this.runningTests.delete(result.file)
 
+        // Write the result to the --ndjson and --junit reports (the final report only prints failing output)
+        StreamReport.add(result, !!this.config.output?.verbose || this.config.output?.format === 'detailed')
+
         const status = this.formatStatus(result.status)
         const duration = this.formatDuration(result.duration)
         const relativePath = this.getRelativePath(result.file.path)
@@ -84,7 +91,7 @@ export class TestReporter {
             }
 
             // Print the completed test result
-            console.log(`${status} ${relativePath} (${duration})`)
+            Log.info(`${status} ${relativePath} (${duration})`)
 
             // If there are still tests running, show the next one
             if (this.runningTests.size > 0) {
@@ -97,55 +104,55 @@ export class TestReporter {
             }
         } else {
             // Non-interactive mode or show mode: no animation
-            console.log(`${status} ${relativePath} (${duration})`)
+            Log.info(`${status} ${relativePath} (${duration})`)
         }
     }
 
     reportTestsStarting(): void {
-        console.log('\nRunning tests...\n')
+        Log.info('\nRunning tests...\n')
     }
 
     reportSummary(results: TestResult[], elapsedTime?: number): void {
         const stats = this.calculateStats(results)
 
-        console.log('\n' + '='.repeat(60))
-        console.log('TEST SUMMARY')
-        console.log('='.repeat(60))
+        Log.info('\n' + '='.repeat(60))
+        Log.info('TEST SUMMARY')
+        Log.info('='.repeat(60))
 
         if (this.config.output?.colors) {
-            console.log(`${this.green('✓ Passed:')}  ${stats.passed}`)
-            console.log(`${this.red('✗ Failed:')}  ${stats.failed}`)
-            console.log(`${this.yellow('! Errors:')}  ${stats.errors}`)
-            console.log(`${this.blue('- Skipped:')} ${stats.skipped}`)
+            Log.info(`${this.green('✓ Passed:')}  ${stats.passed}`)
+            Log.info(`${this.red('✗ Failed:')}  ${stats.failed}`)
+            Log.info(`${this.yellow('! Errors:')}  ${stats.errors}`)
+            Log.info(`${this.blue('- Skipped:')} ${stats.skipped}`)
         } else {
-            console.log(`Passed:  ${stats.passed}`)
-            console.log(`Failed:  ${stats.failed}`)
-            console.log(`Errors:  ${stats.errors}`)
-            console.log(`Skipped: ${stats.skipped}`)
+            Log.info(`Passed:  ${stats.passed}`)
+            Log.info(`Failed:  ${stats.failed}`)
+            Log.info(`Errors:  ${stats.errors}`)
+            Log.info(`Skipped: ${stats.skipped}`)
         }
 
-        console.log(`Total:    ${stats.total}`)
+        Log.info(`Total:    ${stats.total}`)
 
         // Show assertion counts if any tests had assertions
         if (stats.filesWithAssertions > 0) {
             const totalAssertions = stats.assertionsPassed + stats.assertionsFailed
-            console.log(`Assertions: ${stats.assertionsPassed}/${totalAssertions} passed`)
+            Log.info(`Assertions: ${stats.assertionsPassed}/${totalAssertions} passed`)
         }
 
-        console.log(`Duration: ${this.formatDuration(stats.totalDuration)}`)
+        Log.info(`Duration: ${this.formatDuration(stats.totalDuration)}`)
         if (elapsedTime !== undefined) {
-            console.log(`Elapsed:  ${this.formatDuration(elapsedTime)}`)
+            Log.info(`Elapsed:  ${this.formatDuration(elapsedTime)}`)
         }
 
         if (stats.failed > 0 || stats.errors > 0) {
-            console.log(`\nResult: ${this.red('FAILED')}`)
+            Log.info(`\nResult: ${this.red('FAILED')}`)
         } else {
-            console.log(`\nResult: ${this.green('PASSED')}`)
+            Log.info(`\nResult: ${this.green('PASSED')}`)
         }
 
         // Add trailing blank line to separate from user commands (except in quiet mode)
         if (!this.config.output?.quiet) {
-            console.log()
+            Log.info()
         }
     }
 
@@ -157,32 +164,22 @@ export class TestReporter {
                 ...this.calculateStats(results),
                 ...(elapsedTime !== undefined && {elapsedTime}),
             },
-            tests: resultsToShow.map((result) => ({
-                file: result.file.path,
-                type: result.file.type,
-                status: result.status,
-                duration: result.duration,
-                exitCode: result.exitCode,
-                error: result.error,
-            })),
+            ...(Trace.enabled && {trace: Trace.summary()}),
+            tests: resultsToShow.map((result) => toReportEntry(result)),
         }
 
-        console.log(JSON.stringify(output, null, 2))
-
-        // Add trailing blank line (JSON mode always has colors disabled, so check manually)
-        if (!this.config.output?.quiet) {
-            console.log()
-        }
+        // The report is the only output on stdout: in JSON mode Log writes to stderr (see index.ts)
+        process.stdout.write(JSON.stringify(output, null, 2) + '\n')
     }
 
     private reportDetailed(results: TestResult[], elapsedTime?: number): void {
-        console.log('\nTEST RESULTS')
-        console.log('='.repeat(60))
+        Log.info('\nTEST RESULTS')
+        Log.info('='.repeat(60))
 
         const resultsToShow = this.config.output?.errorsOnly ? this.getFailingTests(results) : results
 
         if (this.config.output?.errorsOnly && resultsToShow.length === 0) {
-            console.log('\n✓ No failing tests found!')
+            Log.info('\n✓ No failing tests found!')
         } else {
             for (const result of resultsToShow) {
                 this.reportDetailedTest(result)
@@ -202,22 +199,55 @@ export class TestReporter {
         const duration = this.formatDuration(result.duration)
         const relativePath = this.getRelativePath(result.file.path)
 
-        console.log(`\n${relativePath}`)
-        console.log(`   Path:     ${relativePath}`)
-        console.log(`   Status:   ${status}`)
-        console.log(`   Duration: ${duration}`)
+        Log.info(`\n${relativePath}`)
+        Log.info(`   Path:     ${relativePath}`)
+        Log.info(`   Status:   ${status}`)
+        Log.info(`   Duration: ${duration}`)
 
         if (result.exitCode !== undefined) {
-            console.log(`   Exit Code: ${result.exitCode}`)
+            Log.info(`   Exit Code: ${result.exitCode}`)
+        }
+
+        if (result.resources) {
+            Log.info(`   Resources: ${formatResourceUsage(result.resources)}`)
+        }
+
+        if (result.benchmarks) {
+            Log.info('   Benchmarks:')
+            for (const benchmark of result.benchmarks) {
+                const change =
+                    benchmark.change !== undefined
+                        ? ` (${benchmark.change >= 0 ? '+' : ''}${benchmark.change.toFixed(1)}% vs baseline)`
+                        : ''
+                const line = `     ${benchmark.name}: ${benchmark.nsPerOp.toFixed(3)} ns/op, p50 ${benchmark.p50.toFixed(3)} ns${change}`
+                Log.info(benchmark.regressed ? this.red(line) : line)
+            }
+        }
+
+        if (result.perf) {
+            Log.info('   Counters:')
+            for (const region of result.perf) {
+                const counters = (['instructions', 'cycles', 'cacheMisses', 'branchMisses'] as const)
+                    .filter((counter) => region[counter] !== undefined)
+                    .map((counter) => `${Math.round(region[counter]! / region.count)} ${counter}`)
+                const change =
+                    region.change !== undefined
+                        ? ` (${region.change >= 0 ? '+' : ''}${region.change.toFixed(1)}% ${region.metric} vs baseline)`
+                        : ''
+                const runs = region.count > 1 ? ` per run (${region.count} runs)` : ''
+                const values = [`${Math.round(region.ns / region.count)} ns`, ...counters].join(', ')
+                const line = `     ${region.name}: ${values}${runs}${change}`
+                Log.info(region.regressed ? this.red(line) : line)
+            }
         }
 
         if (result.output) {
-            console.log('   Output:')
+            Log.info('   Output:')
             this.printIndented(result.output, '     ')
         }
 
         if (result.error) {
-            console.log('   Error:')
+            Log.info('   Error:')
             this.printIndented(result.error, '     ')
         }
 
@@ -228,20 +258,20 @@ export class TestReporter {
             !result.error &&
             result.exitCode !== 0
         ) {
-            console.log('   Note:')
-            console.log('     Test failed with no output captured.')
-            console.log('     This may indicate:')
-            console.log('     - Program crashed or encountered an access violation')
-            console.log('     - Missing DLL or shared library dependency')
-            console.log('     - Segmentation fault or other fatal error')
-            console.log('     Try running the test binary directly to see native error messages.')
+            Log.info('   Note:')
+            Log.info('     Test failed with no output captured.')
+            Log.info('     This may indicate:')
+            Log.info('     - Program crashed or encountered an access violation')
+            Log.info('     - Missing DLL or shared library dependency')
+            Log.info('     - Segmentation fault or other fatal error')
+            Log.info('     Try running the test binary directly to see native error messages.')
         }
     }
 
     private printIndented(text: string, indent: string): void {
         const lines = text.split('\n')
         for (const line of lines) {
-            console.log(indent + line)
+            Log.info(indent + line)
         }
     }
 
@@ -275,47 +305,7 @@ export class TestReporter {
     }
 
     private calculateStats(results: TestResult[]) {
-        return results.reduce(
-            (stats, result) => {
-                stats.total++
-                stats.totalDuration += result.duration
-
-                switch (result.status) {
-                    case TestStatus.Passed:
-                        stats.passed++
-                        break
-                    case TestStatus.Failed:
-                        stats.failed++
-                        break
-                    case TestStatus.Error:
-                        stats.errors++
-                        break
-                    case TestStatus.Skipped:
-                        stats.skipped++
-                        break
-                }
-
-                // Accumulate assertion counts
-                if (result.assertions) {
-                    stats.assertionsPassed += result.assertions.passed
-                    stats.assertionsFailed += result.assertions.failed
-                    stats.filesWithAssertions++
-                }
-
-                return stats
-            },
-            {
-                total: 0,
-                passed: 0,
-                failed: 0,
-                errors: 0,
-                skipped: 0,
-                totalDuration: 0,
-                assertionsPassed: 0,
-                assertionsFailed: 0,
-                filesWithAssertions: 0,
-            }
-        )
+        return results.reduce((stats, result) => addStats(stats, result), emptyStats())
     }
 
     // Color helper methods
@@ -11,8 +11,20 @@ import {
     EjscriptTestHandler,
     PythonTestHandler,
     GoTestHandler,
+    UnityTestHandler,
 } from './handlers/index.ts'
 import {ConfigManager} from './config.ts'
+import {GlobExpansion} from './utils/glob-expansion.ts'
+import {compareBenchmarks, comparePerf, formatPerfRegressions, formatRegressions} from './utils/benchmarks.ts'
+import {checkResourceLimits, combineResourceUsage} from './utils/resource-usage.ts'
+import {TimingHistory} from './utils/timings.ts'
+import {dirname, join, relative, resolve} from 'path'
+import {mkdir} from 'node:fs/promises'
+import {COMPILE_LANE, Trace} from './utils/trace.ts'
+import {RunBudget} from './utils/run-budget.ts'
+import {Cancellation, type CancelReason} from './utils/cancel.ts'
+import type {TestResources} from './utils/run-budget.ts'
+import {Log} from './utils/log.ts'
 
 /*
  TestRunner - Core test execution orchestrator
@@ -26,6 +38,7 @@ import {ConfigManager} from './config.ts'
 
  Architecture:
  - Uses Semaphore for concurrency control in parallel mode
+ - Orders tests longest-first using duration history saved in .testme/timings.json
  - Delegates test execution to language-specific handlers (C, Shell, JS, TS, etc.)
  - Supports both parallel and sequential execution modes
  - Handles step mode for interactive debugging
@@ -34,10 +47,18 @@ import {ConfigManager} from './config.ts'
  Execution Flow:
  1. discoverTests() - Find all test files matching patterns
  2. runTests() - Execute tests using appropriate handlers
- 3. Handlers perform: prepare() -> execute() -> cleanup()
+ 3. Handlers perform: prepare() -> [build()] -> execute() -> cleanup()
  4. Results collected and reported via TestReporter
  */
 
+/*
+ Handler and config for a test that was prepared and built ahead of execution
+ */
+type PreparedTest = {
+    handler: TestHandler
+    config: TestConfig
+}
+
 /*
  TestRunner class - Main test execution coordinator
  Orchestrates test discovery, execution, and reporting across multiple test types
@@ -45,6 +66,10 @@ import {ConfigManager} from './config.ts'
 export class TestRunner {
     private artifactManager: ArtifactManager
     private shouldStopCallback: (() => boolean) | null = null
+    private sharedHandlers = new Map<TestFile, TestHandler>() // Unity batch handlers of the running suite
+    private testConfigs = new Map<TestConfig, Map<string, Promise<TestConfig>>>() // Resolved configs by suite, directory
+    private budget?: RunBudget // Capacity shared by concurrently running suites (configuration groups)
+    private cancellations = new Set<AbortController>() // Cancellation of each running suite
 
     /*
    Creates a new TestRunner instance
@@ -62,6 +87,25 @@ export class TestRunner {
         this.shouldStopCallback = callback
     }
 
+    /*
+   Cancels every running suite: running tests and compiles are killed and queued work is dropped
+   @param reason Why the suites are cancelled
+   */
+    cancel(reason: CancelReason): void {
+        for (const controller of this.cancellations) {
+            controller.abort(reason)
+        }
+    }
+
+    /*
+   Shares one test and compile budget between the suites run until it is cleared
+   Configuration groups running concurrently use this so they do not oversubscribe the machine.
+   @param budget Shared budget, or undefined to give each suite its own
+   */
+    setBudget(budget: RunBudget | undefined): void {
+        this.budget = budget
+    }
+
     /*
    Discovers all test files matching the given options
    @param options Discovery options including patterns, root directory, and exclusions
@@ -85,23 +129,121 @@ export class TestRunner {
             reporter.reportTestsStarting()
         }
 
-        if (testSuite.config.execution?.parallel) {
-            return await this.runTestsParallel(testSuite, reporter)
-        } else {
-            return await this.runTestsSequential(testSuite, reporter)
+        return await this.runSuite(testSuite, reporter)
+    }
+
+    /*
+   Runs a test suite in parallel or sequentially, ordered by recorded duration history
+   @param testSuite Test suite containing tests and configuration
+   @param reporter Reporter for progress updates
+   @returns Promise resolving to array of test results
+   */
+    private async runSuite(testSuite: TestSuite, reporter: TestReporter): Promise<TestResult[]> {
+        // Order tests using recorded durations and failures from previous runs
+        const parallel = !!testSuite.config.execution?.parallel
+        const useHistory = testSuite.config.execution?.history !== false
+        const history = useHistory ? await TimingHistory.load(testSuite.tests) : undefined
+        const suite = history
+            ? {
+                  ...testSuite,
+                  tests: history.order(testSuite.tests, {
+                      parallel,
+                      stopOnFailure: testSuite.config.execution?.stopOnFailure === true,
+                  }),
+              }
+            : testSuite
+
+        // Resolve the config of every test directory once, before any test runs
+        GlobExpansion.clearCache()
+        await Trace.span('plan configs', 'config', () => this.planConfigs(suite))
+
+        // Unity builds: TM_TEST() C tests in a directory share one handler and one binary
+        const unity = await this.planUnityBuilds(suite, suite.config)
+        for (const [testFile, handler] of unity) {
+            this.sharedHandlers.set(testFile, handler)
         }
+
+        // Fast-fail (execution.stopOnFailure) and interrupts cancel the suite's running work
+        const cancellation = new AbortController()
+        this.cancellations.add(cancellation)
+
+        let results: TestResult[]
+        try {
+            results = parallel
+                ? await this.runTestsParallel(suite, reporter, cancellation)
+                : await this.runTestsSequential(suite, reporter, cancellation)
+        } finally {
+            this.cancellations.delete(cancellation)
+            for (const testFile of unity.keys()) {
+                this.sharedHandlers.delete(testFile)
+            }
+            this.testConfigs.delete(suite.config)
+        }
+
+        if (history) {
+            history.record(results)
+            await history.save()
+        }
+        return results
+    }
+
+    /*
+   Resolves the config of each test directory in a suite, so executing a test does no config file work
+   @param testSuite Test suite to plan
+   */
+    private async planConfigs(testSuite: TestSuite): Promise<void> {
+        const configs = new Map<string, Promise<TestConfig>>()
+        for (const testFile of testSuite.tests) {
+            if (!configs.has(testFile.directory)) {
+                configs.set(testFile.directory, this.resolveTestConfig(testFile.directory, testSuite.config))
+            }
+        }
+        this.testConfigs.set(testSuite.config, configs)
+        await Promise.all(configs.values())
+    }
+
+    /*
+   Groups C tests whose config enables compiler.c.unity into per-directory unity batches
+   @param testSuite Test suite to plan
+   @param globalConfig Global configuration with CLI overrides applied
+   @returns Shared batch handler for each batched test
+   */
+    private async planUnityBuilds(testSuite: TestSuite, globalConfig: TestConfig): Promise<Map<TestFile, TestHandler>> {
+        const candidates: TestFile[] = []
+        for (const testFile of testSuite.tests) {
+            if (testFile.type === TestType.C) {
+                const config = await this.findConfigForTest(testFile, globalConfig)
+                // Repeated runs use the per-file path (and fork server) instead of a shared batch
+                if (config.compiler?.c?.unity && (config.execution?.repeat ?? 1) <= 1) {
+                    candidates.push(testFile)
+                }
+            }
+        }
+        return candidates.length > 1 ? await UnityTestHandler.plan(candidates) : new Map()
     }
 
     async cleanArtifacts(rootDir: string): Promise<void> {
         await this.artifactManager.cleanAllArtifacts(rootDir)
     }
 
-    private async runTestsSequential(testSuite: TestSuite, reporter: TestReporter): Promise<TestResult[]> {
+    /*
+     Waits for artifact directories and cache entries being removed in the background
+     */
+    async flushArtifacts(): Promise<void> {
+        await this.artifactManager.flush()
+    }
+
+    private async runTestsSequential(
+        testSuite: TestSuite,
+        reporter: TestReporter,
+        cancellation: AbortController
+    ): Promise<TestResult[]> {
         const results: TestResult[] = []
+        const budget = this.budget ?? new RunBudget(1, 1)
 
         for (let i = 0; i < testSuite.tests.length; i++) {
             // Check if we should stop (Ctrl+C pressed)
-            if (this.shouldStopCallback && this.shouldStopCallback()) {
+            if ((this.shouldStopCallback && this.shouldStopCallback()) || cancellation.signal.aborted) {
                 break
             }
 
@@ -133,7 +275,19 @@ export class TestRunner {
                 reporter.reportTestStarting(testFile)
             }
 
-            const result = await this.executeTest(testFile, testSuite.config)
+            // Wait for a worker slot shared with concurrently running groups
+            const resources = this.getTestResources(testFile, undefined, testSuite.config)
+            const slot = await budget.acquire(resources)
+            let result: TestResult
+            try {
+                const execute = () => this.executeTest(testFile, testSuite.config)
+                const run = await Cancellation.track(cancellation.signal, () =>
+                    this.traceTest(slot, testFile, execute)
+                )
+                result = this.checkCancelled(run.result, run.cancelled, cancellation.signal)
+            } finally {
+                budget.release(resources, slot)
+            }
             results.push(result)
 
             if (!this.isQuietMode(testSuite.config)) {
@@ -161,51 +315,228 @@ export class TestRunner {
    - No batching delays: long tests don't hold up entire batches
    - Better resource utilization: workers never sit idle while tests remain
 
+   Tests whose handler has a build() stage (C tests) are compiled up front by a separate
+   compile pool (execution.compileWorkers, default: CPU cores). They keep their planned place in
+   the execution queue and are skipped by workers until their binary is ready, so CPU-bound
+   compiles overlap with I/O-bound test runs without losing the history order (longest and
+   failing tests first).
+
+   Workers are also resource aware. Each test declares the cores (execution.cpu) and memory
+   (execution.memory, MB) it needs, or execution.exclusive to run alone. A test only starts
+   when it fits within the detected core count and free memory. Tests further back in the
+   queue may backfill idle capacity, but only a bounded number of times past a blocked head
+   so heavy tests are not starved.
+
+   Worker slots, cores, memory and compile slots come from the run budget shared by
+   concurrently running configuration groups (see setBudget()), or from a budget of this
+   suite's own when groups run one at a time.
+
+   A failure with execution.stopOnFailure, or an interrupt, cancels the suite: queued tests and
+   compiles are dropped, and running tests and compiles have their process trees killed.
+
    @param testSuite Test suite containing tests and configuration
    @param reporter Reporter for progress updates
+   @param cancellation Cancels the suite
    @returns Promise resolving to array of test results
    */
-    private async runTestsParallel(testSuite: TestSuite, reporter: TestReporter): Promise<TestResult[]> {
-        const workers = testSuite.config.execution?.workers || 4
+    private async runTestsParallel(
+        testSuite: TestSuite,
+        reporter: TestReporter,
+        cancellation: AbortController
+    ): Promise<TestResult[]> {
+        // Without execution.workers every core is a worker; the budget's cores and memory limit the tests run at once
+        const workers = RunBudget.getWorkers(testSuite.config.execution)
+        const compileWorkers = RunBudget.getCompiles(testSuite.config.execution)
         const results: TestResult[] = []
-        const testsQueue = [...testSuite.tests]
+        const testsQueue: TestFile[] = []
+        const compileQueue: {testFile: TestFile; handler: TestHandler}[] = []
+        const compiling = new Set<TestFile>() // Queued tests whose build stage has not finished
+        const prepared = new Map<TestFile, PreparedTest>()
         const activeWorkers: Promise<void>[] = []
         let shouldStop = false // Shared flag to signal workers to stop
 
-        // Worker function that processes tests from the queue
-        // Each worker runs in a loop, continuously pulling tests until queue is empty
-        const worker = async () => {
-            while (testsQueue.length > 0 && !shouldStop) {
-                // Check if we should stop (Ctrl+C pressed)
-                if (this.shouldStopCallback && this.shouldStopCallback()) {
-                    shouldStop = true
-                    testsQueue.length = 0
+        // Resource budget for running tests, shared with concurrently running groups
+        const budget = this.budget ?? new RunBudget(workers, compileWorkers)
+        const reserved = new Map<TestFile, {resources: TestResources; slot: number}>()
+        // Members of a unity batch share one driver run, so the batch runs in a single worker slot
+        const batchCompiling = new Map<TestHandler, number>() // Batch members whose build stage has not finished
+        let headSkips = 0
+
+        // Queue tests in planned order, starting the build stage of those that have one
+        for (const testFile of testSuite.tests) {
+            const handler = this.createFreshHandler(testFile)
+            if (handler?.build) {
+                compileQueue.push({testFile, handler})
+                compiling.add(testFile)
+                const batch = this.sharedHandlers.get(testFile)
+                if (batch) {
+                    batchCompiling.set(batch, (batchCompiling.get(batch) ?? 0) + 1)
+                }
+            }
+            testsQueue.push(testFile)
+        }
+
+        // Cancelling the suite stops the workers and kills their running tests and compiles
+        const stop = (reason: CancelReason) => cancellation.abort(reason)
+        const stopped = () => {
+            shouldStop = true
+            testsQueue.length = 0 // Clear queues to stop other workers
+            compileQueue.length = 0
+            budget.wake()
+        }
+        if (cancellation.signal.aborted) {
+            stopped()
+        }
+        cancellation.signal.addEventListener('abort', stopped, {once: true})
+
+        // Compile worker: prepares and builds tests, then feeds them to the execution queue
+        const compileWorker = async () => {
+            while (compileQueue.length > 0 && !shouldStop) {
+                const slot = await budget.acquireCompile()
+                const item = compileQueue.shift()
+                if (!item) {
+                    budget.releaseCompile(slot)
                     break
                 }
+                const compile = () => this.prepareTest(item.testFile, item.handler, testSuite.config)
+                const ready = await Cancellation.run(cancellation.signal, () =>
+                    Trace.lane(COMPILE_LANE + slot, `Compile ${slot + 1}`, compile)
+                )
+                if (ready) {
+                    prepared.set(item.testFile, ready)
+                }
+                // The test becomes runnable at its planned place in the queue
+                compiling.delete(item.testFile)
+                const batch = this.sharedHandlers.get(item.testFile)
+                if (batch) {
+                    batchCompiling.set(batch, batchCompiling.get(batch)! - 1)
+                }
+                budget.releaseCompile(slot)
+            }
+        }
 
-                const testFile = testsQueue.shift()
-                if (!testFile) break
+        // A queued test is runnable once built; a batch member once every member of its batch is built
+        const isBuilt = (testFile: TestFile): boolean => {
+            const batch = this.sharedHandlers.get(testFile)
+            return batch ? !batchCompiling.get(batch) : !compiling.has(testFile)
+        }
+
+        // Find the first compiled queued test that fits, limiting how often a blocked head test is bypassed
+        const pickTest = (): number => {
+            let head = true
+            for (let i = 0; i < testsQueue.length; i++) {
+                if (!isBuilt(testsQueue[i]!)) {
+                    continue
+                }
+                if (budget.fits(this.getTestResources(testsQueue[i]!, prepared, testSuite.config))) {
+                    if (head) {
+                        headSkips = 0
+                    }
+                    return i
+                }
+                if (head && ++headSkips > workers) {
+                    return -1 // Let running tests drain so the head test can start
+                }
+                head = false
+            }
+            return -1
+        }
 
-                // Show test starting (interactive animation)
-                if (!this.isQuietMode(testSuite.config)) {
-                    reporter.reportTestStarting(testFile)
+        // Get the next runnable test, with the other queued members of its unity batch, and reserve
+        // one slot for them, waiting while tests are running or compiling
+        const nextTests = async (): Promise<TestFile[] | undefined> => {
+            while (!shouldStop) {
+                const index = pickTest()
+                if (index >= 0) {
+                    const testFile = testsQueue.splice(index, 1)[0]!
+                    const batch = this.sharedHandlers.get(testFile)
+                    const tests = [testFile]
+                    for (let i = testsQueue.length - 1; batch && i >= 0; i--) {
+                        if (this.sharedHandlers.get(testsQueue[i]!) === batch) {
+                            tests.splice(1, 0, testsQueue.splice(i, 1)[0]!)
+                        }
+                    }
+                    const resources = this.getTestResources(testFile, prepared, testSuite.config)
+                    reserved.set(testFile, {resources, slot: budget.reserve(resources)})
+                    return tests
+                }
+                if (testsQueue.length === 0) {
+                    return undefined
                 }
+                // Woken when a test of any group finishes or a compile completes
+                await budget.changed()
+            }
+            return undefined
+        }
+
+        // Release a finished test's resources and wake waiting workers
+        const release = (testFile: TestFile) => {
+            const reservation = reserved.get(testFile)
+            if (reservation) {
+                reserved.delete(testFile)
+                budget.release(reservation.resources, reservation.slot)
+            } else {
+                budget.wake()
+            }
+        }
 
-                const result = await this.executeTest(testFile, testSuite.config)
-                results.push(result)
+        // Run one test in a reserved worker slot and report its result
+        const runTest = async (testFile: TestFile, slot: number) => {
+            // Show test starting (interactive animation)
+            if (!this.isQuietMode(testSuite.config)) {
+                reporter.reportTestStarting(testFile)
+            }
+
+            let result: TestResult
+            try {
+                const execute = () => this.executeTest(testFile, testSuite.config, prepared.get(testFile))
+                const run = await Cancellation.track(cancellation.signal, () =>
+                    this.traceTest(slot, testFile, execute)
+                )
+                result = this.checkCancelled(run.result, run.cancelled, cancellation.signal)
+            } finally {
+                prepared.delete(testFile)
+            }
+            results.push(result)
+
+            if (!this.isQuietMode(testSuite.config)) {
+                reporter.reportProgress(result)
+            }
 
-                if (!this.isQuietMode(testSuite.config)) {
-                    reporter.reportProgress(result)
+            // Stop all workers if test failed and stopOnFailure is enabled
+            if (testSuite.config.execution?.stopOnFailure && result.status === TestStatus.Failed) {
+                stop('failure')
+            }
+        }
+
+        // Worker function that processes tests from the queue
+        // Each worker runs in a loop, continuously pulling tests until no tests remain
+        const worker = async () => {
+            while (!shouldStop) {
+                // Check if we should stop (Ctrl+C pressed)
+                if (this.shouldStopCallback && this.shouldStopCallback()) {
+                    stop('interrupt')
+                    break
                 }
 
-                // Stop all workers if test failed and stopOnFailure is enabled
-                if (testSuite.config.execution?.stopOnFailure && result.status === TestStatus.Failed) {
-                    shouldStop = true
-                    testsQueue.length = 0 // Clear queue to stop other workers
+                const tests = await nextTests()
+                if (!tests) break
+
+                // Members of a unity batch wait on the same driver run in this worker's slot
+                try {
+                    const slot = reserved.get(tests[0]!)!.slot
+                    await Promise.all(tests.map((testFile) => runTest(testFile, slot)))
+                } finally {
+                    release(tests[0]!)
                 }
             }
         }
 
+        // Start compile pool
+        for (let i = 0; i < Math.min(compileWorkers, compileQueue.length); i++) {
+            activeWorkers.push(compileWorker())
+        }
+
         // Start worker pool
         for (let i = 0; i < Math.min(workers, testSuite.tests.length); i++) {
             activeWorkers.push(worker())
@@ -217,8 +548,76 @@ export class TestRunner {
         return results
     }
 
-    private async executeTest(testFile: TestFile, globalConfig: TestConfig): Promise<TestResult> {
-        const handler = this.createFreshHandler(testFile)
+    /*
+   Prepares a test and runs its build stage ahead of execution
+   @param testFile Test file to build
+   @param handler Handler instance that will also execute the test
+   @param globalConfig Global configuration with CLI overrides applied
+   @returns Prepared handler and config, or undefined if preparation failed (executeTest() reports the error)
+   */
+    private async prepareTest(
+        testFile: TestFile,
+        handler: TestHandler,
+        globalConfig: TestConfig
+    ): Promise<PreparedTest | undefined> {
+        try {
+            const config = await this.findConfigForTest(testFile, globalConfig)
+            if (handler.prepare) {
+                await handler.prepare(testFile)
+            }
+            await handler.build!(testFile, config)
+            return {handler, config}
+        } catch {
+            return undefined
+        }
+    }
+
+    /*
+   Gets the resources a test needs from its configuration (execution.cpu, memory, exclusive)
+   @param testFile Test file
+   @param prepared Tests already prepared by the compile pool (with their test-specific config)
+   @param config Configuration of the test group
+   @returns Test resource requirements
+   */
+    private getTestResources(
+        testFile: TestFile,
+        prepared: Map<TestFile, PreparedTest> | undefined,
+        config: TestConfig
+    ): TestResources {
+        const execution = (prepared?.get(testFile)?.config ?? config).execution
+        return {
+            cpu: Math.max(1, execution?.cpu ?? 1),
+            memory: Math.max(0, execution?.memory ?? 0),
+            exclusive: execution?.exclusive === true,
+        }
+    }
+
+    /*
+   Runs a test as a trace span on the lane of the worker slot it holds
+   @param slot Worker slot reserved from the run budget
+   @param testFile Test file being executed
+   @param execute Runs the test
+   @returns Promise resolving to the test result
+   */
+    private async traceTest(slot: number, testFile: TestFile, execute: () => Promise<TestResult>): Promise<TestResult> {
+        return await Trace.lane(slot + 1, `Worker ${slot + 1}`, () =>
+            Trace.span(testFile.name, 'test', execute, {file: testFile.path})
+        )
+    }
+
+    /*
+   Executes a single test: prepare, execute, benchmark processing and cleanup
+   @param testFile Test file to execute
+   @param globalConfig Global configuration with CLI overrides applied
+   @param prepared Handler and config already prepared and built by the compile pool
+   @returns Promise resolving to the test result
+   */
+    private async executeTest(
+        testFile: TestFile,
+        globalConfig: TestConfig,
+        prepared?: PreparedTest
+    ): Promise<TestResult> {
+        const handler = prepared?.handler ?? this.createFreshHandler(testFile)
 
         if (!handler) {
             return {
@@ -232,15 +631,19 @@ export class TestRunner {
 
         try {
             // Find the nearest config file to this specific test file
-            const testSpecificConfig = await this.findConfigForTest(testFile, globalConfig)
+            const testSpecificConfig = prepared?.config ?? (await this.findConfigForTest(testFile, globalConfig))
 
             // Prepare test (if needed)
-            if (handler.prepare) {
+            if (handler.prepare && !prepared) {
                 await handler.prepare(testFile)
             }
-
             // Execute the test with its specific config
-            const result = await handler.execute(testFile, testSpecificConfig)
+            const result = await this.executeRepeated(handler, testFile, testSpecificConfig)
+
+            // Store benchmark and counter region results and check them against the saved baseline
+            if (result.benchmarks || result.perf) {
+                await this.processBenchmarks(testFile, result, testSpecificConfig)
+            }
 
             // Cleanup (if needed)
             // Artifacts are kept by default to enable compilation caching for C tests
@@ -251,7 +654,7 @@ export class TestRunner {
                     result.status === TestStatus.Passed && testSpecificConfig.execution?.keepArtifacts === false
                 if (shouldCleanup) {
                     try {
-                        await handler.cleanup(testFile, testSpecificConfig)
+                        await Trace.span('teardown', 'teardown', () => handler.cleanup!(testFile, testSpecificConfig))
                     } catch (cleanupError) {
                         // Log cleanup errors but don't fail the test
                         // The test passed, so we return success even if cleanup fails
@@ -275,12 +678,143 @@ export class TestRunner {
         }
     }
 
+    /*
+   Executes a test execution.repeat times, stopping at the first run that does not pass
+   Each run is checked against the execution.maxRss and maxCpu limits.
+   @param handler Handler for the test
+   @param testFile Test file to execute
+   @param config Test-specific configuration
+   @returns Result of the last run, with the duration and resource usage of all runs
+   */
+    private async executeRepeated(handler: TestHandler, testFile: TestFile, config: TestConfig): Promise<TestResult> {
+        const repeat = Math.max(1, config.execution?.repeat ?? 1)
+        let result = this.checkResources(await handler.execute(testFile, config), config)
+        let duration = result.duration
+        let resources = result.resources
+        let run = 1
+        while (
+            run < repeat &&
+            result.status === TestStatus.Passed &&
+            !this.shouldStopCallback?.() &&
+            !Cancellation.signal?.aborted
+        ) {
+            result = this.checkResources(await handler.execute(testFile, config), config)
+            duration += result.duration
+            resources = combineResourceUsage(resources, result.resources)
+            run++
+        }
+        if (repeat === 1) {
+            return result
+        }
+        const summary = result.status === TestStatus.Passed ? `Passed ${run} runs` : `Failed on run ${run} of ${repeat}`
+        return {...result, duration, resources, output: `${summary}\n${result.output}`}
+    }
+
+    /*
+   Reports a test whose run was cut short by cancelling its suite as skipped rather than failed
+   Tests that failed on their own keep their result, even if the suite was cancelled meanwhile.
+   @param result Result of the test
+   @param cancelled Whether the test's work was killed or not started by the cancellation
+   @param signal Cancellation signal of the suite
+   @returns The result, or a skipped result if the cancellation cut the test short before it passed
+   */
+    private checkCancelled(result: TestResult, cancelled: boolean, signal: AbortSignal): TestResult {
+        if (!cancelled || result.status === TestStatus.Passed || result.status === TestStatus.Skipped) {
+            return result
+        }
+        return {...result, status: TestStatus.Skipped, error: Cancellation.describe(signal)}
+    }
+
+    /*
+   Fails a passing test whose process exceeded execution.maxRss or execution.maxCpu
+   @param result Result of one run (updated in place)
+   @param config Test-specific configuration
+   @returns The result
+   */
+    private checkResources(result: TestResult, config: TestConfig): TestResult {
+        if (result.resources && result.status === TestStatus.Passed) {
+            const exceeded = checkResourceLimits(result.resources, config.execution)
+            if (exceeded) {
+                result.status = TestStatus.Failed
+                result.error = exceeded
+            }
+        }
+        return result
+    }
+
+    /*
+   Stores benchmark and counter region results in the artifact directory and compares them against the
+   saved baseline. The baseline is created on the first run and replaced when --save-baseline is used.
+   If a benchmark or counter region regresses beyond benchmarks.threshold, a passing test is marked as failed.
+   @param testFile Test file that produced the benchmarks
+   @param result Test result with parsed benchmarks and counter regions (updated in place)
+   @param config Test-specific configuration with benchmark settings
+   */
+    private async processBenchmarks(testFile: TestFile, result: TestResult, config: TestConfig): Promise<void> {
+        const benchmarks = result.benchmarks ?? []
+        const perf = result.perf ?? []
+        try {
+            const baselinePath = this.getBaselinePath(testFile, config)
+            const baselineFile = Bun.file(baselinePath)
+            const saveBaseline = config.execution?.saveBaseline === true || !(await baselineFile.exists())
+
+            if (!saveBaseline) {
+                const baseline = JSON.parse(await baselineFile.text())
+                const regressions = compareBenchmarks(benchmarks, baseline.benchmarks || [], config.benchmarks)
+                const perfRegressions = comparePerf(perf, baseline.perf || [], config.benchmarks)
+                if ((regressions.length > 0 || perfRegressions.length > 0) && result.status === TestStatus.Passed) {
+                    const errors: string[] = []
+                    if (regressions.length > 0) {
+                        errors.push(formatRegressions(regressions, config.benchmarks))
+                    }
+                    if (perfRegressions.length > 0) {
+                        errors.push(formatPerfRegressions(perfRegressions, config.benchmarks))
+                    }
+                    result.status = TestStatus.Failed
+                    result.error = errors.join('\n')
+                }
+            }
+            const record = JSON.stringify({benchmarks, ...(perf.length > 0 && {perf})}, null, 2)
+            await this.artifactManager.writeArtifact(testFile, 'benchmarks.json', record)
+            if (saveBaseline && result.status === TestStatus.Passed) {
+                await mkdir(dirname(baselinePath), {recursive: true})
+                await Bun.write(baselinePath, record)
+            }
+        } catch (error) {
+            if (!config.output?.quiet) {
+                const errorMsg = error instanceof Error ? error.message : String(error)
+                console.warn(`⚠ Warning: Failed to process benchmarks for ${testFile.name}: ${errorMsg}`)
+            }
+        }
+    }
+
+    /*
+   Gets the benchmark baseline file path for a test
+   @param testFile Test file to get the baseline for
+   @param config Test configuration with optional benchmarks.baselineDir
+   @returns Baseline path in the artifact directory, or under baselineDir mirroring the test's relative path
+   */
+    private getBaselinePath(testFile: TestFile, config: TestConfig): string {
+        const baselineDir = config.benchmarks?.baselineDir
+        if (!baselineDir) {
+            return this.artifactManager.getArtifactPath(testFile, 'benchmarks-baseline.json')
+        }
+        const configDir = config.configDir || testFile.directory
+        const testPath = relative(configDir, testFile.path)
+        return join(resolve(configDir, baselineDir), `${testPath}.bench.json`)
+    }
+
     /*
    Creates a fresh handler instance for each test to avoid shared state conflicts
+   Tests in a unity batch get their batch's shared handler instead.
    @param testFile Test file to create handler for
    @returns New handler instance or undefined if no handler found
    */
     private createFreshHandler(testFile: TestFile): TestHandler | undefined {
+        const shared = this.sharedHandlers.get(testFile)
+        if (shared) {
+            return shared
+        }
         switch (testFile.type) {
             case TestType.Shell:
             case TestType.PowerShell:
@@ -317,7 +851,7 @@ export class TestRunner {
         }
 
         if (!tests.length) {
-            console.log('No tests discovered')
+            Log.info('No tests discovered')
             return
         }
 
@@ -342,7 +876,7 @@ export class TestRunner {
 
             if (groupConfig.enable === false) {
                 if (config.output?.verbose) {
-                    console.log(
+                    Log.info(
                         `🚫 Tests disabled in: ${configDir === options.rootDir ? '.' : configDir.replace(options.rootDir + '/', '')}`
                     )
                 }
@@ -410,7 +944,7 @@ export class TestRunner {
                 } else if (isExplicitlyTargeted) {
                     enabledTests.push(...groupTests)
                 } else if (config.output?.verbose) {
-                    console.log(`⏭️  Manual tests in: ${relativeConfigDir} (use explicit name to list)`)
+                    Log.info(`⏭️  Manual tests in: ${relativeConfigDir} (use explicit name to list)`)
                 }
             } else {
                 enabledTests.push(...groupTests)
@@ -418,7 +952,7 @@ export class TestRunner {
         }
 
         if (!enabledTests.length) {
-            console.log('No enabled tests discovered')
+            Log.info('No enabled tests discovered')
             return
         }
 
@@ -440,11 +974,12 @@ export class TestRunner {
             rootDir,
             patterns: patterns.length ? patterns : config.patterns?.include || [],
             excludePatterns: config.patterns?.exclude || [],
+            index: config.patterns?.index,
         })
 
         if (!tests.length) {
             if (!this.isQuietMode(config)) {
-                console.log('No tests discovered')
+                Log.info('No tests discovered')
             }
             return []
         }
@@ -504,22 +1039,36 @@ export class TestRunner {
     }
 
     /*
-   Finds the most specific config file for a test file
-   Walks up from the test file directory looking for testme.json5
-   Falls back to global config if no specific config is found
+   Finds the most specific config for a test file
+   Uses the config resolved for the test's directory when the suite was planned
    @param testFile Test file to find config for
    @param globalConfig Fallback global configuration with CLI overrides applied
    @returns Test-specific configuration with CLI overrides preserved
    */
     private async findConfigForTest(testFile: TestFile, globalConfig: TestConfig): Promise<TestConfig> {
+        const planned = this.testConfigs.get(globalConfig)?.get(testFile.directory)
+        return await (planned ?? this.resolveTestConfig(testFile.directory, globalConfig))
+    }
+
+    /*
+   Resolves the most specific config file for a test directory
+   Walks up from the test directory looking for testme.json5
+   Falls back to global config if no specific config is found
+   The result is frozen: it is shared by every test in the directory. The compiler settings are frozen
+   deeply, they may also be shared with the cached config file and other directories.
+   @param directory Test directory to find config for
+   @param globalConfig Fallback global configuration with CLI overrides applied
+   @returns Test-specific configuration with CLI overrides preserved
+   */
+    private async resolveTestConfig(directory: string, globalConfig: TestConfig): Promise<TestConfig> {
         try {
-            // Look for config starting from the test file's directory
-            const testSpecificConfig = await ConfigManager.findConfig(testFile.directory)
+            // Look for config starting from the test directory
+            const testSpecificConfig = await ConfigManager.findConfig(directory)
 
             // If we found a config and it has a configDir, merge with global CLI overrides
             if (testSpecificConfig.configDir) {
                 // Preserve CLI overrides from global config
-                return {
+                const config: TestConfig = {
                     ...testSpecificConfig,
                     // Preserve execution settings that may have CLI overrides
                     execution: {
@@ -546,10 +1095,14 @@ export class TestRunner {
                         ...(globalConfig.execution?.iterations !== undefined && {
                             iterations: globalConfig.execution.iterations,
                         }),
+                        ...(globalConfig.execution?.repeat !== undefined && {repeat: globalConfig.execution.repeat}),
                         ...(globalConfig.execution?.duration !== undefined && {
                             duration: globalConfig.execution.duration,
                         }),
                         ...(globalConfig.execution?.rebuild && {rebuild: globalConfig.execution.rebuild}),
+                        ...(globalConfig.execution?.saveBaseline && {
+                            saveBaseline: globalConfig.execution.saveBaseline,
+                        }),
                     },
                     // Preserve output settings that may have CLI overrides
                     output: {
@@ -565,44 +1118,76 @@ export class TestRunner {
                         }),
                         ...(globalConfig.output?.live !== undefined && {live: globalConfig.output.live}),
                     },
+                    // Preserve run-wide instrumentation (--sanitize and --coverage)
+                    ...((globalConfig.compiler?.c?.sanitize || globalConfig.compiler?.c?.coverage) && {
+                        compiler: {
+                            ...testSpecificConfig.compiler,
+                            c: {
+                                ...testSpecificConfig.compiler?.c,
+                                ...(globalConfig.compiler?.c?.sanitize && {sanitize: globalConfig.compiler.c.sanitize}),
+                                ...(globalConfig.compiler?.c?.coverage && {coverage: true}),
+                            },
+                        },
+                    }),
                     // Preserve environment variables from global config (including those from environment script)
                     environment: {
                         ...testSpecificConfig.environment,
                         ...globalConfig.environment,
                     },
                 }
+                Object.freeze(config.execution)
+                Object.freeze(config.output)
+                Object.freeze(config.environment)
+                // The C handler caches resolved flags by the compiler.c object, so its settings cannot change
+                TestRunner.freezeDeep(config.compiler)
+                return Object.freeze(config)
             }
         } catch (error) {
             // If config loading fails, fall back to global config
-            console.warn(`Warning: Failed to load config for ${testFile.path}: ${error}`)
+            console.warn(`Warning: Failed to load config for ${directory}: ${error}`)
         }
 
         // Fall back to global config
         return globalConfig
     }
 
+    /*
+   Freezes a configuration value with the objects and arrays it contains
+   @param value Configuration value
+   @returns The frozen value
+   */
+    private static freezeDeep<T>(value: T): T {
+        if (value && typeof value === 'object' && !Object.isFrozen(value)) {
+            Object.freeze(value)
+            for (const item of Object.values(value)) {
+                TestRunner.freezeDeep(item)
+            }
+        }
+        return value
+    }
+
     /*
    Prompts user for input before running the next test in step mode
    @param testFile The test file about to be executed
    @returns Promise that resolves to true if test should be skipped, false to continue
    */
     private async promptForNextTest(testFile: TestFile): Promise<boolean> {
-        console.log(`\n📋 About to run: ${testFile.name}`)
-        console.log(`   Path: ${testFile.path}`)
-        console.log(`   Type: ${testFile.type}`)
+        Log.info(`\n📋 About to run: ${testFile.name}`)
+        Log.info(`   Path: ${testFile.path}`)
+        Log.info(`   Type: ${testFile.type}`)
 
         // Use Bun's built-in prompt functionality
         const input = prompt('Press Enter to continue, "s" to skip, or "q" to quit: ')
 
         if (input === 'q' || input === 'quit') {
-            console.log('🛑 Test execution stopped by user')
+            Log.info('🛑 Test execution stopped by user')
             process.exit(0)
         } else if (input === 's' || input === 'skip') {
-            console.log('⏭️  Skipping test')
+            Log.info('⏭️  Skipping test')
             return true // Skip this test
         }
 
-        console.log('▶️  Running test...')
+        Log.info('▶️  Running test...')
         return false // Continue with test
     }
 
@@ -625,11 +1210,7 @@ export class TestRunner {
         const reporter = new TestReporter(config, invocationDir)
 
         // Execute tests
-        if (config.execution?.parallel) {
-            return await this.runTestsParallel(testSuite, reporter)
-        } else {
-            return await this.runTestsSequential(testSuite, reporter)
-        }
+        return await this.runSuite(testSuite, reporter)
     }
 
     /*
@@ -648,7 +1229,8 @@ export class TestRunner {
         )
 
         // If there are failures and we're not already in verbose mode, re-report with verbose mode showing only errors
-        if (hasFailures && !config.output?.verbose) {
+        // JSON output is left as JSON so reports stay machine readable (e.g. for --merge)
+        if (hasFailures && !config.output?.verbose && config.output?.format !== 'json') {
             const verboseConfig = {
                 ...config,
                 output: {
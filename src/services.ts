@@ -1,10 +1,16 @@
 import type {TestConfig} from './types.ts'
 import {relative, delimiter, isAbsolute, join} from 'path'
+import {existsSync} from 'fs'
 import {GlobExpansion} from './utils/glob-expansion.ts'
 import {ProcessManager} from './platform/process.ts'
 import {PlatformDetector} from './platform/detector.ts'
 import {HealthCheckManager} from './services/health-check.ts'
 import {ShellDetector} from './platform/shell.ts'
+import {Trace} from './utils/trace.ts'
+import {Log} from './utils/log.ts'
+
+// Characters of each setup service stream kept for error messages
+const SETUP_OUTPUT_LIMIT = 64 * 1024
 
 /**
  * Manages setup and cleanup services for test execution
@@ -35,7 +41,7 @@ import {ShellDetector} from './platform/shell.ts'
  * // Check if tests should be skipped
  * const { shouldSkip, message } = await serviceManager.runSkip(config);
  * if (shouldSkip) {
- *   console.log('Skipping:', message);
+ *   Log.info('Skipping:', message);
  *   return;
  * }
  *
@@ -62,6 +68,8 @@ export class ServiceManager {
     private invocationDir: string
     /** @internal */
     private environmentVars: Record<string, string> = {}
+    /** @internal */
+    private setupOutput?: {stdout: string; stderr: string} // Output tails once watchSetupOutput() reads the streams
 
     /**
      * Creates a new ServiceManager instance
@@ -93,7 +101,7 @@ export class ServiceManager {
 
         const displayPath = this.getDisplayPath(skipCommand, config)
         if (config.output?.verbose) {
-            console.log(`Running skip script: ${displayPath}`)
+            Log.info(`Running skip script: ${displayPath}`)
         }
 
         try {
@@ -141,7 +149,7 @@ export class ServiceManager {
             } else if (result === 0) {
                 // Exit code 0 means don't skip (run tests)
                 if (config.output?.verbose) {
-                    console.log('✓ Skip script returned 0 - tests will run')
+                    Log.info('✓ Skip script returned 0 - tests will run')
                 }
                 return {shouldSkip: false}
             } else {
@@ -178,7 +186,7 @@ export class ServiceManager {
 
         const displayPath = this.getDisplayPath(environmentCommand, config)
         if (config.output?.verbose) {
-            console.log(`Running environment script: ${displayPath}`)
+            Log.info(`Running environment script: ${displayPath}`)
         }
 
         try {
@@ -244,7 +252,7 @@ export class ServiceManager {
                 }
 
                 if (config.output?.verbose) {
-                    console.log(`✓ Environment script completed - loaded ${Object.keys(envVars).length} variable(s)`)
+                    Log.info(`✓ Environment script completed - loaded ${Object.keys(envVars).length} variable(s)`)
                 }
 
                 // Store environment variables for use by other scripts
@@ -284,7 +292,7 @@ export class ServiceManager {
 
         const displayPath = this.getDisplayPath(globalPrepCommand, config)
         if (config.output?.verbose) {
-            console.log(`Running global prep: ${displayPath}`)
+            Log.info(`Running global prep: ${displayPath}`)
         }
 
         try {
@@ -330,7 +338,7 @@ export class ServiceManager {
             if (timedOut) {
                 throw new Error(`Global prep script '${displayPath}' timed out after ${timeout / 1000}s`)
             } else if (result === 0) {
-                console.log(`✓ Global prep completed successfully: ${displayPath}`)
+                Log.info(`✓ Global prep completed successfully: ${displayPath}`)
             } else {
                 // Show both stdout and stderr for better diagnostics
                 const output = this.combineServiceOutput(stdout, stderr)
@@ -363,7 +371,7 @@ export class ServiceManager {
 
         const displayPath = this.getDisplayPath(prepCommand, config)
         if (config.output?.verbose) {
-            console.log(`Running prep script: ${displayPath}`)
+            Log.info(`Running prep script: ${displayPath}`)
         }
 
         try {
@@ -409,7 +417,7 @@ export class ServiceManager {
             if (timedOut) {
                 throw new Error(`Prep script '${displayPath}' timed out after ${timeout / 1000}s`)
             } else if (result === 0) {
-                console.log(`✓ Prep script completed successfully: ${displayPath}`)
+                Log.info(`✓ Prep script completed successfully: ${displayPath}`)
             } else {
                 // Show both stdout and stderr for better diagnostics
                 const output = this.combineServiceOutput(stdout, stderr)
@@ -422,6 +430,44 @@ export class ServiceManager {
         }
     }
 
+    /**
+     * Gets the key identifying a shareable setup service
+     *
+     * @param config - Test configuration containing service settings
+     * @returns Key of the resolved command, directory and environment, or undefined if services.share is not set
+     *
+     * @remarks
+     * Groups share a service only if it would be started identically: the same resolved command run
+     * from the same config directory with the same environment. The environment is the one the service
+     * is spawned with (environment script, TESTME_* and config variables) minus the variables inherited
+     * unchanged from the runner's process, which are the same for every group.
+     */
+    async getShareKey(config: TestConfig): Promise<string | undefined> {
+        const setupCommand = config.services?.setup
+        if (!setupCommand || !config.services?.share) {
+            return undefined
+        }
+        const cwd = config.configDir || process.cwd()
+        const argv = (await this.parseCommand(setupCommand, cwd, true)).map((arg) =>
+            !isAbsolute(arg) && existsSync(join(cwd, arg)) ? join(cwd, arg) : arg
+        )
+        const environment = Object.entries(await this.getServiceEnvironment(config))
+            .filter(([key, value]) => process.env[key] !== value)
+            .sort(([a], [b]) => a.localeCompare(b))
+        return JSON.stringify({argv, cwd, environment})
+    }
+
+    /**
+     * Creates the manager that runs a shared setup service for this group and the groups sharing it
+     *
+     * @returns Manager with this manager's environment script variables
+     */
+    createSharedManager(): ServiceManager {
+        const manager = new ServiceManager(this.invocationDir)
+        manager.environmentVars = {...this.environmentVars}
+        return manager
+    }
+
     /**
      * Runs the setup command as a background process
      *
@@ -443,7 +489,7 @@ export class ServiceManager {
 
         const displayPath = this.getDisplayPath(setupCommand, config)
         if (config.output?.verbose) {
-            console.log(`Starting setup service: ${displayPath}`)
+            Log.info(`Starting setup service: ${displayPath}`)
         }
 
         try {
@@ -468,9 +514,12 @@ export class ServiceManager {
 
             this.isSetupRunning = true
 
-            // In verbose mode, stream setup service output to console
-            if (config.output?.verbose && this.setupProcess) {
-                this.streamSetupOutput(this.setupProcess)
+            // In verbose mode, stream setup service output to console. With services.ready, read the
+            // output for the readiness line (and keep draining it so the service never blocks on a full pipe)
+            const ready = config.services?.ready
+            let readiness: Promise<void> | undefined
+            if ((config.output?.verbose || ready) && this.setupProcess) {
+                readiness = this.watchSetupOutput(this.setupProcess, config.output?.verbose === true, ready)
             }
 
             // Set up timeout
@@ -480,7 +529,7 @@ export class ServiceManager {
             if (timeout > 0) {
                 timeoutId = setTimeout(() => {
                     timedOut = true
-                    console.log(`✗ Setup command '${displayPath}' timed out after ${timeout / 1000}s`)
+                    Log.info(`✗ Setup command '${displayPath}' timed out after ${timeout / 1000}s`)
                     this.killSetup()
                 }, timeout)
             }
@@ -491,21 +540,28 @@ export class ServiceManager {
                 (config.services as any)?.healthCheck ||
                 (config.services as any)?.healthcheck ||
                 (config.services as any)?.health
+            if (ready && readiness) {
+                // Readiness protocol: await the service announcing it is ready instead of polling
+                try {
+                    await Trace.span('ready', 'health', () => this.waitForReady(readiness, ready, config))
+                } catch (error) {
+                    await this.killSetup(config)
+                    throw error
+                }
+            }
             if (healthCheckConfig) {
                 // Use health check to verify service is ready
                 const healthCheckManager = new HealthCheckManager()
                 try {
-                    await healthCheckManager.waitForHealthy(
-                        healthCheckConfig,
-                        this.setupProcess,
-                        config.output?.verbose
+                    await Trace.span('health check', 'health', () =>
+                        healthCheckManager.waitForHealthy(healthCheckConfig, this.setupProcess, config.output?.verbose)
                     )
                 } catch (error) {
                     // Health check failed - kill the setup process
                     await this.killSetup(config)
                     throw error
                 }
-            } else {
+            } else if (!ready) {
                 // Fall back to setupDelay if no health check configured
                 // Use setupDelay if configured, fall back to legacy 'delay', default to 1 second
                 const initialDelay =
@@ -521,8 +577,10 @@ export class ServiceManager {
             }
 
             // Check if process is still running by checking if exited promise is still pending
+            // A service confirmed ready is only checked for having already exited
+            const settle = ready || healthCheckConfig ? 0 : 100
             const exitPromise = this.setupProcess.exited
-            const timeoutPromise = new Promise((resolve) => setTimeout(() => resolve('timeout'), 100))
+            const timeoutPromise = new Promise((resolve) => setTimeout(() => resolve('timeout'), settle))
             const raceResult = await Promise.race([exitPromise, timeoutPromise])
 
             // If the race resolved to 'timeout', the process is still running
@@ -533,7 +591,7 @@ export class ServiceManager {
 
                 if (!timedOut) {
                     if (config.output?.verbose) {
-                        console.log('✓ Setup service started successfully')
+                        Log.info('✓ Setup service started successfully')
                     }
 
                     // Note: Setup service output is not displayed in real-time to avoid cluttering test output.
@@ -551,7 +609,9 @@ export class ServiceManager {
                 let errorMessage = `Setup process exited immediately with code ${exitCode}`
 
                 // Try to read any output from the process (only if piped, not inherited)
-                if (!config.output?.verbose) {
+                if (!config.output?.verbose && this.setupOutput) {
+                    errorMessage += this.formatSetupOutput()
+                } else if (!config.output?.verbose) {
                     try {
                         let stdout = ''
                         let stderr = ''
@@ -608,56 +668,103 @@ export class ServiceManager {
     }
 
     /**
-     * Streams setup service output to console in the background
-     * Does not wait for the process to complete - output is streamed asynchronously
+     * Reads setup service output in the background
      *
-     * @param proc - The subprocess to stream output from
+     * @param proc - The setup subprocess
+     * @param verbose - Stream the output to the console
+     * @param ready - Readiness text to look for on stdout or stderr
+     * @returns Promise resolving when the readiness text appears (never resolves without ready)
+     *
+     * @remarks
+     * Does not wait for the process to complete. The last SETUP_OUTPUT_LIMIT characters of each
+     * stream are kept so errors can show them.
      * @internal
      */
-    private streamSetupOutput(proc: Bun.Subprocess): void {
-        // Stream stdout asynchronously
-        if (proc.stdout && typeof proc.stdout !== 'number') {
-            const stdoutReader = proc.stdout.getReader()
+    private watchSetupOutput(proc: Bun.Subprocess, verbose: boolean, ready?: string): Promise<void> {
+        const output = {stdout: '', stderr: ''}
+        this.setupOutput = output
+        let announce = () => {}
+        const announced = new Promise<void>((resolve) => (announce = resolve))
+
+        const read = (stream: ReadableStream<Uint8Array>, name: 'stdout' | 'stderr') => {
+            const reader = stream.getReader()
             const decoder = new TextDecoder()
 
             // Don't await - let it run in background
             ;(async () => {
                 try {
                     while (true) {
-                        const {done, value} = await stdoutReader.read()
+                        const {done, value} = await reader.read()
                         if (done) break
                         const text = decoder.decode(value, {stream: true})
-                        process.stdout.write(text)
+                        if (verbose) {
+                            ;(name === 'stdout' ? Log.stream : process.stderr).write(text)
+                        }
+                        // Search the end of earlier output too, as the text may span chunks
+                        const recent = ready ? output[name].slice(-(ready.length - 1)) + text : ''
+                        output[name] = (output[name] + text).slice(-SETUP_OUTPUT_LIMIT)
+                        if (ready && recent.includes(ready)) {
+                            announce()
+                        }
                     }
                 } catch (error) {
                     // Ignore errors - process may have been killed
                 } finally {
-                    stdoutReader.releaseLock()
+                    reader.releaseLock()
                 }
             })()
         }
 
-        // Stream stderr asynchronously
+        if (proc.stdout && typeof proc.stdout !== 'number') {
+            read(proc.stdout, 'stdout')
+        }
         if (proc.stderr && typeof proc.stderr !== 'number') {
-            const stderrReader = proc.stderr.getReader()
-            const decoder = new TextDecoder()
+            read(proc.stderr, 'stderr')
+        }
+        return announced
+    }
 
-            // Don't await - let it run in background
-            ;(async () => {
-                try {
-                    while (true) {
-                        const {done, value} = await stderrReader.read()
-                        if (done) break
-                        const text = decoder.decode(value, {stream: true})
-                        process.stderr.write(text)
-                    }
-                } catch (error) {
-                    // Ignore errors - process may have been killed
-                } finally {
-                    stderrReader.releaseLock()
-                }
-            })()
+    /**
+     * Waits for the setup service to write its readiness text
+     *
+     * @param readiness - Promise from watchSetupOutput()
+     * @param ready - Readiness text (services.ready)
+     * @param config - Test configuration containing service settings
+     *
+     * @remarks
+     * Rejects if the service exits first, including when setupTimeout kills it.
+     * @internal
+     */
+    private async waitForReady(readiness: Promise<void>, ready: string, config: TestConfig): Promise<void> {
+        const proc = this.setupProcess!
+        const exited = proc.exited.then((code) => {
+            const verbose = config.output?.verbose
+            const output = verbose ? '\n(Output was displayed above in verbose mode)' : this.formatSetupOutput()
+            throw new Error(`Setup process exited with code ${code} before writing "${ready}"${output}`)
+        })
+        if (config.output?.verbose) {
+            Log.info(`⏳ Waiting for setup service to write "${ready}"...`)
+        }
+        await Promise.race([readiness, exited])
+        if (config.output?.verbose) {
+            Log.info('✓ Setup service is ready')
+        }
+    }
+
+    /**
+     * Formats the setup service output kept by watchSetupOutput() for an error message
+     *
+     * @internal
+     */
+    private formatSetupOutput(): string {
+        const {stdout, stderr} = this.setupOutput ?? {stdout: '', stderr: ''}
+        if (!stdout && !stderr) {
+            return ''
         }
+        let message = '\n\nProcess output:'
+        if (stdout) message += `\nSTDOUT:\n${stdout}`
+        if (stderr) message += `\nSTDERR:\n${stderr}`
+        return message
     }
 
     /**
@@ -683,7 +790,7 @@ export class ServiceManager {
 
         const displayPath = this.getDisplayPath(globalCleanupCommand, config)
         if (config.output?.verbose) {
-            console.log(`Running global cleanup: ${displayPath}`)
+            Log.info(`Running global cleanup: ${displayPath}`)
         }
 
         try {
@@ -733,9 +840,9 @@ export class ServiceManager {
             }
 
             if (timedOut) {
-                console.log(`✗ Global cleanup command '${displayPath}' timed out after ${timeout / 1000}s`)
+                Log.info(`✗ Global cleanup command '${displayPath}' timed out after ${timeout / 1000}s`)
             } else if (result === 0) {
-                console.log(`✓ Global cleanup completed successfully: ${displayPath}`)
+                Log.info(`✓ Global cleanup completed successfully: ${displayPath}`)
             } else {
                 // Show both stdout and stderr for better diagnostics
                 const output = this.combineServiceOutput(stdout, stderr)
@@ -777,7 +884,7 @@ export class ServiceManager {
 
         const displayPath = this.getDisplayPath(cleanupCommand, config)
         if (config.output?.verbose) {
-            console.log(`Running cleanup: ${displayPath}`)
+            Log.info(`Running cleanup: ${displayPath}`)
         }
 
         try {
@@ -827,9 +934,9 @@ export class ServiceManager {
             }
 
             if (timedOut) {
-                console.log(`✗ Cleanup command '${displayPath}' timed out after ${timeout / 1000}s`)
+                Log.info(`✗ Cleanup command '${displayPath}' timed out after ${timeout / 1000}s`)
             } else if (result === 0) {
-                console.log(`✓ Cleanup completed successfully: ${displayPath}`)
+                Log.info(`✓ Cleanup completed successfully: ${displayPath}`)
             } else {
                 // Show both stdout and stderr for better diagnostics
                 const output = this.combineServiceOutput(stdout, stderr)
@@ -1005,7 +1112,7 @@ export class ServiceManager {
                 // If we get here, the setup process exited while tests were running
                 // Only warn if exit code is non-zero (failure) and verbose is enabled
                 if (this.isSetupRunning && config.output?.verbose && exitCode !== 0) {
-                    console.log(`\n⚠️  Setup process exited unexpectedly with code ${exitCode}`)
+                    Log.info(`\n⚠️  Setup process exited unexpectedly with code ${exitCode}`)
                 }
                 this.isSetupRunning = false
             } catch (error) {
@@ -1,16 +1,35 @@
 import type {HealthCheckConfig} from '../types.ts'
+import {Log} from '../utils/log.ts'
+import {watch} from 'fs'
+import {dirname, resolve} from 'path'
+
+// First retry delay in ms. Retries back off exponentially to the configured interval.
+const MIN_INTERVAL = 0.25
+
+// First retry delay in ms for script checks, which start a process per attempt
+const MIN_SCRIPT_INTERVAL = 10
+
+/*
+ Notifies changes in a watched directory
+ */
+type ChangeWatcher = {
+    changed: () => Promise<void> // Resolves on the next change
+    close: () => void
+}
 
 /*
  HealthCheckManager - Manages service health checking
 
  Responsibilities:
  - Execute health checks using configured method (HTTP, TCP, script, file)
- - Poll at specified intervals until service is healthy or timeout
+ - Retry with adaptive backoff until service is healthy or timeout
  - Return success when service is confirmed ready
 
  Architecture:
  - Strategy pattern for different health check types
- - Polling loop with configurable interval
+ - Retry loop starting at sub-millisecond delays and doubling up to the configured interval, so
+   services that start in a few milliseconds are not charged a full interval
+ - File checks also wake on directory change notifications; HTTP checks reuse keep-alive connections
  - Timeout handling with clear error messages
  */
 export class HealthCheckManager {
@@ -26,7 +45,7 @@ export class HealthCheckManager {
         setupProcess: Bun.Subprocess | null = null,
         verbose: boolean = false
     ): Promise<void> {
-        const interval = config.interval ?? 100 // Default 100ms
+        const interval = config.interval ?? 100 // Maximum delay between attempts (default 100ms)
         const timeout = (config.timeout ?? 30) * 1000 // Default 30s, convert to ms
         const startTime = Date.now()
 
@@ -34,47 +53,62 @@ export class HealthCheckManager {
         const type = config.type ?? 'http'
 
         if (verbose) {
-            console.log(`⏳ Waiting for service to be healthy (${type} check, timeout: ${timeout / 1000}s)...`)
+            Log.info(`⏳ Waiting for service to be healthy (${type} check, timeout: ${timeout / 1000}s)...`)
         }
 
         let attemptCount = 0
         let lastError: string | null = null
+        let delay = Math.min(type === 'script' ? MIN_SCRIPT_INTERVAL : MIN_INTERVAL, interval)
 
-        while (Date.now() - startTime < timeout) {
-            // Check if setup process has exited
-            if (setupProcess) {
-                const exitPromise = setupProcess.exited
-                const timeoutPromise = new Promise((resolve) => setTimeout(() => resolve('timeout'), 10))
-                const raceResult = await Promise.race([exitPromise, timeoutPromise])
+        // Watch for the setup process exiting instead of polling it before every attempt
+        let exitCode: number | undefined
+        const exited = setupProcess?.exited.then((code) => {
+            exitCode = typeof code === 'number' ? code : -1
+        })
 
-                // If the process has exited, stop health checks
-                if (raceResult !== 'timeout') {
-                    const exitCode = typeof raceResult === 'number' ? raceResult : -1
+        // File checks wake as soon as the file's directory changes
+        const path = (config as {path?: string}).path
+        const watcher = type === 'file' && path ? this.watchDirectory(dirname(resolve(path))) : undefined
+
+        try {
+            while (Date.now() - startTime < timeout) {
+                // Stop health checks if the setup process has exited
+                if (exitCode !== undefined) {
                     throw new Error(`Setup process exited with code ${exitCode} during health check`)
                 }
-            }
 
-            attemptCount++
+                attemptCount++
+                const changed = watcher?.changed() // Before the check, so a change during it is not missed
 
-            try {
-                const isHealthy = await this.checkHealth(config, type)
+                try {
+                    const isHealthy = await this.checkHealth(config, type)
 
-                if (isHealthy) {
-                    if (verbose) {
-                        const elapsed = ((Date.now() - startTime) / 1000).toFixed(2)
-                        console.log(`✓ Service is healthy (${elapsed}s, ${attemptCount} attempts)`)
+                    if (isHealthy) {
+                        if (verbose) {
+                            const elapsed = ((Date.now() - startTime) / 1000).toFixed(2)
+                            Log.info(`✓ Service is healthy (${elapsed}s, ${attemptCount} attempts)`)
+                        }
+                        return // Success!
+                    }
+                } catch (error) {
+                    lastError = error instanceof Error ? error.message : String(error)
+                    if (verbose && attemptCount === 1) {
+                        Log.info(`  Checking... (will retry with backoff up to ${interval}ms)`)
                     }
-                    return // Success!
-                }
-            } catch (error) {
-                lastError = error instanceof Error ? error.message : String(error)
-                if (verbose && attemptCount === 1) {
-                    console.log(`  Checking... (will retry every ${interval}ms)`)
                 }
+
+                // Wait before the next check, waking early if the setup process exits or the file appears
+                const remaining = Math.max(0, timeout - (Date.now() - startTime))
+                const pause = new Promise((resolve) => setTimeout(resolve, Math.min(delay, remaining)))
+                await Promise.race([pause, ...(exited ? [exited] : []), ...(changed ? [changed] : [])])
+                delay = Math.min(delay * 2, interval)
             }
+        } finally {
+            watcher?.close()
+        }
 
-            // Wait before next check
-            await new Promise((resolve) => setTimeout(resolve, interval))
+        if (exitCode !== undefined) {
+            throw new Error(`Setup process exited with code ${exitCode} during health check`)
         }
 
         // Timeout reached
@@ -113,11 +147,9 @@ export class HealthCheckManager {
         const expectedStatus = config.expectedStatus ?? 200
 
         try {
+            // Keep-alive: once the service accepts connections, later attempts reuse the connection
             const response = await fetch(config.url, {
                 method: 'GET',
-                headers: {
-                    Connection: 'close',
-                },
                 signal: AbortSignal.timeout(5000), // 5s timeout per request
             })
 
@@ -195,6 +227,26 @@ export class HealthCheckManager {
         }
     }
 
+    /*
+     Watches a directory for changes
+     @param directory Directory to watch
+     @returns Change watcher, or undefined if the directory cannot be watched (checks fall back to backoff)
+     */
+    private watchDirectory(directory: string): ChangeWatcher | undefined {
+        let notify = () => {}
+        let next = new Promise<void>((resolve) => (notify = resolve))
+        try {
+            const watcher = watch(directory, () => {
+                notify()
+                next = new Promise<void>((resolve) => (notify = resolve))
+            })
+            watcher.on('error', () => notify())
+            return {changed: () => next, close: () => watcher.close()}
+        } catch {
+            return undefined
+        }
+    }
+
     /*
      File existence health check
      @param config File health check configuration
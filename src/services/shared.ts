@@ -0,0 +1,119 @@
+import type {TestConfig} from '../types.ts'
+import type {ServiceManager} from '../services.ts'
+import {Log} from '../utils/log.ts'
+
+/*
+ A shared setup service and the groups using it
+ */
+type SharedService = {
+    manager: ServiceManager // Manager owning the setup process
+    config: TestConfig // Configuration of the group that started the service
+    started: Promise<void> // Resolves when the service is ready
+    refs: number // Groups using the service
+}
+
+/*
+ SharedServices - Setup services shared by configuration groups
+
+ Responsibilities:
+ - Start a shareable setup service (services.share) once for every group with the same key
+ - Count the groups using each service
+ - Stop a service when its last group finishes and no more groups will start
+
+ Architecture:
+ - Services are keyed by ServiceManager.getShareKey() (resolved command, directory and environment)
+ - Each service has its own ServiceManager, so a group's cleanup never stops a shared service
+ - A run retains unused services until every group is past its setup; watch mode keeps them until it exits
+ */
+export class SharedServices {
+    private services = new Map<string, SharedService>()
+    private retained = 0
+
+    /*
+     Uses a shared service, starting it if no group has
+     @param key Service key from ServiceManager.getShareKey()
+     @param config Group configuration with CLI overrides and environment script variables applied
+     @param create Creates the manager that starts the service
+     @returns Promise that resolves when the service is ready
+     */
+    async acquire(key: string, config: TestConfig, create: () => ServiceManager): Promise<void> {
+        let service = this.services.get(key)
+        if (!service) {
+            const manager = create()
+            service = {manager, config, started: manager.runSetup(config), refs: 0}
+            this.services.set(key, service)
+            if (config.output?.verbose) {
+                Log.info(`Sharing setup service: ${config.services?.setup}`)
+            }
+        }
+        service.refs++
+        try {
+            await service.started
+        } catch (error) {
+            // A service that failed to start is started afresh by the next group using it
+            service.refs--
+            if (this.services.get(key) === service) {
+                this.services.delete(key)
+            }
+            throw error
+        }
+    }
+
+    /*
+     Releases a group's use of a shared service
+     The service stops if no other group uses it and the run has no more groups to start.
+     @param key Service key passed to acquire()
+     */
+    async release(key: string): Promise<void> {
+        const service = this.services.get(key)
+        if (service && --service.refs <= 0 && this.retained === 0) {
+            await this.stop(key, service)
+        }
+    }
+
+    /*
+     Keeps unused services running until unretain() (while groups of a run may still start them)
+     */
+    retain(): void {
+        this.retained++
+    }
+
+    /*
+     Ends a retain() and stops the services no group is using
+     */
+    async unretain(): Promise<void> {
+        if (--this.retained > 0) {
+            return
+        }
+        for (const [key, service] of [...this.services]) {
+            if (service.refs <= 0) {
+                await this.stop(key, service)
+            }
+        }
+    }
+
+    /*
+     Stops every shared service (end of a run or of watch mode)
+     */
+    async stopAll(): Promise<void> {
+        this.retained = 0
+        for (const [key, service] of [...this.services]) {
+            await this.stop(key, service)
+        }
+    }
+
+    /*
+     Stops a shared service
+     @param key Service key
+     @param service Shared service
+     */
+    private async stop(key: string, service: SharedService): Promise<void> {
+        this.services.delete(key)
+        try {
+            await service.started
+        } catch {
+            return // Never started
+        }
+        await service.manager.killSetup(service.config)
+    }
+}
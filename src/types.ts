@@ -26,8 +26,64 @@ export type TestResult = {
         passed: number
         failed: number
     }
+    benchmarks?: BenchmarkResult[] // Benchmark records parsed from TESTME_BENCH output lines
+    perf?: PerfResult[] // Counter regions parsed from TESTME_PERF output lines (tPerfBegin/tPerfEnd)
+    resources?: ResourceUsage // Resources used by the test process (total of repeated runs, peak memory of any run)
 }
 
+/*
+ Resources used by a test process (wait4 rusage on POSIX, process counters on Windows)
+ */
+export type ResourceUsage = {
+    maxRss: number // Peak resident memory in bytes
+    userCpu: number // User CPU time in milliseconds
+    systemCpu: number // System CPU time in milliseconds
+    voluntarySwitches: number // Context switches while waiting (I/O, locks, sleeps)
+    involuntarySwitches: number // Context switches when preempted
+}
+
+/*
+ Benchmark record emitted by testme.h tbench()/tBenchmark() (times in nanoseconds per operation)
+ */
+export type BenchmarkResult = {
+    name: string
+    nsPerOp: number // Mean nanoseconds per operation
+    opsPerSec: number
+    min: number
+    p50: number
+    p90: number
+    p99: number
+    max: number
+    samples: number // Number of timed samples
+    iterations: number // Total timed iterations
+    baseline?: number // Baseline value of the compared metric
+    change?: number // Percent change of the compared metric versus baseline (positive is slower)
+    regressed?: boolean // True if change exceeds the configured threshold
+}
+
+/*
+ Counter region recorded by testme.h tPerfBegin()/tPerfEnd(), totals of every run of the region
+ Hardware counters are absent where perf_event_open is unavailable (only ns is recorded).
+ */
+export type PerfResult = {
+    name: string
+    count: number // Number of times the region ran
+    ns: number // Elapsed nanoseconds
+    cycles?: number
+    instructions?: number
+    cacheMisses?: number
+    branchMisses?: number
+    metric?: PerfMetric // Metric compared against baseline
+    baseline?: number // Baseline value of the metric per run of the region
+    change?: number // Percent change of the metric per run versus baseline (positive is more)
+    regressed?: boolean // True if change exceeds the configured threshold
+}
+
+/*
+ Counter region metric compared against baseline
+ */
+export type PerfMetric = 'instructions' | 'cycles' | 'cacheMisses' | 'branchMisses' | 'ns'
+
 /*
  Main configuration for the test runner
  */
@@ -42,6 +98,7 @@ export type TestConfig = {
     output?: OutputConfig
     patterns?: PatternConfig
     services?: ServiceConfig
+    benchmarks?: BenchmarkConfig // Benchmark baseline comparison and regression gating
     environment?: EnvironmentConfig // Environment variables (replaces 'env')
     env?: EnvironmentConfig // Deprecated: use 'environment' instead (supported for backward compatibility)
     configDir?: string // Directory containing the config file
@@ -83,12 +140,30 @@ export type CompilerConfig = {
         gcc?: CompilerSettings
         clang?: CompilerSettings
         msvc?: CompilerSettings
+        cache?: CompileCacheConfig // Shared content-addressed binary cache
+        unity?: boolean // Compile the TM_TEST() tests of a directory into one binary (default: false)
+        pch?: boolean // Precompile testme.h once per compiler and flag set (default: false)
+        sanitize?: string[] // Build with sanitizers: address, undefined, thread, leak, memory (--sanitize)
+        coverage?: boolean // Build with line coverage and write an LCOV report when the run ends (--coverage)
     }
     es?: {
         require?: string | string[]
     }
 }
 
+/*
+ Configuration for the content-addressed C compile cache
+ */
+export type CompileCacheConfig = {
+    enable?: boolean // Fetch and store binaries in the shared cache (default: false)
+    dir?: string // Local cache directory (default: $XDG_CACHE_HOME/testme or ~/.cache/testme)
+    url?: string // Remote cache endpoint - binaries are fetched with GET <url>/<key>
+    upload?: boolean // Upload newly compiled binaries with PUT <url>/<key> (default: false)
+    headers?: Record<string, string> // Request headers for the remote cache (${VAR} expands env vars)
+    inputs?: string[] // Extra files hashed into the key, such as libraries linked into tests (glob patterns)
+    maxSize?: number // Local cache size in MB - least recently used entries are evicted (default: 1024, 0: no limit)
+}
+
 /*
  Platform-specific debugger map type
  */
@@ -118,7 +193,16 @@ export type DebugConfig = {
 export type ExecutionConfig = {
     timeout: number // Timeout per test in seconds
     parallel: boolean
-    workers?: number
+    workers?: number // Tests run at once, limited by cores and free memory (default: CPU cores)
+    compileWorkers?: number // Parallel C compiles ahead of execution (default: CPU cores)
+    groups?: number // Configuration groups run at once, sharing the workers and compile slots (default: 1)
+    cpu?: number // CPU cores each test uses, scheduled against the detected core count (default: 1)
+    memory?: number // Memory each test needs in MB, scheduled against free memory (default: 0)
+    exclusive?: boolean // Run each test alone with no other tests in parallel
+    maxRss?: number // Fail a test whose process uses more than this many MB of resident memory
+    maxCpu?: number // Fail a test whose process uses more than this many seconds of user plus system CPU
+    history?: boolean // Order tests using recorded durations and failures (default: true)
+    inProcess?: boolean // Run JS/TS tests on warm Bun worker threads instead of separate processes (default: false)
     keepArtifacts?: boolean
     rebuild?: boolean // Force recompilation of C tests even if binary is up-to-date
     stepMode?: boolean
@@ -127,9 +211,22 @@ export type ExecutionConfig = {
     showCommands?: boolean
     showWarnings?: boolean // Show compiler warnings and compile command line
     iterations?: number
+    repeat?: number // Run each test this many times, stopping at the first failed run (default: 1)
+    forkServer?: boolean // Repeat C tests by forking a checkpointed test process instead of re-executing it
     stopOnFailure?: boolean // Stop testing as soon as a test fails
     duration?: number // Duration in seconds (exported as TESTME_DURATION)
     testClass?: string // Test class filter (exported as TESTME_CLASS)
+    saveBaseline?: boolean // Save benchmark results as the new baseline
+}
+
+/*
+ Configuration for benchmark baselines and regression gating
+ */
+export type BenchmarkConfig = {
+    threshold?: number // Fail the test if a benchmark is slower than baseline by more than this percent
+    metric?: 'nsPerOp' | 'p50' | 'p90' | 'p99' | 'min' // Metric compared against baseline (default: p50)
+    baselineDir?: string // Directory for baseline files (relative to config dir, default: test artifact dir)
+    perfMetric?: PerfMetric // Metric compared for tPerfBegin/tPerfEnd regions (default: instructions, else ns)
 }
 
 /*
@@ -142,6 +239,8 @@ export type OutputConfig = {
     quiet?: boolean
     errorsOnly?: boolean
     live?: boolean // Stream test output in real-time to console (requires TTY)
+    quietPass?: boolean // Count passing assertions silently (exported as TESTME_QUIET_PASS)
+    captureLimit?: number // MB of stdout and of stderr kept in memory per test; beyond it, head and tail (default: 16)
 }
 
 /*
@@ -150,6 +249,7 @@ export type OutputConfig = {
 export type PatternConfig = {
     include: string[]
     exclude: string[]
+    index?: boolean // Cache discovery in .testme/discovery.json keyed by directory mtimes (default: false)
     windows?: {
         include?: string[]
         exclude?: string[]
@@ -184,6 +284,8 @@ export type ServiceConfig = {
     globalCleanupTimeout?: number // Global cleanup timeout in seconds
     delay?: number // DEPRECATED: Use setupDelay instead (kept for backward compatibility)
     setupDelay?: number // Delay in seconds after setup before running tests (default: 1)
+    ready?: string // Text the setup service writes to stdout or stderr when ready (replaces setupDelay)
+    share?: boolean // Start the setup service once for all groups with the same command and environment
     shutdownTimeout?: number // Wait time in seconds for graceful shutdown before SIGKILL (default: 5)
     healthCheck?: HealthCheckConfig // Health check configuration to verify service readiness
 }
@@ -193,7 +295,7 @@ export type ServiceConfig = {
  */
 export type HealthCheckConfig = {
     type?: 'http' | 'tcp' | 'script' | 'file' // Health check type (default: http)
-    interval?: number // Poll interval in milliseconds (default: 100)
+    interval?: number // Maximum delay between attempts in milliseconds, reached by backoff (default: 100)
     timeout?: number // Maximum wait time in seconds (default: 30)
 } & (
     | {type?: 'http'; url: string; expectedStatus?: number; expectedBody?: string}
@@ -253,11 +355,22 @@ export type CliOptions = {
     continue: boolean
     noServices: boolean
     iterations?: number
+    repeat?: number // Run each test N times (--repeat)
     stop: boolean
     live: boolean
     duration?: number // Duration in seconds
     timeout?: number // Timeout in seconds (overrides config)
     testClass?: string // Test class filter (exports TESTME_CLASS)
+    saveBaseline?: boolean // Save benchmark results as the new baseline
+    shard?: {index: number; total: number} // Run only shard index of total (--shard i/N)
+    shardTimings?: string // JSON report supplying durations for shard balancing
+    merge?: boolean // Merge JSON reports named by patterns instead of running tests
+    trace?: string // Chrome trace-event file recording run phases and test stages (--trace)
+    ndjson?: string // Report file streaming one JSON line per completed test (--ndjson)
+    junit?: string // JUnit XML report file written as tests complete (--junit)
+    sanitize?: string[] // Sanitizers to build C tests with (--sanitize)
+    coverage?: boolean // Build C tests with line coverage (--coverage)
+    watch: boolean // Keep running and re-run tests affected by file changes
 }
 
 /*
@@ -302,6 +415,7 @@ export enum TestStatus {
 export type TestHandler = {
     canHandle(file: TestFile): boolean
     prepare?(file: TestFile): Promise<void>
+    build?(file: TestFile, config: TestConfig): Promise<void> // Compile ahead of execute() (compile pool)
     execute(file: TestFile, config: TestConfig): Promise<TestResult>
     cleanup?(file: TestFile, config?: TestConfig): Promise<void>
 }
@@ -313,6 +427,7 @@ export type DiscoveryOptions = {
     rootDir: string
     patterns: string[]
     excludePatterns: string[]
+    index?: boolean // Reuse and update the discovery index (patterns.index)
 }
 
 /*
@@ -322,5 +437,6 @@ export type ArtifactManager = {
     createArtifactDir(testFile: TestFile): Promise<string>
     cleanArtifactDir(testFile: TestFile): Promise<void>
     cleanAllArtifacts(rootDir: string): Promise<void>
+    flush(): Promise<void>
     getArtifactPath(testFile: TestFile, filename: string): string
 }
@@ -3,6 +3,8 @@
 
     Responsibilities:
     - Parse test output for ✓ (pass) and ✗ (fail) symbols
+    - Parse TESTME_PASSED=N summary lines emitted by testme.h in quiet-pass mode
+    - Parse TESTME_OMITTED lines summarizing assertions in output dropped by OutputCapture
     - Return assertion counts
 */
 
@@ -11,6 +13,12 @@ export type AssertionCounts = {
     failed: number
 }
 
+// Summary line emitted at exit by testme.h when TESTME_QUIET_PASS is set
+const QUIET_PASS_SUMMARY = /^TESTME_PASSED=(\d+)\s*$/gm
+
+// Assertions in the middle of oversized output that was not kept in memory
+const OMITTED_SUMMARY = /^TESTME_OMITTED passed=(\d+) failed=(\d+)\s*$/gm
+
 /**
  * Count test assertions from output by looking for ✓ and ✗ symbols
  *
@@ -24,11 +32,22 @@ export function countAssertions(output: string): AssertionCounts | null {
 
     // Count ✓ symbols (pass)
     const passedMatches = output.match(/✓/g)
-    const passed = passedMatches ? passedMatches.length : 0
+    let passed = passedMatches ? passedMatches.length : 0
+
+    // Add silently counted passes from quiet-pass summary lines (TESTME_PASSED=N)
+    for (const match of output.matchAll(QUIET_PASS_SUMMARY)) {
+        passed += parseInt(match[1]!, 10)
+    }
 
     // Count ✗ symbols (fail)
     const failedMatches = output.match(/✗/g)
-    const failed = failedMatches ? failedMatches.length : 0
+    let failed = failedMatches ? failedMatches.length : 0
+
+    // Add assertions from output omitted by bounded capture (TESTME_OMITTED passed=N failed=M)
+    for (const match of output.matchAll(OMITTED_SUMMARY)) {
+        passed += parseInt(match[1]!, 10)
+        failed += parseInt(match[2]!, 10)
+    }
 
     // Only return counts if we found at least one assertion marker
     if (passed === 0 && failed === 0) {
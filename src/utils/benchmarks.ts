@@ -0,0 +1,219 @@
+/*
+    benchmarks.ts - Parse and compare benchmark records from test output
+
+    Responsibilities:
+    - Parse TESTME_BENCH {json} lines emitted by testme.h tbench()/tBenchmark() and JS tests
+    - Compare benchmark results against a saved baseline
+    - Flag benchmarks that regress beyond the configured threshold
+    - Parse TESTME_PERF {json} counter region records emitted by testme.h tPerfBegin()/tPerfEnd() and
+      compare them against the baseline the same way
+*/
+
+import type {BenchmarkConfig, BenchmarkResult, PerfMetric, PerfResult} from '../types.ts'
+
+// Benchmark record line: TESTME_BENCH {"name":"...","nsPerOp":...}
+const BENCHMARK_RECORD = /^TESTME_BENCH (\{.*\})\s*$/gm
+
+// Counter region record line: TESTME_PERF {"name":"...","ns":...,"instructions":...}
+const PERF_RECORD = /^TESTME_PERF (\{.*\})\s*$/gm
+
+// Hardware counters of a region record (absent when perf_event_open is unavailable)
+const PERF_COUNTERS = ['cycles', 'instructions', 'cacheMisses', 'branchMisses'] as const
+
+// Metric compared against the baseline when not configured
+const DEFAULT_METRIC = 'p50'
+
+// Counter region metric compared against the baseline when not configured (stable across noisy runners)
+const DEFAULT_PERF_METRIC = 'instructions'
+
+/**
+ * Parse benchmark records from test output
+ *
+ * @param output - Test output string
+ * @returns Array of benchmark results, or null if no records found
+ */
+export function parseBenchmarks(output: string): BenchmarkResult[] | null {
+    if (!output || !output.includes('TESTME_BENCH')) {
+        return null
+    }
+
+    const benchmarks: BenchmarkResult[] = []
+    for (const match of output.matchAll(BENCHMARK_RECORD)) {
+        try {
+            const record = JSON.parse(match[1]!)
+            if (typeof record.name === 'string' && typeof record.nsPerOp === 'number') {
+                benchmarks.push(record as BenchmarkResult)
+            }
+        } catch {
+            // Ignore malformed records (e.g. truncated output)
+        }
+    }
+    return benchmarks.length > 0 ? benchmarks : null
+}
+
+/**
+ * Compare benchmarks against a baseline and annotate each with its change
+ *
+ * @param benchmarks - Current benchmark results (annotated in place)
+ * @param baseline - Baseline benchmark results from a previous run
+ * @param config - Benchmark configuration with metric and threshold
+ * @returns Benchmarks that regressed beyond the threshold
+ *
+ * @remarks
+ * Change is the percentage increase of the metric (ns/op) over the baseline, so positive values are slower.
+ * Without a threshold, changes are recorded but nothing is flagged as regressed.
+ */
+export function compareBenchmarks(
+    benchmarks: BenchmarkResult[],
+    baseline: BenchmarkResult[],
+    config?: BenchmarkConfig
+): BenchmarkResult[] {
+    const metric = config?.metric ?? DEFAULT_METRIC
+    const threshold = config?.threshold
+    const previous = new Map(baseline.map((b) => [b.name, b]))
+    const regressions: BenchmarkResult[] = []
+
+    for (const benchmark of benchmarks) {
+        const base = previous.get(benchmark.name)
+        const baseValue = base?.[metric]
+        const value = benchmark[metric]
+        if (typeof baseValue !== 'number' || typeof value !== 'number' || baseValue <= 0) {
+            continue
+        }
+        benchmark.baseline = baseValue
+        benchmark.change = ((value - baseValue) / baseValue) * 100
+        if (threshold !== undefined && benchmark.change > threshold) {
+            benchmark.regressed = true
+            regressions.push(benchmark)
+        }
+    }
+    return regressions
+}
+
+/**
+ * Format a benchmark regression message
+ *
+ * @param regressions - Regressed benchmarks from compareBenchmarks()
+ * @param config - Benchmark configuration with metric and threshold
+ * @returns Multi-line message describing each regression
+ */
+export function formatRegressions(regressions: BenchmarkResult[], config?: BenchmarkConfig): string {
+    const metric = config?.metric ?? DEFAULT_METRIC
+    const lines = regressions.map(
+        (b) =>
+            `  ${b.name}: ${metric} ${b.baseline!.toFixed(3)} ns -> ${b[metric].toFixed(3)} ns ` +
+            `(+${b.change!.toFixed(1)}%, threshold ${config?.threshold}%)`
+    )
+    return `Benchmark regression detected:\n${lines.join('\n')}`
+}
+
+/**
+ * Parse counter region records from test output
+ *
+ * @remarks
+ * Records of regions with the same name are combined: times and counters are summed and count is
+ * the number of records. A counter missing from any record of a region is dropped for that region.
+ *
+ * @param output - Test output string
+ * @returns Array of regions in order of first appearance, or null if no records found
+ */
+export function parsePerfRecords(output: string): PerfResult[] | null {
+    if (!output || !output.includes('TESTME_PERF')) {
+        return null
+    }
+
+    const regions = new Map<string, PerfResult>()
+    for (const match of output.matchAll(PERF_RECORD)) {
+        let record: Record<string, unknown>
+        try {
+            record = JSON.parse(match[1]!)
+        } catch {
+            continue // Ignore malformed records (e.g. truncated output)
+        }
+        if (typeof record.name !== 'string' || typeof record.ns !== 'number') {
+            continue
+        }
+        const region = regions.get(record.name)
+        if (!region) {
+            const added: PerfResult = {name: record.name, count: 1, ns: record.ns}
+            for (const counter of PERF_COUNTERS) {
+                if (typeof record[counter] === 'number') {
+                    added[counter] = record[counter] as number
+                }
+            }
+            regions.set(record.name, added)
+            continue
+        }
+        region.count++
+        region.ns += record.ns
+        for (const counter of PERF_COUNTERS) {
+            const total = region[counter]
+            const value = record[counter]
+            if (total !== undefined && typeof value === 'number') {
+                region[counter] = total + value
+            } else {
+                delete region[counter]
+            }
+        }
+    }
+    return regions.size > 0 ? [...regions.values()] : null
+}
+
+/**
+ * Compare counter regions against a baseline and annotate each with its change
+ *
+ * @param regions - Current counter regions (annotated in place)
+ * @param baseline - Baseline counter regions from a previous run
+ * @param config - Benchmark configuration with perfMetric and threshold
+ * @returns Regions that regressed beyond the threshold
+ *
+ * @remarks
+ * Regions are compared per run of the region, so a region that runs a different number of times is
+ * still comparable. If the configured counter is missing from either side (counters unavailable on
+ * this or the baseline's machine), elapsed time is compared instead.
+ */
+export function comparePerf(regions: PerfResult[], baseline: PerfResult[], config?: BenchmarkConfig): PerfResult[] {
+    const threshold = config?.threshold
+    const previous = new Map(baseline.map((b) => [b.name, b]))
+    const regressions: PerfResult[] = []
+
+    for (const region of regions) {
+        const base = previous.get(region.name)
+        if (!base || !(base.count > 0)) {
+            continue
+        }
+        let metric: PerfMetric = config?.perfMetric ?? DEFAULT_PERF_METRIC
+        if (typeof region[metric] !== 'number' || typeof base[metric] !== 'number') {
+            metric = 'ns'
+        }
+        const baseValue = (base[metric] ?? 0) / base.count
+        const value = region[metric]! / region.count
+        if (!(baseValue > 0)) {
+            continue
+        }
+        region.metric = metric
+        region.baseline = baseValue
+        region.change = ((value - baseValue) / baseValue) * 100
+        if (threshold !== undefined && region.change > threshold) {
+            region.regressed = true
+            regressions.push(region)
+        }
+    }
+    return regressions
+}
+
+/**
+ * Format a counter region regression message
+ *
+ * @param regressions - Regressed regions from comparePerf()
+ * @param config - Benchmark configuration with threshold
+ * @returns Multi-line message describing each regression
+ */
+export function formatPerfRegressions(regressions: PerfResult[], config?: BenchmarkConfig): string {
+    const lines = regressions.map(
+        (r) =>
+            `  ${r.name}: ${r.metric} ${r.baseline!.toFixed(0)} -> ${(r[r.metric!]! / r.count).toFixed(0)} per run ` +
+            `(+${r.change!.toFixed(1)}%, threshold ${config?.threshold}%)`
+    )
+    return `Counter regression detected:\n${lines.join('\n')}`
+}
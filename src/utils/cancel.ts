@@ -0,0 +1,119 @@
+/*
+    cancel.ts - Cancellation of running tests and compiles (fast-fail and interrupts)
+
+    Responsibilities:
+    - Carry a suite's cancellation signal to the processes and workers its tests and compiles start
+    - Notify the code running a process or worker when its work is cancelled
+    - Record whether a test's work was actually cut short by the cancellation
+    - Describe why work was cancelled
+*/
+
+import {AsyncLocalStorage} from 'node:async_hooks'
+
+/**
+ * Reasons a suite is cancelled
+ */
+export type CancelReason = 'failure' | 'interrupt'
+
+/**
+ * Cancellation state of one piece of work
+ */
+type CancelContext = {
+    signal: AbortSignal
+    cancelled: boolean // Work was killed or not started because of the signal
+}
+
+/**
+ * Cancellation context of tests and compiles
+ *
+ * @remarks
+ * The runner runs each test and compile inside run() with the signal of its suite, and the signal is
+ * carried through the handlers by AsyncLocalStorage (like Trace lanes), so BaseTestHandler.runCommand()
+ * and the in-process runners can kill their work however deeply they were called. Work killed by an
+ * onCancel() listener, or not started because the signal was already aborted (markCancelled()), is
+ * recorded as cancelled, so the runner only reports tests that were actually cut short as cancelled; a
+ * test that failed on its own while the suite was being cancelled keeps its result.
+ */
+export class Cancellation {
+    private static context = new AsyncLocalStorage<CancelContext>()
+
+    /**
+     * Run work that is cancelled with a signal
+     *
+     * @param signal - Signal of the suite the work belongs to
+     * @param fn - Work to run
+     * @returns Result of fn
+     */
+    static async run<T>(signal: AbortSignal, fn: () => Promise<T>): Promise<T> {
+        return (await this.track(signal, fn)).result
+    }
+
+    /**
+     * Run work that is cancelled with a signal and report whether the cancellation cut it short
+     *
+     * @param signal - Signal of the suite the work belongs to
+     * @param fn - Work to run
+     * @returns Result of fn, and whether markCancelled() was called for the work
+     */
+    static async track<T>(signal: AbortSignal, fn: () => Promise<T>): Promise<{result: T; cancelled: boolean}> {
+        const context: CancelContext = {signal, cancelled: false}
+        const result = await this.context.run(context, fn)
+        return {result, cancelled: context.cancelled}
+    }
+
+    /**
+     * Get the cancellation signal of the caller's work, if any
+     */
+    static get signal(): AbortSignal | undefined {
+        return this.context.getStore()?.signal
+    }
+
+    /**
+     * Record that the caller's work was killed or not started because it was cancelled
+     */
+    static markCancelled(): void {
+        const context = this.context.getStore()
+        if (context) {
+            context.cancelled = true
+        }
+    }
+
+    /**
+     * Call a listener when the caller's work is cancelled
+     *
+     * @remarks
+     * The listener kills the work, so the work is recorded as cancelled when the listener is called.
+     * The abort event runs in the context of the code that cancelled the suite, so the caller's context
+     * is captured here.
+     *
+     * @param listener - Called once with the cancelled signal (immediately if already cancelled)
+     * @returns Function that removes the listener
+     */
+    static onCancel(listener: (signal: AbortSignal) => void): () => void {
+        const context = this.context.getStore()
+        if (!context) {
+            return () => {}
+        }
+        const signal = context.signal
+        const cancel = () => {
+            context.cancelled = true
+            listener(signal)
+        }
+        if (signal.aborted) {
+            cancel()
+            return () => {}
+        }
+        signal.addEventListener('abort', cancel, {once: true})
+        return () => signal.removeEventListener('abort', cancel)
+    }
+
+    /**
+     * Describe why a signal was cancelled
+     *
+     * @param signal - Cancelled signal
+     * @returns Message for the results of cancelled tests
+     */
+    static describe(signal: AbortSignal): string {
+        return (signal.reason as CancelReason) === 'interrupt' ? 'Cancelled by interrupt' : 'Cancelled after a failure'
+    }
+}
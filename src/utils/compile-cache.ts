@@ -0,0 +1,252 @@
+/*
+    compile-cache.ts - Content-addressed cache of compiled C test binaries
+
+    Responsibilities:
+    - Store and fetch binaries keyed by a hash of the preprocessed source, compiler identity and flags
+    - Share binaries across checkouts through a local cache directory (default ~/.cache/testme)
+    - Optionally share binaries across machines through an HTTP endpoint (GET/PUT <url>/<key>)
+    - Bound the local cache size by evicting the least recently used entries (maxSize)
+*/
+
+import type {CompileCacheConfig} from '../types.ts'
+import {PermissionManager} from '../platform/permissions.ts'
+import {inBackground, removeFile, withRemoveSlot} from './remove.ts'
+import {copyFile, mkdir, readdir, rename, stat, unlink, utimes} from 'node:fs/promises'
+import {dirname, join, resolve} from 'path'
+import os from 'os'
+
+// Remote requests that take longer than this are treated as a cache miss
+const REMOTE_TIMEOUT = 30000
+
+// Default local cache size limit in MB
+const DEFAULT_MAX_SIZE = 1024
+
+// Eviction stops once the cache is this fraction of its limit, so compaction does not run on every store
+const COMPACT_TARGET = 0.9
+
+// Minimum time between compactions of a cache directory by one process
+const COMPACT_INTERVAL = 60000
+
+// Temporary files older than this were left by an interrupted store
+const STALE_TEMP = 3600000
+
+/**
+ * A local cache file considered for eviction
+ */
+type CacheFile = {
+    path: string
+    size: number // Bytes
+    used: number // Last use (mtime, refreshed on every hit)
+}
+
+/**
+ * Content-addressed binary cache shared across checkouts and CI runners
+ *
+ * @remarks
+ * Entries are immutable: a key uniquely identifies the inputs of a compile, so an entry is only
+ * ever written once and concurrent writers produce identical content. Local writes go to a
+ * temporary file which is renamed into place so readers never see a partial binary.
+ * Cache failures are never fatal - a failed fetch is a miss and a failed store is ignored.
+ *
+ * The local cache is kept under maxSize MB. A hit refreshes the entry's modification time, and after
+ * a store the cache is compacted in the background by removing the least recently used entries. Each
+ * process compacts a directory at most once per COMPACT_INTERVAL, so large caches are not rescanned by
+ * every compile.
+ */
+export class CompileCache {
+    private static compacted = new Map<string, number>()
+    private dir: string
+    private maxSize: number
+    private url?: string
+    private upload: boolean
+    private headers: Record<string, string>
+
+    /**
+     * Create a cache from configuration
+     *
+     * @param config - Cache configuration (compiler.c.cache)
+     * @param baseDir - Directory used to resolve a relative cache directory
+     */
+    constructor(config: CompileCacheConfig, baseDir: string) {
+        this.dir = config.dir ? resolve(baseDir, config.dir) : CompileCache.defaultDir()
+        this.url = config.url ? config.url.replace(/\/+$/, '') : undefined
+        this.upload = config.upload ?? false
+        this.maxSize = (config.maxSize ?? DEFAULT_MAX_SIZE) * 1024 * 1024
+        // Expand ${VAR} in header values so tokens can come from the environment
+        this.headers = {}
+        for (const [name, value] of Object.entries(config.headers || {})) {
+            this.headers[name] = value.replace(/\$\{([A-Za-z_][A-Za-z0-9_]*)\}/g, (_, key: string) => {
+                return process.env[key] || ''
+            })
+        }
+    }
+
+    /**
+     * Get the default local cache directory ($XDG_CACHE_HOME/testme or ~/.cache/testme)
+     */
+    static defaultDir(): string {
+        const base = process.env.XDG_CACHE_HOME || join(os.homedir(), '.cache')
+        return join(base, 'testme')
+    }
+
+    /**
+     * Fetch a cached binary
+     *
+     * @param key - Content hash of the compile inputs
+     * @param binaryPath - Destination path for the binary
+     * @returns Source of the hit ('local' or 'remote'), or null on a miss
+     */
+    async fetch(key: string, binaryPath: string): Promise<'local' | 'remote' | null> {
+        const entry = this.getEntryPath(key)
+        try {
+            if (await Bun.file(entry).exists()) {
+                await copyFile(entry, binaryPath)
+                await PermissionManager.makeExecutable(binaryPath)
+                // Mark the entry as recently used (atime is unreliable with noatime/relatime mounts)
+                const now = new Date()
+                await utimes(entry, now, now).catch(() => {})
+                return 'local'
+            }
+        } catch {
+            // Fall through to remote lookup
+        }
+        if (!this.url) {
+            return null
+        }
+        try {
+            const response = await fetch(`${this.url}/${key}`, {
+                headers: this.headers,
+                signal: AbortSignal.timeout(REMOTE_TIMEOUT),
+            })
+            if (!response.ok) {
+                return null
+            }
+            const data = await response.arrayBuffer()
+            await Bun.write(binaryPath, data)
+            await PermissionManager.makeExecutable(binaryPath)
+            // Populate the local cache so other checkouts on this machine hit locally
+            await this.storeLocal(key, binaryPath)
+            return 'remote'
+        } catch {
+            return null
+        }
+    }
+
+    /**
+     * Store a freshly compiled binary in the local cache and, if enabled, upload it
+     *
+     * @param key - Content hash of the compile inputs
+     * @param binaryPath - Path of the compiled binary
+     */
+    async store(key: string, binaryPath: string): Promise<void> {
+        await this.storeLocal(key, binaryPath)
+        if (this.url && this.upload) {
+            try {
+                await fetch(`${this.url}/${key}`, {
+                    method: 'PUT',
+                    headers: {'Content-Type': 'application/octet-stream', ...this.headers},
+                    body: Bun.file(binaryPath),
+                    signal: AbortSignal.timeout(REMOTE_TIMEOUT),
+                })
+            } catch {
+                // Upload failures only cost a future cache miss
+            }
+        }
+    }
+
+    /**
+     * Copy a binary into the local cache using write-to-temp then rename
+     *
+     * @internal
+     */
+    private async storeLocal(key: string, binaryPath: string): Promise<void> {
+        const entry = this.getEntryPath(key)
+        const temp = `${entry}.${process.pid}.${Math.random().toString(36).slice(2)}.tmp`
+        try {
+            await mkdir(dirname(entry), {recursive: true})
+            await copyFile(binaryPath, temp)
+            await rename(temp, entry)
+        } catch {
+            await unlink(temp).catch(() => {})
+            return
+        }
+        this.scheduleCompaction()
+    }
+
+    /**
+     * Compact the local cache in the background unless this process compacted it recently
+     *
+     * @internal
+     */
+    private scheduleCompaction(): void {
+        const last = CompileCache.compacted.get(this.dir)
+        if (this.maxSize <= 0 || (last !== undefined && Date.now() - last < COMPACT_INTERVAL)) {
+            return
+        }
+        CompileCache.compacted.set(this.dir, Date.now())
+        inBackground(() => this.compact())
+    }
+
+    /**
+     * Evict least recently used entries until the local cache is under COMPACT_TARGET of maxSize
+     *
+     * @remarks
+     * Concurrent processes may evict the same entries; a missing entry is simply a future miss.
+     * Temporary files of interrupted stores are removed once stale.
+     *
+     * @internal
+     */
+    private async compact(): Promise<void> {
+        const files: CacheFile[] = []
+        const now = Date.now()
+        let total = 0
+        const shards = await withRemoveSlot(() => readdir(this.dir, {withFileTypes: true}))
+        await Promise.all(
+            shards
+                .filter((shard) => shard.isDirectory())
+                .map(async (shard) => {
+                    const shardDir = join(this.dir, shard.name)
+                    const names = await withRemoveSlot(() => readdir(shardDir)).catch(() => [] as string[])
+                    await Promise.all(
+                        names.map(async (name) => {
+                            const path = join(shardDir, name)
+                            const info = await withRemoveSlot(() => stat(path)).catch(() => undefined)
+                            if (!info?.isFile()) {
+                                return
+                            }
+                            if (name.endsWith('.tmp')) {
+                                if (now - info.mtimeMs > STALE_TEMP) {
+                                    await removeFile(path).catch(() => {})
+                                }
+                                return
+                            }
+                            files.push({path, size: info.size, used: info.mtimeMs})
+                            total += info.size
+                        })
+                    )
+                })
+        )
+        if (total <= this.maxSize) {
+            return
+        }
+        const target = this.maxSize * COMPACT_TARGET
+        const evict: CacheFile[] = []
+        for (const file of files.sort((a, b) => a.used - b.used)) {
+            if (total <= target) {
+                break
+            }
+            evict.push(file)
+            total -= file.size
+        }
+        await Promise.all(evict.map((file) => removeFile(file.path).catch(() => {})))
+    }
+
+    /**
+     * Get the local path of a cache entry (fanned out by the first two key characters)
+     *
+     * @internal
+     */
+    private getEntryPath(key: string): string {
+        return join(this.dir, key.slice(0, 2), key)
+    }
+}
@@ -0,0 +1,301 @@
+/*
+    coverage.ts - Line coverage of instrumented C tests (compiler.c.coverage and --coverage)
+
+    Responsibilities:
+    - Convert the coverage data a test binary writes into line counts as soon as the test completes
+    - Merge the line counts of every test into one run total, whichever worker ran the test
+    - Write the run total as an LCOV tracefile and print a summary when the run ends
+*/
+
+import {PlatformDetector} from '../platform/detector.ts'
+import {removeFile} from './remove.ts'
+import {Log} from './log.ts'
+import {mkdir, readdir, writeFile} from 'node:fs/promises'
+import {basename, dirname, join, relative, resolve, sep} from 'path'
+
+// Suffix of the raw profiles written by Clang-instrumented binaries (one per process)
+const PROFILE_SUFFIX = '.profraw'
+
+/**
+ * Totals of a coverage report
+ */
+export type CoverageSummary = {
+    files: number // Source files with instrumented lines
+    lines: number // Instrumented lines
+    covered: number // Lines executed at least once
+}
+
+/**
+ * Output of a coverage tool
+ */
+type ToolResult = {
+    exitCode: number
+    stdout: string
+    stderr: string
+}
+
+/**
+ * Run-level coverage collector
+ *
+ * @remarks
+ * Each test converts its own coverage data (gcov JSON on GCC, llvm-profdata and llvm-cov on Clang)
+ * in the worker that ran it, right after the test and before its artifacts are cleaned, so the
+ * expensive part of the merge runs in parallel across the workers. The line counts are added to a
+ * shared total that finish() writes once.
+ */
+export class Coverage {
+    private static counts = new Map<string, Map<number, number>>()
+    private static report = join(process.cwd(), '.testme', 'lcov.info')
+    private static quiet = false
+    private static warned = new Set<string>()
+
+    /**
+     * Set where the report is written
+     *
+     * @param report - LCOV tracefile path
+     * @param quiet - Do not print the summary
+     */
+    static start(report: string, quiet: boolean): void {
+        this.report = report
+        this.quiet = quiet
+        this.counts.clear()
+    }
+
+    /**
+     * Get the environment a coverage-instrumented test binary runs with
+     *
+     * @remarks
+     * Clang binaries write a raw profile per process next to the binary. GCC binaries ignore the
+     * variable and write .gcda files next to the binary by their build path.
+     *
+     * @param binaryPath - Test binary
+     * @returns Variables directing raw profiles to the artifact directory
+     */
+    static getEnvironment(binaryPath: string): Record<string, string> {
+        return {LLVM_PROFILE_FILE: `${binaryPath}-%p${PROFILE_SUFFIX}`}
+    }
+
+    /**
+     * Remove coverage data left by an earlier run of a binary
+     *
+     * @param binaryPath - Test binary
+     */
+    static async reset(binaryPath: string): Promise<void> {
+        await Promise.all((await this.findData(binaryPath)).map((path) => removeFile(path)))
+    }
+
+    /**
+     * Add the coverage data written by a test run to the run total
+     *
+     * @remarks
+     * The data files are removed once counted, so repeated runs of a test are each counted once.
+     * Failures are reported but do not fail the test.
+     *
+     * @param binaryPath - Test binary
+     */
+    static async collect(binaryPath: string): Promise<void> {
+        const data = await this.findData(binaryPath)
+        if (data.length === 0) {
+            return
+        }
+        try {
+            if (data.some((path) => path.endsWith(PROFILE_SUFFIX))) {
+                await this.collectLlvm(binaryPath, data)
+            } else {
+                await this.collectGcov(binaryPath, data)
+            }
+        } catch (error) {
+            this.warn(String(error instanceof Error ? error.message : error))
+        } finally {
+            await Promise.all(data.map((path) => removeFile(path).catch(() => {})))
+        }
+    }
+
+    /**
+     * Write the report and print its summary
+     *
+     * @remarks
+     * Nothing is written when no test was built with coverage.
+     *
+     * @returns Report totals, or undefined if there was no coverage data
+     */
+    static async finish(): Promise<CoverageSummary | undefined> {
+        if (this.counts.size === 0) {
+            return undefined
+        }
+        const summary: CoverageSummary = {files: 0, lines: 0, covered: 0}
+        let text = ''
+        for (const file of [...this.counts.keys()].sort()) {
+            const lines = [...this.counts.get(file)!.entries()].sort((a, b) => a[0] - b[0])
+            const covered = lines.filter(([, count]) => count > 0).length
+            text += `TN:\nSF:${file}\n`
+            text += lines.map(([line, count]) => `DA:${line},${count}\n`).join('')
+            text += `LF:${lines.length}\nLH:${covered}\nend_of_record\n`
+            summary.files++
+            summary.lines += lines.length
+            summary.covered += covered
+        }
+        this.counts.clear()
+        try {
+            await mkdir(dirname(this.report), {recursive: true})
+            await writeFile(this.report, text)
+        } catch (error) {
+            console.warn(`Warning: Could not write coverage report ${this.report}: ${error}`)
+            return summary
+        }
+        if (!this.quiet) {
+            const percent = summary.lines > 0 ? ((summary.covered / summary.lines) * 100).toFixed(1) : '0.0'
+            Log.info(
+                `\n📈 Coverage: ${percent}% of ${summary.lines} lines in ${summary.files} files ` +
+                    `(${relative(process.cwd(), this.report) || this.report})`
+            )
+        }
+        return summary
+    }
+
+    /**
+     * Add line counts to the run total
+     *
+     * @param file - Source file path (absolute)
+     * @param line - Line number
+     * @param count - Times the line was executed
+     */
+    static add(file: string, line: number, count: number): void {
+        // The framework header and generated drivers are not the code under test
+        if (basename(file) === 'testme.h' || file.includes(`${sep}.testme${sep}`)) {
+            return
+        }
+        let lines = this.counts.get(file)
+        if (!lines) {
+            lines = new Map<number, number>()
+            this.counts.set(file, lines)
+        }
+        lines.set(line, (lines.get(line) ?? 0) + count)
+    }
+
+    /**
+     * Parse an LCOV tracefile into the run total
+     *
+     * @param text - Tracefile content
+     */
+    static addLcov(text: string): void {
+        let file = ''
+        for (const line of text.split(/\r?\n/)) {
+            if (line.startsWith('SF:')) {
+                file = resolve(line.slice(3))
+            } else if (line.startsWith('DA:') && file) {
+                const [number, count] = line.slice(3).split(',')
+                this.add(file, parseInt(number!, 10), parseInt(count!, 10) || 0)
+            } else if (line === 'end_of_record') {
+                file = ''
+            }
+        }
+    }
+
+    /**
+     * Find the coverage data files of a binary
+     *
+     * @internal
+     */
+    private static async findData(binaryPath: string): Promise<string[]> {
+        const dir = dirname(binaryPath)
+        const prefix = basename(binaryPath) + '-'
+        try {
+            return (await readdir(dir))
+                .filter((name) => name.startsWith(prefix) && (name.endsWith('.gcda') || name.endsWith(PROFILE_SUFFIX)))
+                .map((name) => join(dir, name))
+        } catch {
+            return []
+        }
+    }
+
+    /**
+     * Count GCC coverage data with gcov (JSON output, GCC 9 and later)
+     *
+     * @internal
+     */
+    private static async collectGcov(binaryPath: string, data: string[]): Promise<void> {
+        const result = await this.run(['gcov', '--json-format', '--stdout', ...data], dirname(binaryPath))
+        if (result.exitCode !== 0) {
+            throw new Error(`gcov failed: ${result.stderr.trim()}`)
+        }
+        for (const line of result.stdout.split('\n')) {
+            if (!line.startsWith('{')) {
+                continue
+            }
+            const record = JSON.parse(line) as {
+                current_working_directory?: string
+                files?: {file: string; lines?: {line_number: number; count: number}[]}[]
+            }
+            // Sources are relative to the directory the test was compiled from
+            const cwd = record.current_working_directory || dirname(binaryPath)
+            for (const source of record.files || []) {
+                const file = resolve(cwd, source.file)
+                for (const line of source.lines || []) {
+                    this.add(file, line.line_number, line.count)
+                }
+            }
+        }
+    }
+
+    /**
+     * Count Clang source-based coverage with llvm-profdata and llvm-cov
+     *
+     * @internal
+     */
+    private static async collectLlvm(binaryPath: string, data: string[]): Promise<void> {
+        const profiles = data.filter((path) => path.endsWith(PROFILE_SUFFIX))
+        const merged = `${binaryPath}-merged.profdata`
+        const tool = PlatformDetector.isMacOS() ? ['xcrun'] : []
+        try {
+            const merge = await this.run(
+                [...tool, 'llvm-profdata', 'merge', '-sparse', '-o', merged, ...profiles],
+                dirname(binaryPath)
+            )
+            if (merge.exitCode !== 0) {
+                throw new Error(`llvm-profdata failed: ${merge.stderr.trim()}`)
+            }
+            const exported = await this.run(
+                [...tool, 'llvm-cov', 'export', '-format=lcov', `-instr-profile=${merged}`, binaryPath],
+                dirname(binaryPath)
+            )
+            if (exported.exitCode !== 0) {
+                throw new Error(`llvm-cov failed: ${exported.stderr.trim()}`)
+            }
+            this.addLcov(exported.stdout)
+        } finally {
+            await removeFile(merged).catch(() => {})
+        }
+    }
+
+    /**
+     * Run a coverage tool
+     *
+     * @internal
+     */
+    private static async run(args: string[], cwd: string): Promise<ToolResult> {
+        try {
+            const proc = Bun.spawn(args, {cwd, stdout: 'pipe', stderr: 'pipe'})
+            const [stdout, stderr, exitCode] = await Promise.all([
+                new Response(proc.stdout).text(),
+                new Response(proc.stderr).text(),
+                proc.exited,
+            ])
+            return {exitCode, stdout, stderr}
+        } catch (error) {
+            return {exitCode: -1, stdout: '', stderr: `Cannot run ${args[0]}: ${error}`}
+        }
+    }
+
+    /**
+     * Warn once about each distinct coverage failure
+     *
+     * @internal
+     */
+    private static warn(message: string): void {
+        if (!this.warned.has(message)) {
+            this.warned.add(message)
+            console.warn(`Warning: Coverage not collected: ${message}`)
+        }
+    }
+}
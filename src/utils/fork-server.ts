@@ -0,0 +1,182 @@
+/*
+    fork-server.ts - Repeated C test runs through a forking test process
+
+    Responsibilities:
+    - Start a C test binary in fork-server mode (TESTME_FORK_SERVER) and keep it at its checkpoint
+    - Request one forked run at a time over stdin and split the run's output at TESTME_FORK_EXIT lines
+    - Detect binaries without fork-server support (they run once and exit) and report a timeout per run
+    - Kill the server and its running child when the suite is cancelled
+*/
+
+import type {Subprocess} from 'bun'
+import {Cancellation} from './cancel.ts'
+import {ProcessManager} from '../platform/process.ts'
+
+// Status line written by tForkServer() after each child exits (preceded by a newline)
+const EXIT_PATTERN = /\n?TESTME_FORK_EXIT (-?\d+)\r?\n/
+
+// Exit status of a child killed by SIGALRM (the per-run timeout)
+const ALARM_STATUS = 128 + 14
+
+/**
+ * Result of one forked run, compatible with BaseTestHandler.runCommand() results
+ */
+export type ForkRunResult = {
+    exitCode: number
+    stdout: string
+    stderr: string
+}
+
+/**
+ * Incremental reader that splits a stream into runs at TESTME_FORK_EXIT lines
+ *
+ * @internal
+ */
+class FramedReader {
+    private reader: ReadableStreamDefaultReader<Uint8Array>
+    private decoder = new TextDecoder()
+    private buffer = ''
+    ended = false
+
+    constructor(stream: ReadableStream<Uint8Array>) {
+        this.reader = stream.getReader()
+    }
+
+    /**
+     * Read the output of the next run
+     *
+     * @returns Output and exit status, or status null if the stream ended before the status line
+     */
+    async next(): Promise<{text: string; status: number | null}> {
+        while (true) {
+            const match = this.buffer.match(EXIT_PATTERN)
+            if (match) {
+                const text = this.buffer.slice(0, match.index)
+                this.buffer = this.buffer.slice(match.index! + match[0].length)
+                return {text, status: parseInt(match[1]!, 10)}
+            }
+            if (this.ended) {
+                const text = this.buffer
+                this.buffer = ''
+                return {text, status: null}
+            }
+            const {done, value} = await this.reader.read()
+            if (done) {
+                this.ended = true
+            } else {
+                this.buffer += this.decoder.decode(value, {stream: true})
+            }
+        }
+    }
+}
+
+/**
+ * Test process in fork-server mode
+ *
+ * @remarks
+ * The binary initializes once and forks a fresh child per run, so each run is isolated but skips
+ * exec, dynamic loading and libc startup. POSIX only. A binary built without fork-server support
+ * runs its test once and exits: that run is still reported and the server is then closed, so the
+ * caller falls back to spawning the binary per run.
+ */
+export class ForkServer {
+    private proc: Subprocess<'pipe', 'pipe', 'pipe'>
+    private stdout: FramedReader
+    private stderr: FramedReader
+    private remaining: number
+    private timeout: number
+    closed = false
+
+    /**
+     * Start a test binary in fork-server mode
+     *
+     * @param command - Test binary
+     * @param options - Working directory, test environment, per-run timeout in milliseconds and number of runs
+     */
+    constructor(command: string, options: {cwd: string; env: Record<string, string>; timeout: number; runs: number}) {
+        this.timeout = options.timeout
+        this.remaining = options.runs
+        this.proc = Bun.spawn([command], {
+            cwd: options.cwd,
+            env: {...process.env, ...options.env, TESTME_FORK_SERVER: String(Math.ceil(options.timeout / 1000))},
+            stdin: 'pipe',
+            stdout: 'pipe',
+            stderr: 'pipe',
+        })
+        this.stdout = new FramedReader(this.proc.stdout)
+        this.stderr = new FramedReader(this.proc.stderr)
+    }
+
+    /**
+     * Run the test once in a forked child
+     *
+     * @remarks
+     * The server is closed after the last requested run or the first failed run, matching the
+     * runner, which stops repeating a test when it fails.
+     *
+     * @returns Exit code and output of the run
+     */
+    async run(): Promise<ForkRunResult> {
+        this.proc.stdin.write('run\n')
+        this.proc.stdin.flush()
+
+        // Guard against a server that hangs before the checkpoint (children time out by themselves)
+        let timer: Timer | undefined
+        const stalled = new Promise<null>((resolve) => {
+            timer = setTimeout(() => resolve(null), this.timeout + 5000)
+        })
+        // Kill the server and its forked child as soon as the suite is cancelled
+        let removeCancel = () => {}
+        const cancelled = new Promise<AbortSignal>((resolve) => {
+            removeCancel = Cancellation.onCancel(resolve)
+        })
+        const run = await Promise.race([Promise.all([this.stdout.next(), this.stderr.next()]), stalled, cancelled])
+        clearTimeout(timer)
+        removeCancel()
+
+        if (run instanceof AbortSignal) {
+            this.closed = true
+            await ProcessManager.killProcessTree(this.proc.pid)
+            return {exitCode: -1, stdout: '', stderr: Cancellation.describe(run)}
+        }
+        if (!run) {
+            this.close(true)
+            return {exitCode: -1, stdout: '', stderr: `Test timed out after ${Math.round(this.timeout / 1000)}s`}
+        }
+        const [out, err] = run
+        let exitCode = out.status ?? err.status
+        let stderr = err.text
+        if (exitCode === null) {
+            // No status line: the binary does not support fork-server mode and ran the test itself
+            exitCode = await this.proc.exited
+            this.closed = true
+        } else if (exitCode === ALARM_STATUS) {
+            stderr += `\nTest timed out after ${Math.round(this.timeout / 1000)}s`
+            exitCode = -1
+        }
+        if (--this.remaining <= 0 || exitCode !== 0) {
+            this.close()
+        }
+        return {exitCode, stdout: out.text, stderr}
+    }
+
+    /**
+     * Stop the server. Closing stdin lets it exit after the current child.
+     *
+     * @param kill - Kill the server immediately
+     */
+    close(kill = false): void {
+        if (this.closed) {
+            return
+        }
+        this.closed = true
+        try {
+            this.proc.stdin.end()
+        } catch {
+            // Already closed
+        }
+        if (kill) {
+            this.proc.kill(9)
+        }
+    }
+}
@@ -20,6 +20,16 @@ export type SpecialVariables = {
  Supports special variables like ${TESTDIR}, ${OS}, ${ARCH}, etc.
  */
 export class GlobExpansion {
+    // Glob matches by base directory and pattern, kept until clearCache() (each test suite starts afresh)
+    private static matchCache = new Map<string, Promise<string[]>>()
+
+    /*
+     Clears cached glob matches so files created since (e.g. by a prep script) are found
+     */
+    static clearCache(): void {
+        this.matchCache.clear()
+    }
+
     /*
      Expands a single string that may contain ${...} references
      @param input String potentially containing ${...} patterns
@@ -281,12 +291,19 @@ export class GlobExpansion {
      */
     private static async expandSinglePattern(input: string, pattern: string, baseDir: string): Promise<string[]> {
         try {
-            // Use glob to find matching paths
-            const matches = await glob(pattern, {
-                cwd: baseDir,
-                absolute: false,
-                nodir: false, // Allow directories to match too
-            })
+            // Use glob to find matching paths (once per base directory: tests sharing a config expand the same flags)
+            const key = `${baseDir}\0${pattern}`
+            let matching = this.matchCache.get(key)
+            if (!matching) {
+                matching = glob(pattern, {
+                    cwd: baseDir,
+                    absolute: false,
+                    nodir: false, // Allow directories to match too
+                })
+                this.matchCache.set(key, matching)
+                matching.catch(() => this.matchCache.delete(key))
+            }
+            const matches = await matching
 
             if (matches.length === 0) {
                 // If no matches found, return the original string with ${...} removed
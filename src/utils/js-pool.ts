@@ -0,0 +1,167 @@
+/*
+    js-pool.ts - Run JS/TS tests in-process on a pool of pre-started Bun workers
+
+    Responsibilities:
+    - Decide whether a test may run in-process (execution.inProcess and no "testme: process" pragma)
+    - Keep warm workers ready so a test does not wait for thread and runtime startup
+    - Collect output and structured assertion results from the worker and enforce the test timeout
+*/
+
+import type {TestConfig, TestFile} from '../types.ts'
+import {RunBudget} from './run-budget.ts'
+import {Cancellation} from './cancel.ts'
+
+// Tests containing this comment always run in a separate process
+const PROCESS_PRAGMA = /^\s*\/\/\s*testme:\s*process\b/m
+
+// Worker entry point. Must also be passed to "bun build --compile" so it is embedded in the tm binary.
+const WORKER_ENTRY = new URL('./js-worker.ts', import.meta.url).href
+
+/**
+ * Result of running a test in a worker, compatible with BaseTestHandler.runCommand() results
+ */
+export type WorkerRunResult = {
+    exitCode: number
+    stdout: string
+    stderr: string
+    assertions: {passed: number; failed: number}
+}
+
+/**
+ * Pool of warm Bun workers for in-process JS/TS test execution
+ *
+ * @remarks
+ * A worker's module registry cannot be reset, so each worker runs a single test and is then
+ * terminated. The pool hides the startup cost instead of reusing threads: whenever a worker is
+ * taken, a replacement is started so it is ready by the time the next test is scheduled.
+ * All tests share the tm process, so tests that depend on the working directory, process-wide
+ * signal handlers or long-lived background work should keep the process path via the pragma.
+ */
+export class JsWorkerPool {
+    private static spare: Worker[] = []
+
+    /**
+     * Check if a test should run in-process
+     *
+     * @param file - JS or TS test file
+     * @param config - Test configuration
+     * @returns true if execution.inProcess is enabled and the file has no "// testme: process" pragma
+     */
+    static async accepts(file: TestFile, config: TestConfig): Promise<boolean> {
+        if (!config.execution?.inProcess || config.execution?.debugMode) {
+            return false
+        }
+        try {
+            return !PROCESS_PRAGMA.test(await Bun.file(file.path).text())
+        } catch {
+            return false
+        }
+    }
+
+    /**
+     * Run a test file in a worker
+     *
+     * @param file - Test file to run
+     * @param options - Test environment, timeout in milliseconds, and config for live output and pool size
+     * @returns Exit code, captured output and assertion counts
+     */
+    static run(
+        file: TestFile,
+        options: {env: Record<string, string>; timeout: number; config: TestConfig}
+    ): Promise<WorkerRunResult> {
+        const worker = this.take(RunBudget.getWorkers(options.config.execution))
+        const live = options.config.output?.live && !options.config.output?.quiet
+
+        return new Promise((resolve) => {
+            let stdout = ''
+            let stderr = ''
+            const assertions = {passed: 0, failed: 0}
+            let settled = false
+            let removeCancel = () => {}
+
+            const finish = (exitCode: number) => {
+                if (settled) {
+                    return
+                }
+                settled = true
+                clearTimeout(timer)
+                removeCancel()
+                worker.terminate()
+                resolve({exitCode, stdout, stderr, assertions})
+            }
+
+            const timer = setTimeout(() => {
+                stderr += `\nTest ${file.name} timed out after ${Math.round(options.timeout / 1000)}s`
+                finish(-1)
+            }, options.timeout)
+
+            // Stop the worker as soon as the suite is cancelled (fast-fail or interrupt)
+            removeCancel = Cancellation.onCancel((signal) => {
+                stderr += `\n${Cancellation.describe(signal)}`
+                finish(-1)
+            })
+
+            worker.onmessage = (event: MessageEvent) => {
+                const message = event.data
+                switch (message.type) {
+                    case 'output':
+                        if (message.stream === 'stderr') {
+                            stderr += message.text
+                        } else {
+                            stdout += message.text
+                        }
+                        if (live) {
+                            process[message.stream as 'stdout' | 'stderr'].write(message.text)
+                        }
+                        break
+                    case 'assert':
+                    case 'test':
+                        if (message.passed) {
+                            assertions.passed++
+                        } else {
+                            assertions.failed++
+                        }
+                        break
+                    case 'done':
+                        finish(message.exitCode)
+                        break
+                }
+            }
+            worker.onerror = (event: ErrorEvent) => {
+                event.preventDefault()
+                stderr += `${event.message}\n`
+                finish(1)
+            }
+            // A worker that stops without reporting crashed or was killed
+            worker.addEventListener('close', () => {
+                stderr += `\nWorker for ${file.name} exited unexpectedly`
+                finish(1)
+            })
+            worker.postMessage({path: file.path, env: options.env})
+        })
+    }
+
+    /**
+     * Take a warm worker and start replacements up to the target number of spares
+     *
+     * @internal
+     */
+    private static take(spares: number): Worker {
+        const worker = this.spare.pop() || this.spawn()
+        while (this.spare.length < spares) {
+            this.spare.push(this.spawn())
+        }
+        return worker
+    }
+
+    /**
+     * Start a worker that does not keep tm alive once testing is complete
+     *
+     * @internal
+     */
+    private static spawn(): Worker {
+        const worker = new Worker(WORKER_ENTRY)
+        worker.unref()
+        return worker
+    }
+}
@@ -0,0 +1,107 @@
+/*
+    js-worker.ts - Worker thread entry point that runs a single JS/TS test file in-process
+
+    Responsibilities:
+    - Apply the test environment and import the test file in a fresh module registry
+    - Forward console and stdout/stderr output to the main thread as messages
+    - Forward structured assertion and test results from the testme module (globalThis.__testme)
+    - Report completion with the test's exit code, including when the test calls process.exit()
+*/
+
+import {format} from 'node:util'
+import {pathToFileURL} from 'node:url'
+
+declare var self: Worker
+
+/**
+ * Hooks shared with the testme module (src/modules/js/index.js)
+ */
+type TestmeHooks = {
+    notify: (event: {type: 'assert' | 'test'; passed: boolean}) => void
+    active?: () => number // Number of describe() and test() calls still running
+    exitCode?: () => number // Exit code accumulated by failed tests
+    idle?: () => void // Called by the testme module when the last running test finishes
+}
+
+let finished = false
+
+/**
+ * Report completion to the main thread (first report wins)
+ */
+function done(exitCode: number): void {
+    if (!finished) {
+        finished = true
+        self.postMessage({type: 'done', exitCode})
+    }
+}
+
+/**
+ * Redirect console and process output to the main thread
+ */
+function captureOutput(): void {
+    const send = (stream: 'stdout' | 'stderr', text: string) => self.postMessage({type: 'output', stream, text})
+    const print =
+        (stream: 'stdout' | 'stderr') =>
+        (...args: unknown[]) =>
+            send(stream, format(...args) + '\n')
+    console.log = console.info = console.debug = print('stdout')
+    console.error = console.warn = console.trace = print('stderr')
+
+    const decoder = new TextDecoder()
+    for (const stream of ['stdout', 'stderr'] as const) {
+        process[stream].write = ((chunk: string | Uint8Array, ...rest: unknown[]) => {
+            send(stream, typeof chunk === 'string' ? chunk : decoder.decode(chunk))
+            const callback = rest.find((arg) => typeof arg === 'function') as (() => void) | undefined
+            callback?.()
+            return true
+        }) as typeof process.stdout.write
+    }
+}
+
+/**
+ * Wait until all describe() and test() calls started by the test file have finished
+ */
+function settled(hooks: TestmeHooks): Promise<void> {
+    return new Promise((resolve) => {
+        const check = () => {
+            if ((hooks.active?.() ?? 0) === 0) {
+                resolve()
+            } else {
+                hooks.idle = check
+            }
+        }
+        check()
+    })
+}
+
+self.onmessage = async (event: MessageEvent<{path: string; env: Record<string, string>}>) => {
+    // Each worker runs exactly one test so every test gets a fresh module registry
+    self.onmessage = null
+    const {path, env} = event.data
+
+    for (const [key, value] of Object.entries(env)) {
+        process.env[key] = value
+    }
+    captureOutput()
+
+    const hooks: TestmeHooks = {
+        notify: (result) => self.postMessage({type: result.type, passed: result.passed}),
+    }
+    ;(globalThis as any).__testme = hooks
+
+    // Failed assertions exit immediately - report the code before the thread stops
+    const exit = process.exit.bind(process)
+    process.exit = ((code?: number) => {
+        done(code ?? Number(process.exitCode ?? 0))
+        return exit(code)
+    }) as typeof process.exit
+
+    try {
+        await import(pathToFileURL(path).href)
+        await settled(hooks)
+        done(Math.max(hooks.exitCode?.() ?? 0, Number(process.exitCode ?? 0)))
+    } catch (error) {
+        console.error(error instanceof Error && error.stack ? error.stack : String(error))
+        done(1)
+    }
+}
@@ -0,0 +1,48 @@
+/*
+    log.ts - Progress and summary output of the runner
+
+    Responsibilities:
+    - Write runner messages to stdout, or to stderr when stdout carries a machine-readable report
+    - Provide the stream that live test output and in-place status lines are written to
+*/
+
+import {Console} from 'node:console'
+
+/**
+ * Output channel for everything the runner prints except the report itself
+ *
+ * @remarks
+ * JSON output (`--json`) reserves stdout for the final report, e.g. `tm --shard 1/4 --json > s1.json`.
+ * The runner selects the stream once from the output format; messages of the runner, handlers and
+ * services are written through Log, so the global console is left untouched for other code.
+ */
+export class Log {
+    private static output: NodeJS.WriteStream = process.stdout
+    private static console = new Console({stdout: process.stdout, stderr: process.stderr})
+
+    /**
+     * Select the stream for runner messages
+     *
+     * @param stream - process.stdout, or process.stderr when stdout carries a report
+     */
+    static useStream(stream: NodeJS.WriteStream): void {
+        this.output = stream
+        this.console = new Console({stdout: stream, stderr: process.stderr})
+    }
+
+    /**
+     * Stream that runner messages are written to
+     */
+    static get stream(): NodeJS.WriteStream {
+        return this.output
+    }
+
+    /**
+     * Write a message line, formatted like console.log
+     *
+     * @param args - Values to print
+     */
+    static info(...args: unknown[]): void {
+        this.console.log(...args)
+    }
+}
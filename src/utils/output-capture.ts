@@ -0,0 +1,174 @@
+/*
+    output-capture.ts - Bounded-memory capture of test process output
+
+    Responsibilities:
+    - Accumulate a process output stream chunk by chunk without holding all of it in memory
+    - Keep the head and a rolling tail of the output once a size limit is exceeded
+    - Spill the complete stream to a log file in the test's artifact directory
+    - Count assertion markers and keep TESTME_* protocol lines from the omitted middle
+*/
+
+import type {FileSink} from 'bun'
+import {mkdir} from 'node:fs/promises'
+import {dirname} from 'path'
+
+// Default bytes of each stream kept in memory (output.captureLimit is in MB)
+const DEFAULT_LIMIT = 16 * 1024 * 1024
+
+// Protocol lines (TESTME_PASSED, TESTME_BENCH, TESTME_UNITY_*) are kept even when omitted
+const PROTOCOL_LINE = /^TESTME_[A-Z_]+\b.*$/gm
+
+// Maximum protocol lines kept from the omitted middle of the output
+const MAX_KEPT_LINES = 10000
+
+/**
+ * Capture of one output stream (stdout or stderr)
+ *
+ * @remarks
+ * Until the limit is reached, the output is kept whole. Beyond it, the first half of the limit is
+ * kept as the head and the most recent half as the tail. Everything in between is written only to
+ * the log file. Assertions in the omitted part are summarized in a `TESTME_OMITTED` line so
+ * countAssertions() still reports the totals for the whole stream.
+ */
+export class OutputCapture {
+    private limit: number
+    private logPath?: string
+    private decoder = new TextDecoder()
+    private head = ''
+    private tail = ''
+    private bytes = 0
+    private opening?: Promise<FileSink | undefined>
+    private kept: string[] = []
+    private omitted = {bytes: 0, passed: 0, failed: 0, lines: 0}
+
+    /**
+     * Create a capture for one stream
+     *
+     * @param limit - Bytes kept in memory (default 16MB)
+     * @param logPath - File receiving the complete stream once the limit is exceeded
+     */
+    constructor(limit?: number, logPath?: string) {
+        this.limit = Math.max(1024, limit || DEFAULT_LIMIT)
+        this.logPath = logPath
+    }
+
+    /**
+     * Add a chunk of output
+     *
+     * @param chunk - Raw output bytes
+     * @returns Decoded text of the chunk
+     */
+    async write(chunk: Uint8Array): Promise<string> {
+        const text = this.decoder.decode(chunk, {stream: true})
+        this.bytes += chunk.length
+        if (!this.opening) {
+            this.head += text
+            if (this.bytes > this.limit) {
+                await this.spill()
+            }
+        } else {
+            const sink = await this.opening
+            sink?.write(chunk)
+            this.tail += text
+            if (this.tail.length > this.limit) {
+                this.evict()
+            }
+        }
+        return text
+    }
+
+    /**
+     * Complete the capture
+     *
+     * @returns Captured output: the whole stream, or head and tail around an omission notice
+     */
+    async finish(): Promise<string> {
+        const rest = this.decoder.decode()
+        if (!this.opening) {
+            return this.head + rest
+        }
+        this.tail += rest
+        this.evict()
+        const sink = await this.opening
+        await sink?.end()
+
+        const location = sink ? `full output in ${this.logPath}` : 'full output not saved'
+        const lines = [`\n... ${this.omitted.bytes} bytes omitted (${location}) ...`]
+        if (this.omitted.passed || this.omitted.failed) {
+            lines.push(`TESTME_OMITTED passed=${this.omitted.passed} failed=${this.omitted.failed}`)
+        }
+        lines.push(...this.kept)
+        if (this.omitted.lines > this.kept.length) {
+            lines.push(`... ${this.omitted.lines - this.kept.length} protocol lines omitted ...`)
+        }
+        return `${this.head}${lines.join('\n')}\n${this.tail}`
+    }
+
+    /**
+     * Switch to head/tail mode and start the log file with the output so far
+     *
+     * @internal
+     */
+    private async spill(): Promise<void> {
+        const all = this.head
+        const cut = Math.floor(this.limit / 2)
+        this.head = all.slice(0, cut)
+        this.tail = all.slice(cut)
+        this.opening = this.openLog()
+        const sink = await this.opening
+        sink?.write(all)
+        this.evict()
+    }
+
+    /**
+     * Open the log file, if one was requested
+     *
+     * @internal
+     */
+    private async openLog(): Promise<FileSink | undefined> {
+        if (!this.logPath) {
+            return undefined
+        }
+        try {
+            await mkdir(dirname(this.logPath), {recursive: true})
+            return Bun.file(this.logPath).writer()
+        } catch {
+            this.logPath = undefined
+            return undefined
+        }
+    }
+
+    /**
+     * Trim the tail to half the limit, at a line boundary where possible
+     *
+     * @internal
+     */
+    private evict(): void {
+        const keep = Math.floor(this.limit / 2)
+        if (this.tail.length <= keep) {
+            return
+        }
+        let cut = this.tail.length - keep
+        const newline = this.tail.indexOf('\n', cut)
+        if (newline >= 0 && newline < this.tail.length - 1) {
+            cut = newline + 1
+        }
+        const evicted = this.tail.slice(0, cut)
+        this.tail = this.tail.slice(cut)
+
+        this.omitted.bytes += Buffer.byteLength(evicted)
+        for (const char of evicted.matchAll(/[✓✗]/g)) {
+            if (char[0] === '✓') {
+                this.omitted.passed++
+            } else {
+                this.omitted.failed++
+            }
+        }
+        for (const match of evicted.matchAll(PROTOCOL_LINE)) {
+            this.omitted.lines++
+            if (this.kept.length < MAX_KEPT_LINES) {
+                this.kept.push(match[0])
+            }
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/*
+    pch.ts - Precompiled testme.h for C tests
+
+    Responsibilities:
+    - Decide whether a C test can be compiled with a precompiled testme.h
+    - Name the precompiled header files for each compiler type
+    - Generate the sources used to locate testme.h and to create an MSVC precompiled header
+*/
+
+import {CompilerType} from '../platform/compiler.ts'
+
+// Header precompiled for C tests
+export const PCH_HEADER = 'testme.h'
+
+// Precompiled headers directory under the config directory's .testme directory
+export const PCH_DIR = '.pch'
+
+// Include of testme.h: #include "testme.h" or #include <testme.h>
+const INCLUDE_PATTERN = /^[ \t]*#[ \t]*include[ \t]*["<]testme\.h[">]/m
+
+// Directives that may change how testme.h compiles if they come before its include
+const CONDITIONAL_PATTERN = /^[ \t]*#[ \t]*(define|undef|if|ifdef|ifndef|elif|pragma)\b/m
+
+/**
+ * Files of one precompiled header
+ */
+export type PrecompiledHeader = {
+    args: string[] // Compiler arguments that force-include the precompiled header
+    objects: string[] // Objects to link with the test (MSVC /Yc object)
+}
+
+/**
+ * Check whether a C test can use the precompiled testme.h
+ *
+ * @remarks
+ * The precompiled header is force-included ahead of the test's own code, so the test must include
+ * testme.h before any macro definition or conditional that could change it (for example a
+ * TM_FORK_CHECKPOINT definition or a unity driver's TM_UNITY). Other headers may come first.
+ *
+ * @param source - C test source
+ * @returns True if the test includes testme.h with nothing before it that could change it
+ */
+export function canPrecompile(source: string): boolean {
+    const include = source.match(INCLUDE_PATTERN)
+    if (!include || include.index === undefined) {
+        return false
+    }
+    const before = source.slice(0, include.index).replace(/\/\*[\s\S]*?\*\//g, '').replace(/\/\/.*$/gm, '')
+    return !CONDITIONAL_PATTERN.test(before)
+}
+
+/**
+ * Get the precompiled header file name used by a compiler
+ *
+ * @remarks
+ * GCC finds testme.h.gch and clang finds testme.h.pch next to a header named by -include. MSVC
+ * names the file explicitly with /Fp.
+ *
+ * @param type - Compiler type
+ * @returns File name, or undefined if the compiler is not supported
+ */
+export function getPchName(type: CompilerType): string | undefined {
+    switch (type) {
+        case CompilerType.GCC:
+        case CompilerType.MinGW:
+            return `${PCH_HEADER}.gch`
+        case CompilerType.Clang:
+            return `${PCH_HEADER}.pch`
+        case CompilerType.MSVC:
+            return 'testme.pch'
+        default:
+            return undefined
+    }
+}
+
+/**
+ * Source that includes testme.h and nothing else
+ *
+ * @remarks
+ * Used to locate the testme.h a test would include (from the compiler's dependency output) and as
+ * the MSVC /Yc source that creates the precompiled header.
+ */
+export const PCH_SOURCE = `/* Generated by TestMe - do not edit */\n#include "${PCH_HEADER}"\n`
@@ -0,0 +1,156 @@
+/*
+    remove.ts - Bounded parallel removal of artifact and cache files
+
+    Responsibilities:
+    - Remove directory trees with a bounded number of concurrent filesystem operations
+    - Retry removals of files Windows briefly locks after a process exits
+    - Move a directory out of the way and remove it in the background (off the test critical path)
+    - Track background removals so a run can wait for them before it exits
+*/
+
+import {readdir, rename, rmdir, unlink} from 'node:fs/promises'
+import {basename, dirname, join} from 'path'
+
+// Maximum concurrent filesystem operations across all removals
+const REMOVE_FAN_OUT = 64
+
+// Retries of a locked file (EPERM/EBUSY) and the initial delay between them (doubling, capped)
+const LOCKED_RETRIES = 5
+const LOCKED_DELAY = 50
+const LOCKED_MAX_DELAY = 500
+
+// Prefix of directories renamed aside for background removal
+export const TRASH_PREFIX = '.trash-'
+
+let slots = REMOVE_FAN_OUT
+const waiting: (() => void)[] = []
+const pending = new Set<Promise<void>>()
+
+/**
+ * Run a filesystem operation in a removal slot
+ *
+ * @remarks
+ * Slots are held for single operations only and never while waiting on other slots, so recursive
+ * removals cannot deadlock however deep the tree.
+ *
+ * @param fn - Operation to run
+ * @returns Result of fn
+ */
+export async function withRemoveSlot<T>(fn: () => Promise<T>): Promise<T> {
+    if (slots > 0) {
+        slots--
+    } else {
+        await new Promise<void>((resolve) => waiting.push(resolve))
+    }
+    try {
+        return await fn()
+    } finally {
+        const next = waiting.shift()
+        if (next) {
+            next()
+        } else {
+            slots++
+        }
+    }
+}
+
+/**
+ * Remove a file, retrying while Windows holds it locked
+ *
+ * @param path - File to remove (a missing file is not an error)
+ */
+export async function removeFile(path: string): Promise<void> {
+    for (let attempt = 0; ; attempt++) {
+        try {
+            await withRemoveSlot(() => unlink(path))
+            return
+        } catch (error: any) {
+            if (error.code === 'ENOENT') {
+                return
+            }
+            // Windows may lock executables briefly after process exit
+            if ((error.code === 'EPERM' || error.code === 'EBUSY') && attempt < LOCKED_RETRIES) {
+                const delay = Math.min(LOCKED_DELAY * Math.pow(2, attempt), LOCKED_MAX_DELAY)
+                await new Promise((resolve) => setTimeout(resolve, delay))
+                continue
+            }
+            throw error
+        }
+    }
+}
+
+/**
+ * Remove a directory tree, removing the entries of each directory concurrently
+ *
+ * @param path - Directory to remove (a missing directory is not an error)
+ */
+export async function removeTree(path: string): Promise<void> {
+    try {
+        const entries = await withRemoveSlot(() => readdir(path, {withFileTypes: true}))
+        await Promise.all(
+            entries.map((entry) => {
+                const fullPath = join(path, entry.name)
+                return entry.isDirectory() ? removeTree(fullPath) : removeFile(fullPath)
+            })
+        )
+        await withRemoveSlot(() => rmdir(path))
+    } catch (error: any) {
+        if (error.code !== 'ENOENT') {
+            throw error
+        }
+    }
+}
+
+/**
+ * Move a directory aside and remove it in the background
+ *
+ * @remarks
+ * The directory is renamed to a hidden sibling, so its path is free as soon as this returns and a
+ * later run of the same test never sees partially removed artifacts. If the rename fails (for
+ * example a locked directory on Windows) the directory is removed before returning.
+ *
+ * @param path - Directory to remove
+ * @param removed - Called after the background removal, e.g. to remove a parent left empty
+ */
+export async function discardTree(path: string, removed?: () => Promise<void>): Promise<void> {
+    const random = Math.random().toString(36).slice(2, 10)
+    const trash = join(dirname(path), `${TRASH_PREFIX}${basename(path)}-${process.pid}-${random}`)
+    try {
+        await rename(path, trash)
+    } catch (error: any) {
+        if (error.code === 'ENOENT') {
+            return
+        }
+        await removeTree(path)
+        await removed?.()
+        return
+    }
+    inBackground(async () => {
+        await removeTree(trash)
+        await removed?.()
+    })
+}
+
+/**
+ * Run work in the background, tracked by settleBackground()
+ *
+ * @remarks
+ * Background work is best-effort: failures are ignored (leftovers are removed by tm --clean).
+ *
+ * @param work - Work to run
+ */
+export function inBackground(work: () => Promise<void>): void {
+    const promise: Promise<void> = work()
+        .catch(() => {})
+        .finally(() => pending.delete(promise))
+    pending.add(promise)
+}
+
+/**
+ * Wait for all background removals, including any they start
+ */
+export async function settleBackground(): Promise<void> {
+    while (pending.size > 0) {
+        await Promise.all([...pending])
+    }
+}
@@ -0,0 +1,90 @@
+/*
+    resource-usage.ts - Resources used by test processes
+
+    Responsibilities:
+    - Convert the resource usage of an exited subprocess (wait4 rusage on POSIX) into test resource usage
+    - Combine the usage of repeated runs
+    - Check usage against the execution.maxRss and execution.maxCpu limits
+    - Format usage for detailed output
+*/
+
+import type {Subprocess} from 'bun'
+import type {ExecutionConfig, ResourceUsage} from '../types.ts'
+
+// Resource usage reported by Bun for an exited subprocess (CPU times in microseconds, maxRSS in bytes)
+type ProcessUsage = NonNullable<ReturnType<Subprocess['resourceUsage']>>
+
+/**
+ * Convert subprocess resource usage
+ *
+ * @param usage - Usage from Subprocess.resourceUsage() after the process exited
+ * @returns Test resource usage, or undefined if the platform reported none
+ */
+export function toResourceUsage(usage: ProcessUsage | undefined): ResourceUsage | undefined {
+    if (!usage) {
+        return undefined
+    }
+    return {
+        maxRss: Number(usage.maxRSS),
+        userCpu: Number(usage.cpuTime.user) / 1000,
+        systemCpu: Number(usage.cpuTime.system) / 1000,
+        voluntarySwitches: Number(usage.contextSwitches.voluntary),
+        involuntarySwitches: Number(usage.contextSwitches.involuntary),
+    }
+}
+
+/**
+ * Combine the usage of two runs of a test
+ *
+ * @param total - Usage of the previous runs
+ * @param usage - Usage of the latest run
+ * @returns Summed CPU time and context switches with the peak memory of either, or whichever is defined
+ */
+export function combineResourceUsage(
+    total: ResourceUsage | undefined,
+    usage: ResourceUsage | undefined
+): ResourceUsage | undefined {
+    if (!total || !usage) {
+        return total ?? usage
+    }
+    return {
+        maxRss: Math.max(total.maxRss, usage.maxRss),
+        userCpu: total.userCpu + usage.userCpu,
+        systemCpu: total.systemCpu + usage.systemCpu,
+        voluntarySwitches: total.voluntarySwitches + usage.voluntarySwitches,
+        involuntarySwitches: total.involuntarySwitches + usage.involuntarySwitches,
+    }
+}
+
+/**
+ * Check a run's usage against the configured limits
+ *
+ * @param usage - Usage of one run of the test
+ * @param execution - Execution configuration with maxRss (MB) and maxCpu (seconds)
+ * @returns Description of the exceeded limits, or undefined if the run is within them
+ */
+export function checkResourceLimits(usage: ResourceUsage, execution?: ExecutionConfig): string | undefined {
+    const exceeded: string[] = []
+    const rss = usage.maxRss / (1024 * 1024)
+    if (execution?.maxRss && rss > execution.maxRss) {
+        exceeded.push(`Peak resident memory ${rss.toFixed(1)} MB exceeds maxRss of ${execution.maxRss} MB`)
+    }
+    const cpu = (usage.userCpu + usage.systemCpu) / 1000
+    if (execution?.maxCpu && cpu > execution.maxCpu) {
+        exceeded.push(`CPU time ${cpu.toFixed(3)}s exceeds maxCpu of ${execution.maxCpu}s`)
+    }
+    return exceeded.length > 0 ? exceeded.join('\n') : undefined
+}
+
+/**
+ * Format usage for detailed output
+ *
+ * @param usage - Test resource usage
+ * @returns One line summary, e.g. "12.4 MB peak RSS, CPU 35ms user + 4ms system, 12 voluntary / 3 involuntary switches"
+ */
+export function formatResourceUsage(usage: ResourceUsage): string {
+    const rss = (usage.maxRss / (1024 * 1024)).toFixed(1)
+    const cpu = `CPU ${Math.round(usage.userCpu)}ms user + ${Math.round(usage.systemCpu)}ms system`
+    const switches = `${usage.voluntarySwitches} voluntary / ${usage.involuntarySwitches} involuntary switches`
+    return `${rss} MB peak RSS, ${cpu}, ${switches}`
+}
@@ -0,0 +1,87 @@
+/*
+    result-channel.ts - Structured results written by test processes
+
+    Responsibilities:
+    - Name the NDJSON result file a test writes through TESTME_RESULT_FILE
+    - Read the records written by testme.h and the JS testme module and total the assertions
+
+    Record types:
+    - {"type":"assert","passed":true,"location":"...","message":"...","time":1.25} - One assertion
+    - {"type":"test","passed":true,"name":"...","time":3.5} - One JS test() block
+    - {"type":"passed","count":N} - Passing assertions counted silently in quiet-pass mode
+*/
+
+import type {AssertionCounts} from './assertion-counter.ts'
+import {mkdir, unlink} from 'node:fs/promises'
+import {dirname} from 'path'
+
+// Result file in the test's artifact directory (kept after the run for tooling)
+export const RESULT_FILE = 'results.ndjson'
+
+/**
+ * Prepare for a test run: ensure the directory exists and remove a stale result file
+ *
+ * @param path - Result file path
+ */
+export async function resetResults(path: string): Promise<void> {
+    try {
+        await mkdir(dirname(path), {recursive: true})
+        await unlink(path)
+    } catch {
+        // Not present
+    }
+}
+
+/**
+ * Read and total the records in a result file
+ *
+ * @remarks
+ * The file is streamed so tests writing millions of records do not need to fit in memory. A torn
+ * final record (the test crashed mid-write) is ignored.
+ *
+ * @param path - Result file path
+ * @returns Assertion counts, or null if the test did not write a result file
+ */
+export async function readResults(path: string): Promise<AssertionCounts | null> {
+    const file = Bun.file(path)
+    if (!(await file.exists())) {
+        return null
+    }
+    const counts: AssertionCounts = {passed: 0, failed: 0}
+    const decoder = new TextDecoder()
+    let partial = ''
+    for await (const chunk of file.stream()) {
+        const lines = (partial + decoder.decode(chunk, {stream: true})).split('\n')
+        partial = lines.pop()!
+        for (const line of lines) {
+            addRecord(line, counts)
+        }
+    }
+    addRecord(partial + decoder.decode(), counts)
+    return counts
+}
+
+/**
+ * Add one record to the totals
+ *
+ * @internal
+ */
+function addRecord(line: string, counts: AssertionCounts): void {
+    if (!line.trim()) {
+        return
+    }
+    try {
+        const record = JSON.parse(line)
+        if (record.type === 'assert' || record.type === 'test') {
+            if (record.passed) {
+                counts.passed++
+            } else {
+                counts.failed++
+            }
+        } else if (record.type === 'passed') {
+            counts.passed += Number(record.count) || 0
+        }
+    } catch {
+        // Torn or foreign line
+    }
+}
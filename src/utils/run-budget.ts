@@ -0,0 +1,182 @@
+/*
+    run-budget.ts - Capacity shared by the tests and compiles of concurrently running suites
+
+    Responsibilities:
+    - Limit the number of tests running at once across every configuration group of a run
+    - Schedule tests against the detected core count and free memory (re-sampled as tests finish)
+    - Limit concurrent compiles across suites
+    - Number the slots tests and compiles run in (trace lanes)
+*/
+
+import {PlatformDetector} from '../platform/detector.ts'
+import type {ExecutionConfig} from '../types.ts'
+
+/**
+ * Resources reserved by a running test
+ */
+export type TestResources = {
+    cpu: number // CPU cores
+    memory: number // Memory in MB
+    exclusive: boolean // Runs with no other tests
+}
+
+/**
+ * Test and compile capacity of a run
+ *
+ * @remarks
+ * A suite run on its own creates a budget from its own settings. When configuration groups run
+ * concurrently, they share one budget so the machine is never oversubscribed: a test from any group
+ * starts when a worker slot is free and its cores and memory fit. Waiters are woken on every
+ * release, so a test finishing in one group lets a queued test of another group start.
+ *
+ * The memory budget is the free memory when the budget is created. It is re-sampled whenever a
+ * test finishes, counting the memory still reserved by running tests as available to the budget,
+ * so memory used or freed by other processes during a long run is taken into account.
+ */
+export class RunBudget {
+    private usage = {cpu: 0, memory: 0, running: 0, exclusive: false}
+    private cpuBudget = PlatformDetector.getCpuCount()
+    private memoryBudget = PlatformDetector.getFreeMemory()
+    private freeSlots: number[]
+    private freeCompiles: number[]
+    private waiting: (() => void)[] = []
+
+    /**
+     * Create a budget
+     *
+     * @param workers - Tests running at once
+     * @param compiles - Compiles running at once
+     */
+    constructor(workers: number, compiles: number) {
+        this.freeSlots = Array.from({length: Math.max(1, workers)}, (_, i) => i)
+        this.freeCompiles = Array.from({length: Math.max(1, compiles)}, (_, i) => i)
+    }
+
+    /**
+     * Resolve the number of tests run at once
+     *
+     * @param execution - Execution settings
+     * @returns execution.workers, or the CPU core count when unset
+     */
+    static getWorkers(execution?: ExecutionConfig): number {
+        return execution?.workers || PlatformDetector.getCpuCount()
+    }
+
+    /**
+     * Resolve the number of compiles run at once
+     *
+     * @param execution - Execution settings
+     * @returns execution.compileWorkers, or the CPU core count when unset
+     */
+    static getCompiles(execution?: ExecutionConfig): number {
+        return execution?.compileWorkers || PlatformDetector.getCpuCount()
+    }
+
+    /**
+     * Check whether a test fits in the remaining capacity
+     *
+     * @param resources - Resources the test needs
+     * @returns True if the test can start now
+     */
+    fits(resources: TestResources): boolean {
+        if (this.freeSlots.length === 0) {
+            return false
+        }
+        if (this.usage.running === 0) {
+            return true // Always allow one test, even if it declares more than the machine has
+        }
+        if (this.usage.exclusive || resources.exclusive) {
+            return false
+        }
+        const cpu = this.usage.cpu + resources.cpu
+        const memory = this.usage.memory + resources.memory
+        return cpu <= this.cpuBudget && memory <= this.memoryBudget
+    }
+
+    /**
+     * Reserve capacity for a test that fits
+     *
+     * @param resources - Resources the test needs
+     * @returns Worker slot the test runs in
+     */
+    reserve(resources: TestResources): number {
+        this.usage.cpu += resources.cpu
+        this.usage.memory += resources.memory
+        this.usage.running++
+        this.usage.exclusive = this.usage.exclusive || resources.exclusive
+        return this.freeSlots.shift()!
+    }
+
+    /**
+     * Wait until a test fits, then reserve capacity for it
+     *
+     * @param resources - Resources the test needs
+     * @returns Worker slot the test runs in
+     */
+    async acquire(resources: TestResources): Promise<number> {
+        while (!this.fits(resources)) {
+            await this.changed()
+        }
+        return this.reserve(resources)
+    }
+
+    /**
+     * Release a finished test's capacity and wake waiters
+     *
+     * @param resources - Resources reserved for the test
+     * @param slot - Worker slot returned by reserve()
+     */
+    release(resources: TestResources, slot: number): void {
+        this.usage.cpu -= resources.cpu
+        this.usage.memory -= resources.memory
+        this.usage.running--
+        if (resources.exclusive) {
+            this.usage.exclusive = false
+        }
+        this.freeSlots.push(slot)
+        this.freeSlots.sort((a, b) => a - b)
+        this.memoryBudget = PlatformDetector.getFreeMemory() + this.usage.memory
+        this.wake()
+    }
+
+    /**
+     * Wait for a compile slot
+     *
+     * @returns Compile slot
+     */
+    async acquireCompile(): Promise<number> {
+        while (this.freeCompiles.length === 0) {
+            await this.changed()
+        }
+        return this.freeCompiles.shift()!
+    }
+
+    /**
+     * Release a compile slot and wake waiters
+     *
+     * @param slot - Compile slot returned by acquireCompile()
+     */
+    releaseCompile(slot: number): void {
+        this.freeCompiles.push(slot)
+        this.freeCompiles.sort((a, b) => a - b)
+        this.wake()
+    }
+
+    /**
+     * Wait for the next release or wake()
+     */
+    changed(): Promise<void> {
+        return new Promise<void>((resolve) => this.waiting.push(resolve))
+    }
+
+    /**
+     * Wake every waiter so it re-checks its condition
+     */
+    wake(): void {
+        const waiters = this.waiting
+        this.waiting = []
+        for (const resolve of waiters) {
+            resolve()
+        }
+    }
+}
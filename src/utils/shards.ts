@@ -0,0 +1,267 @@
+/*
+    shards.ts - Split a test run across CI nodes and merge the per-shard reports
+
+    Responsibilities:
+    - Parse --shard i/N specifications
+    - Deterministically assign discovered tests to shards by path, or balanced by the durations of a shared report
+    - Load JSON reports written by reportJson() and NDJSON reports written by --ndjson and convert them back to
+      test results for merging
+*/
+
+import type {TestFile, TestResult, TestStatus, TestType} from '../types.ts'
+import {basename, dirname, extname, join, relative} from 'path'
+
+// Weight of every test without --shard-timings, and of tests missing from the report when no test is in it
+const DEFAULT_WEIGHT = 1000
+
+/**
+ * Shard selection (1-based index of total shards)
+ */
+export type Shard = {
+    index: number
+    total: number
+}
+
+/**
+ * JSON report test entry as written by reportJson()
+ */
+type ReportTest = {
+    file: string
+    type: TestType
+    status: TestStatus
+    duration: number
+    exitCode?: number
+    error?: string
+    assertions?: {passed: number; failed: number}
+    benchmarks?: TestResult['benchmarks']
+}
+
+/**
+ * Parse a shard specification of the form "i/N"
+ *
+ * @param spec - Shard specification, e.g. "2/8"
+ * @returns Parsed shard
+ * @throws Error if the specification is malformed or out of range
+ */
+export function parseShard(spec: string): Shard {
+    const match = spec.match(/^(\d+)\/(\d+)$/)
+    if (!match) {
+        throw new Error(`Invalid shard "${spec}" - expected i/N, e.g. 1/4`)
+    }
+    const index = parseInt(match[1]!, 10)
+    const total = parseInt(match[2]!, 10)
+    if (total < 1 || index < 1 || index > total) {
+        throw new Error(`Invalid shard "${spec}" - index must be between 1 and ${total || 'N'}`)
+    }
+    return {index, total}
+}
+
+/**
+ * Select the tests belonging to a shard
+ *
+ * @remarks
+ * Tests are sorted by weight (longest first) then by path relative to rootDir, and greedily assigned
+ * to the least loaded shard. Without `timings` every test has the same weight, so tests are dealt
+ * round-robin in path order and the split only depends on the test set. Local duration history is
+ * never used as it differs between nodes. Pass a previous (merged) JSON report as `timings` to balance
+ * by its durations; every node must be given the same report.
+ *
+ * @param tests - All discovered tests
+ * @param shard - Shard to select
+ * @param rootDir - Root directory used for stable ordering
+ * @param timings - Optional JSON report whose durations balance the shards
+ * @returns Tests assigned to the shard, in discovery order
+ */
+export async function selectShard(
+    tests: TestFile[],
+    shard: Shard,
+    rootDir: string,
+    timings?: string
+): Promise<TestFile[]> {
+    if (shard.total === 1) {
+        return tests
+    }
+    const weights = await getWeights(tests, rootDir, timings)
+    const keyOf = (test: TestFile) => relative(rootDir, test.path).replace(/\\/g, '/')
+    const ordered = [...tests].sort((a, b) => {
+        const diff = weights.get(b)! - weights.get(a)!
+        if (diff !== 0) {
+            return diff
+        }
+        const ka = keyOf(a)
+        const kb = keyOf(b)
+        return ka < kb ? -1 : ka > kb ? 1 : 0
+    })
+
+    const loads = new Array<number>(shard.total).fill(0)
+    const selected = new Set<TestFile>()
+    for (const test of ordered) {
+        let target = 0
+        for (let i = 1; i < loads.length; i++) {
+            if (loads[i]! < loads[target]!) {
+                target = i
+            }
+        }
+        loads[target] = loads[target]! + weights.get(test)!
+        if (target === shard.index - 1) {
+            selected.add(test)
+        }
+    }
+    return tests.filter((test) => selected.has(test))
+}
+
+/**
+ * Load JSON reports and convert them to test results
+ *
+ * @remarks
+ * JSON reports are the stdout of a tm run with output.format 'json', which holds only the report.
+ * Files ending in .ndjson are read one test per line.
+ *
+ * @param files - Paths of JSON or NDJSON report files
+ * @returns Combined test results from all reports
+ * @throws Error if a file cannot be read or contains no report
+ */
+export async function loadReports(files: string[]): Promise<TestResult[]> {
+    const results: TestResult[] = []
+    for (const path of files) {
+        const report = await readReport(path)
+        for (const test of report.tests) {
+            results.push(toTestResult(test))
+        }
+    }
+    return results
+}
+
+/**
+ * Compute the scheduling weight of each test
+ *
+ * @internal
+ */
+async function getWeights(tests: TestFile[], rootDir: string, timings?: string): Promise<Map<TestFile, number>> {
+    const reported = timings ? await readReportDurations(timings) : undefined
+    const weights = new Map<TestFile, number>()
+    const known: number[] = []
+    for (const test of tests) {
+        const duration = reported ? findReportedDuration(reported, test, rootDir) : undefined
+        if (duration !== undefined) {
+            weights.set(test, Math.max(1, duration))
+            known.push(Math.max(1, duration))
+        }
+    }
+    // Tests missing from the report are weighted as a median test
+    known.sort((a, b) => a - b)
+    const fallback = known.length > 0 ? known[Math.floor(known.length / 2)]! : DEFAULT_WEIGHT
+    for (const test of tests) {
+        if (!weights.has(test)) {
+            weights.set(test, fallback)
+        }
+    }
+    return weights
+}
+
+/**
+ * Read test durations from a JSON report, indexed by file name
+ *
+ * @internal
+ */
+async function readReportDurations(path: string): Promise<Map<string, {file: string; duration: number}[]>> {
+    const report = await readReport(path)
+    const byName = new Map<string, {file: string; duration: number}[]>()
+    for (const test of report.tests) {
+        const file = test.file.replace(/\\/g, '/')
+        const name = basename(file)
+        const entries = byName.get(name) || []
+        entries.push({file, duration: test.duration})
+        byName.set(name, entries)
+    }
+    return byName
+}
+
+/**
+ * Find a test's duration in a report written on another machine (checkout roots may differ)
+ *
+ * @internal
+ */
+function findReportedDuration(
+    reported: Map<string, {file: string; duration: number}[]>,
+    test: TestFile,
+    rootDir: string
+): number | undefined {
+    const suffix = '/' + relative(rootDir, test.path).replace(/\\/g, '/')
+    const entries = reported.get(test.name) || []
+    return entries.find((entry) => ('/' + entry.file).endsWith(suffix))?.duration
+}
+
+/**
+ * Read the JSON document of a report file
+ *
+ * @internal
+ */
+async function readReport(path: string): Promise<{tests: ReportTest[]}> {
+    let text: string
+    try {
+        text = await Bun.file(path).text()
+    } catch (error) {
+        throw new Error(`Cannot read report ${path}: ${error}`)
+    }
+    if (path.endsWith('.ndjson')) {
+        return readNdjsonReport(path, text)
+    }
+    try {
+        const report = JSON.parse(text)
+        return {tests: Array.isArray(report.tests) ? report.tests : []}
+    } catch (error) {
+        throw new Error(`Invalid JSON test report in ${path}: ${error}`)
+    }
+}
+
+/**
+ * Read the test lines of an NDJSON report, skipping its summary line
+ *
+ * @internal
+ */
+function readNdjsonReport(path: string, text: string): {tests: ReportTest[]} {
+    const tests: ReportTest[] = []
+    for (const [index, line] of text.split('\n').entries()) {
+        if (!line.trim()) {
+            continue
+        }
+        try {
+            const entry = JSON.parse(line)
+            if (entry.file) {
+                tests.push(entry)
+            }
+        } catch (error) {
+            throw new Error(`Invalid NDJSON test report in ${path} at line ${index + 1}: ${error}`)
+        }
+    }
+    return {tests}
+}
+
+/**
+ * Convert a report entry back to a test result
+ *
+ * @internal
+ */
+function toTestResult(test: ReportTest): TestResult {
+    const name = basename(test.file)
+    const extension = extname(name)
+    const directory = dirname(test.file)
+    return {
+        file: {
+            path: test.file,
+            name,
+            extension,
+            type: test.type,
+            directory,
+            artifactDir: join(directory, '.testme', name.slice(0, -extension.length)),
+        },
+        status: test.status,
+        duration: test.duration,
+        output: '',
+        error: test.error,
+        exitCode: test.exitCode,
+        assertions: test.assertions,
+        benchmarks: test.benchmarks,
+    }
+}
@@ -0,0 +1,331 @@
+/*
+    stream-report.ts - Results streamed to NDJSON and JUnit XML files as tests complete
+
+    Responsibilities:
+    - Write each test result to --ndjson and --junit report files when the test completes
+    - Keep running totals for the report summaries, so the results are never rescanned
+    - Release the captured output of passed and skipped tests once it is on disk
+    - Build the JSON entry of a test shared by the JSON report and the NDJSON stream
+*/
+
+import type {TestResult} from '../types.ts'
+import {TestStatus} from '../types.ts'
+import {open, type FileHandle} from 'node:fs/promises'
+import {relative} from 'path'
+
+// Bytes reserved at the start of a JUnit report for the totals, rewritten when the run ends
+const JUNIT_HEADER_SIZE = 512
+
+// Characters that are not allowed in XML 1.0 documents
+const XML_INVALID = /[\x00-\x08\x0B\x0C\x0E-\x1F\uFFFE\uFFFF]/g
+
+/**
+ * Totals of a run's results
+ */
+export type ReportStats = {
+    total: number
+    passed: number
+    failed: number
+    errors: number
+    skipped: number
+    totalDuration: number // Sum of test durations in milliseconds
+    assertionsPassed: number
+    assertionsFailed: number
+    filesWithAssertions: number // Tests that reported assertion counts
+}
+
+/**
+ * Report files to stream results to
+ */
+export type StreamReportOptions = {
+    ndjson?: string // One JSON object per test, then a summary line (--ndjson)
+    junit?: string // JUnit XML (--junit)
+    rootDir?: string // Directory test paths are reported relative to in JUnit class names
+}
+
+/**
+ * An open report file
+ */
+type Sink = {
+    path: string
+    format: 'ndjson' | 'junit'
+    handle: FileHandle
+    position: number // Bytes written
+}
+
+/**
+ * Create empty totals
+ */
+export function emptyStats(): ReportStats {
+    return {
+        total: 0,
+        passed: 0,
+        failed: 0,
+        errors: 0,
+        skipped: 0,
+        totalDuration: 0,
+        assertionsPassed: 0,
+        assertionsFailed: 0,
+        filesWithAssertions: 0,
+    }
+}
+
+/**
+ * Add a result to run totals
+ *
+ * @param stats - Totals to update
+ * @param result - Completed test result
+ * @returns The updated totals
+ */
+export function addStats(stats: ReportStats, result: TestResult): ReportStats {
+    stats.total++
+    stats.totalDuration += result.duration
+
+    switch (result.status) {
+        case TestStatus.Passed:
+            stats.passed++
+            break
+        case TestStatus.Failed:
+            stats.failed++
+            break
+        case TestStatus.Error:
+            stats.errors++
+            break
+        case TestStatus.Skipped:
+            stats.skipped++
+            break
+    }
+
+    // Accumulate assertion counts
+    if (result.assertions) {
+        stats.assertionsPassed += result.assertions.passed
+        stats.assertionsFailed += result.assertions.failed
+        stats.filesWithAssertions++
+    }
+    return stats
+}
+
+/**
+ * Build the JSON report entry of a test
+ *
+ * @param result - Test result
+ * @returns Entry written to the tests array of the JSON report and to NDJSON lines
+ */
+export function toReportEntry(result: TestResult): Record<string, unknown> {
+    return {
+        file: result.file.path,
+        type: result.file.type,
+        status: result.status,
+        duration: result.duration,
+        exitCode: result.exitCode,
+        error: result.error,
+        ...(result.assertions && {assertions: result.assertions}),
+        ...(result.benchmarks && {benchmarks: result.benchmarks}),
+        ...(result.perf && {perf: result.perf}),
+        ...(result.resources && {resources: result.resources}),
+    }
+}
+
+/**
+ * Run-level streaming reporter
+ *
+ * @remarks
+ * Disabled until start() opens a report file. Every TestReporter passes completed results to add(),
+ * so the results of concurrently running configuration groups go to the same files. Writes are
+ * queued in completion order and never block the test workers.
+ *
+ * JUnit XML puts the totals in the opening tags, so the report starts with a fixed-size header that
+ * is rewritten in place by finish().
+ */
+export class StreamReport {
+    private static sinks: Sink[] = []
+    private static stats = emptyStats()
+    private static queue: Promise<void> = Promise.resolve()
+    private static started = Date.now()
+    private static rootDir = process.cwd()
+
+    /**
+     * Open the report files
+     *
+     * @param options - Report file paths
+     * @throws Error if a report file cannot be created
+     */
+    static async start(options: StreamReportOptions): Promise<void> {
+        this.started = Date.now()
+        this.rootDir = options.rootDir ?? process.cwd()
+        for (const [format, path] of [
+            ['ndjson', options.ndjson],
+            ['junit', options.junit],
+        ] as const) {
+            if (!path) {
+                continue
+            }
+            let handle: FileHandle
+            try {
+                handle = await open(path, 'w')
+            } catch (error) {
+                throw new Error(`Cannot create report ${path}: ${error}`)
+            }
+            const sink: Sink = {path, format, handle, position: 0}
+            this.sinks.push(sink)
+            if (format === 'junit') {
+                this.write(sink, this.junitHeader())
+            }
+        }
+    }
+
+    /**
+     * Whether results are being streamed
+     */
+    static get enabled(): boolean {
+        return this.sinks.length > 0
+    }
+
+    /**
+     * Stream a completed test result
+     *
+     * @param result - Completed test result
+     * @param keepOutput - Keep the captured output in memory (it is printed by the final report)
+     */
+    static add(result: TestResult, keepOutput: boolean): void {
+        if (!this.enabled) {
+            return
+        }
+        addStats(this.stats, result)
+        for (const sink of this.sinks) {
+            this.write(sink, sink.format === 'ndjson' ? this.ndjsonLine(result) : this.junitCase(result))
+        }
+        // Passed and skipped output is only needed on disk; failure output is kept for the failure report
+        if (!keepOutput && (result.status === TestStatus.Passed || result.status === TestStatus.Skipped)) {
+            this.queue = this.queue.then(() => {
+                result.output = ''
+            })
+        }
+    }
+
+    /**
+     * Write the summaries and close the report files
+     *
+     * @remarks
+     * Failures are reported but do not fail the run.
+     */
+    static async finish(): Promise<void> {
+        if (!this.enabled) {
+            return
+        }
+        const elapsedTime = Date.now() - this.started
+        for (const sink of this.sinks) {
+            if (sink.format === 'ndjson') {
+                this.write(sink, JSON.stringify({summary: {...this.stats, elapsedTime}}) + '\n')
+            } else {
+                this.write(sink, '    </testsuite>\n</testsuites>\n')
+                this.queue = this.queue.then(async () => {
+                    await sink.handle.write(this.junitHeader(elapsedTime), 0).catch(() => {})
+                })
+            }
+        }
+        await this.queue
+        for (const sink of this.sinks) {
+            await sink.handle.close().catch(() => {})
+        }
+        this.sinks = []
+    }
+
+    /**
+     * Queue text to append to a report file
+     *
+     * @internal
+     */
+    private static write(sink: Sink, text: string): void {
+        this.queue = this.queue.then(async () => {
+            if (!this.sinks.includes(sink)) {
+                return
+            }
+            try {
+                const {bytesWritten} = await sink.handle.write(text, sink.position)
+                sink.position += bytesWritten
+            } catch (error) {
+                console.warn(`Warning: Could not write report ${sink.path}: ${error}`)
+                this.sinks = this.sinks.filter((other) => other !== sink)
+                await sink.handle.close().catch(() => {})
+            }
+        })
+    }
+
+    /**
+     * Format a result as an NDJSON line including its output
+     *
+     * @internal
+     */
+    private static ndjsonLine(result: TestResult): string {
+        return JSON.stringify({...toReportEntry(result), ...(result.output && {output: result.output})}) + '\n'
+    }
+
+    /**
+     * Format the JUnit XML declaration and opening tags, padded to JUNIT_HEADER_SIZE bytes
+     *
+     * @internal
+     */
+    private static junitHeader(elapsedTime = 0): string {
+        const stats = this.stats
+        const totals =
+            `tests="${stats.total}" failures="${stats.failed}" errors="${stats.errors}" ` +
+            `skipped="${stats.skipped}" time="${(elapsedTime / 1000).toFixed(3)}"`
+        const timestamp = new Date(this.started).toISOString().slice(0, 19)
+        const header =
+            '<?xml version="1.0" encoding="UTF-8"?>\n' +
+            `<testsuites name="testme" ${totals}>\n` +
+            `    <testsuite name="testme" ${totals} timestamp="${timestamp}">`
+        return header.slice(0, -1) + ' '.repeat(Math.max(0, JUNIT_HEADER_SIZE - header.length - 1)) + '>\n'
+    }
+
+    /**
+     * Format a result as a JUnit test case
+     *
+     * @internal
+     */
+    private static junitCase(result: TestResult): string {
+        const classname = relative(this.rootDir, result.file.directory).replace(/\\/g, '/') || '.'
+        const attributes =
+            `name="${escapeXml(result.file.name)}" classname="${escapeXml(classname)}" ` +
+            `file="${escapeXml(result.file.path)}" time="${(result.duration / 1000).toFixed(3)}"`
+        let body = ''
+        if (result.status === TestStatus.Failed || result.status === TestStatus.Error) {
+            const tag = result.status === TestStatus.Failed ? 'failure' : 'error'
+            const message = (result.error || `Exit code ${result.exitCode ?? 'unknown'}`).split('\n')[0]!
+            body += `            <${tag} message="${escapeXml(message)}">${cdata(result.error || '')}</${tag}>\n`
+        } else if (result.status === TestStatus.Skipped) {
+            body += `            <skipped${result.error ? ` message="${escapeXml(result.error)}"` : ''}/>\n`
+        }
+        if (result.output) {
+            body += `            <system-out>${cdata(result.output)}</system-out>\n`
+        }
+        return body
+            ? `        <testcase ${attributes}>\n${body}        </testcase>\n`
+            : `        <testcase ${attributes}/>\n`
+    }
+}
+
+/**
+ * Escape text for an XML attribute
+ *
+ * @internal
+ */
+function escapeXml(text: string): string {
+    return text
+        .replace(XML_INVALID, '')
+        .replace(/&/g, '&amp;')
+        .replace(/</g, '&lt;')
+        .replace(/>/g, '&gt;')
+        .replace(/"/g, '&quot;')
+        .replace(/\n/g, '&#10;')
+}
+
+/**
+ * Wrap text in a CDATA section
+ *
+ * @internal
+ */
+function cdata(text: string): string {
+    return text ? `<![CDATA[${text.replace(XML_INVALID, '').replace(/]]>/g, ']]]]><![CDATA[>')}]]>` : ''
+}
@@ -0,0 +1,187 @@
+/*
+    timings.ts - Per-test duration and failure history used for scheduling
+
+    Responsibilities:
+    - Load and save test history from .testme/timings.json in each test directory
+    - Track a moving average of each test's duration and failure rate
+    - Order tests longest-first for parallel runs, and fast failing tests first for stopOnFailure
+*/
+
+import type {TestFile, TestResult} from '../types.ts'
+import {TestStatus} from '../types.ts'
+import {basename, dirname, join} from 'path'
+import {mkdir} from 'node:fs/promises'
+
+// History file stored next to the per-test artifact directories (<dir>/.testme/timings.json)
+export const TIMINGS_FILE = 'timings.json'
+
+// Weight of the latest run in the moving averages
+const SMOOTHING = 0.5
+
+/**
+ * Recorded history for a single test
+ */
+export type TestTiming = {
+    duration: number // Moving average of the test duration in milliseconds
+    failRate: number // Moving average of failures (0 = always passes, 1 = always fails)
+    runs: number // Number of recorded runs
+}
+
+/**
+ * Duration and failure history for a set of tests
+ *
+ * @remarks
+ * History is grouped by test directory so each `.testme/timings.json` is read and written once per run.
+ * Saving merges with the file on disk so concurrent runs over different tests in a directory keep
+ * each other's entries. Missing or corrupt files are treated as empty history.
+ */
+export class TimingHistory {
+    // Entries by history file path, then by test file name
+    private files = new Map<string, Record<string, TestTiming>>()
+    private updated = new Map<string, Record<string, TestTiming>>()
+
+    /**
+     * Load the history for the given tests
+     *
+     * @param tests - Tests to load history for
+     * @returns History covering every directory containing one of the tests
+     */
+    static async load(tests: TestFile[]): Promise<TimingHistory> {
+        const history = new TimingHistory()
+        const paths = [...new Set(tests.map((test) => TimingHistory.getHistoryPath(test)))]
+        await Promise.all(
+            paths.map(async (path) => {
+                history.files.set(path, await TimingHistory.readFile(path))
+            })
+        )
+        return history
+    }
+
+    /**
+     * Get the recorded history of a test
+     *
+     * @param test - Test file
+     * @returns History entry or undefined if the test has never run
+     */
+    get(test: TestFile): TestTiming | undefined {
+        return this.files.get(TimingHistory.getHistoryPath(test))?.[test.name]
+    }
+
+    /**
+     * Order tests for execution
+     *
+     * @remarks
+     * Parallel runs use longest-processing-time-first so slow tests don't start last and run alone.
+     * Tests without history are treated as long and run first so their duration is learned.
+     * With stopOnFailure, tests that failed recently run first, fastest first, so a failing run stops early.
+     * Sequential runs keep discovery order apart from moving failing tests first under stopOnFailure.
+     *
+     * @param tests - Tests in discovery order
+     * @param options - Execution mode
+     * @returns Tests in scheduling order (a new array)
+     */
+    order(tests: TestFile[], options: {parallel: boolean; stopOnFailure: boolean}): TestFile[] {
+        const failing: TestFile[] = []
+        const rest: TestFile[] = []
+        for (const test of tests) {
+            const timing = this.get(test)
+            if (options.stopOnFailure && timing && timing.failRate > 0) {
+                failing.push(test)
+            } else {
+                rest.push(test)
+            }
+        }
+        // Array.sort is stable so ties keep discovery order
+        failing.sort((a, b) => this.get(a)!.duration - this.get(b)!.duration)
+        if (options.parallel) {
+            const unknown = Number.MAX_SAFE_INTEGER
+            rest.sort((a, b) => (this.get(b)?.duration ?? unknown) - (this.get(a)?.duration ?? unknown))
+        }
+        return [...failing, ...rest]
+    }
+
+    /**
+     * Record results from this run
+     *
+     * @param results - Test results (skipped tests are ignored)
+     */
+    record(results: TestResult[]): void {
+        for (const result of results) {
+            if (result.status === TestStatus.Skipped) {
+                continue
+            }
+            const path = TimingHistory.getHistoryPath(result.file)
+            const failed = result.status === TestStatus.Failed || result.status === TestStatus.Error ? 1 : 0
+            const previous = this.get(result.file)
+            const timing: TestTiming = previous
+                ? {
+                      duration: SMOOTHING * result.duration + (1 - SMOOTHING) * previous.duration,
+                      failRate: SMOOTHING * failed + (1 - SMOOTHING) * previous.failRate,
+                      runs: previous.runs + 1,
+                  }
+                : {duration: result.duration, failRate: failed, runs: 1}
+            // Drop failure history once it has decayed to noise
+            if (timing.failRate < 0.01) {
+                timing.failRate = 0
+            }
+            timing.duration = Math.round(timing.duration)
+
+            let entries = this.updated.get(path)
+            if (!entries) {
+                entries = {}
+                this.updated.set(path, entries)
+            }
+            entries[result.file.name] = timing
+            const loaded = this.files.get(path) || {}
+            loaded[result.file.name] = timing
+            this.files.set(path, loaded)
+        }
+    }
+
+    /**
+     * Save updated entries, merging with any changes made on disk since load()
+     */
+    async save(): Promise<void> {
+        await Promise.all(
+            [...this.updated.entries()].map(async ([path, entries]) => {
+                try {
+                    const current = await TimingHistory.readFile(path)
+                    await mkdir(dirname(path), {recursive: true})
+                    await Bun.write(path, JSON.stringify({...current, ...entries}, null, 2) + '\n')
+                } catch {
+                    // History is an optimization - ignore write errors
+                }
+            })
+        )
+        this.updated.clear()
+    }
+
+    /**
+     * Get the history file for a test (<test dir>/.testme/timings.json)
+     *
+     * @internal
+     */
+    private static getHistoryPath(test: TestFile): string {
+        const artifactParent = dirname(test.artifactDir)
+        const dir = basename(artifactParent) === '.testme' ? artifactParent : join(test.directory, '.testme')
+        return join(dir, TIMINGS_FILE)
+    }
+
+    /**
+     * Read a history file, returning empty history if it is missing or corrupt
+     *
+     * @internal
+     */
+    private static async readFile(path: string): Promise<Record<string, TestTiming>> {
+        try {
+            const file = Bun.file(path)
+            if (!(await file.exists())) {
+                return {}
+            }
+            const data = await file.json()
+            return data && typeof data === 'object' ? data : {}
+        } catch {
+            return {}
+        }
+    }
+}
@@ -0,0 +1,219 @@
+/*
+    trace.ts - Run-level timing profile exported as a Chrome trace
+
+    Responsibilities:
+    - Record spans for run phases (discovery, config, services, health checks, reporting) and per test
+      stages (compile, spawn, run, teardown)
+    - Attribute spans to lanes: the runner, each parallel worker and each compile worker
+    - Write the spans as Chrome trace-event JSON (chrome://tracing, https://ui.perfetto.dev)
+    - Summarize time per phase for the JSON report
+*/
+
+import {AsyncLocalStorage} from 'node:async_hooks'
+import {mkdir} from 'node:fs/promises'
+import {dirname} from 'path'
+
+// Lane of spans recorded outside any worker
+export const RUNNER_LANE = 0
+
+// Compile worker lanes follow the test worker lanes
+export const COMPILE_LANE = 1000
+
+// Configuration group lanes (services of concurrently running groups)
+export const GROUP_LANE = 2000
+
+/**
+ * One event in Chrome trace-event format: a complete span ("X") or lane name ("M"), times in microseconds
+ */
+type TraceEvent = {
+    name: string
+    cat: string
+    ph: 'X' | 'M'
+    ts: number
+    dur?: number
+    pid: number
+    tid: number
+    args?: Record<string, unknown>
+}
+
+/**
+ * Context inherited by asynchronous work started inside a lane or span
+ */
+type TraceContext = {
+    lane: number
+    stages: string[] // Categories of the enclosing spans, innermost last
+}
+
+/**
+ * Time per phase, included in the JSON report
+ */
+export type TraceSummary = {
+    file: string // Trace file
+    phases: Record<string, number> // Milliseconds per phase (nested spans of the same phase count once)
+    spans: number // Number of spans recorded
+}
+
+/**
+ * Run-level trace recorder
+ *
+ * @remarks
+ * Disabled until start() is called, so instrumented code costs one property check per span. Spans
+ * are complete events with a start time and duration. The lane of asynchronous work is carried by
+ * AsyncLocalStorage, so spans recorded deep inside handlers land on the worker that ran the test.
+ */
+export class Trace {
+    private static path?: string
+    private static events: TraceEvent[] = []
+    private static lanes = new Map<number, string>([[RUNNER_LANE, 'Runner']])
+    private static phases: Record<string, number> = {}
+    private static context = new AsyncLocalStorage<TraceContext>()
+    private static origin = performance.now()
+
+    /**
+     * Start recording
+     *
+     * @param path - Trace file written by write()
+     */
+    static start(path: string): void {
+        this.path = path
+        this.origin = performance.now()
+    }
+
+    /**
+     * Whether spans are being recorded
+     */
+    static get enabled(): boolean {
+        return this.path !== undefined
+    }
+
+    /**
+     * Run work on a lane (a parallel worker or compile worker)
+     *
+     * @param lane - Lane number
+     * @param name - Lane name shown in the trace viewer
+     * @param fn - Work to run
+     */
+    static async lane<T>(lane: number, name: string, fn: () => Promise<T>): Promise<T> {
+        if (!this.enabled) {
+            return await fn()
+        }
+        this.lanes.set(lane, name)
+        return await this.context.run({lane, stages: []}, fn)
+    }
+
+    /**
+     * Record a span around asynchronous work
+     *
+     * @param name - Span name (e.g. "compile math.tst.c")
+     * @param category - Phase the span belongs to (e.g. "compile", "run", "services")
+     * @param fn - Work to measure
+     * @param args - Values shown with the span in the trace viewer
+     * @returns Result of fn
+     */
+    static async span<T>(
+        name: string,
+        category: string,
+        fn: () => Promise<T>,
+        args?: Record<string, unknown>
+    ): Promise<T> {
+        if (!this.enabled) {
+            return await fn()
+        }
+        const parent = this.context.getStore()
+        const context = {lane: parent?.lane ?? RUNNER_LANE, stages: [...(parent?.stages ?? []), category]}
+        const start = performance.now()
+        try {
+            return await this.context.run(context, fn)
+        } finally {
+            this.record(name, category, start, performance.now(), args, parent)
+        }
+    }
+
+    /**
+     * Record a span that has already finished
+     *
+     * @param name - Span name
+     * @param category - Phase the span belongs to
+     * @param start - Start time from performance.now()
+     * @param end - End time from performance.now()
+     * @param args - Values shown with the span in the trace viewer
+     * @param parent - Enclosing context (default: the current one)
+     */
+    static record(
+        name: string,
+        category: string,
+        start: number,
+        end: number,
+        args?: Record<string, unknown>,
+        parent: TraceContext | undefined = this.context.getStore()
+    ): void {
+        if (!this.enabled) {
+            return
+        }
+        this.events.push({
+            name,
+            cat: category,
+            ph: 'X',
+            ts: Math.round((start - this.origin) * 1000),
+            dur: Math.round((end - start) * 1000),
+            pid: 1,
+            tid: parent?.lane ?? RUNNER_LANE,
+            ...(args && {args}),
+        })
+        // Count a phase once: the compiler process inside a compile span is recorded as compile time
+        if (!parent?.stages.includes(category)) {
+            this.phases[category] = (this.phases[category] ?? 0) + (end - start)
+        }
+    }
+
+    /**
+     * Get the category of the innermost span enclosing the caller
+     */
+    static get stage(): string | undefined {
+        return this.context.getStore()?.stages.at(-1)
+    }
+
+    /**
+     * Summarize the recorded spans
+     *
+     * @returns Time per phase, or undefined if tracing is disabled
+     */
+    static summary(): TraceSummary | undefined {
+        if (!this.path) {
+            return undefined
+        }
+        const phases: Record<string, number> = {}
+        for (const [category, ms] of Object.entries(this.phases)) {
+            phases[category] = Math.round(ms * 100) / 100
+        }
+        return {file: this.path, phases, spans: this.events.length}
+    }
+
+    /**
+     * Write the trace file
+     *
+     * @remarks
+     * Failures are reported but do not fail the run.
+     */
+    static async write(): Promise<void> {
+        if (!this.path) {
+            return
+        }
+        const names: TraceEvent[] = [...this.lanes].map(([tid, name]) => ({
+            name: 'thread_name',
+            cat: '__metadata',
+            ph: 'M',
+            ts: 0,
+            pid: 1,
+            tid,
+            args: {name},
+        }))
+        try {
+            await mkdir(dirname(this.path), {recursive: true})
+            const trace = {traceEvents: [...names, ...this.events], displayTimeUnit: 'ms'}
+            await Bun.write(this.path, JSON.stringify(trace))
+        } catch (error) {
+            console.warn(`Warning: Could not write trace ${this.path}: ${error}`)
+        }
+    }
+}
@@ -3,6 +3,8 @@
  Provides functions to detect interactive terminals and control cursor/line output
  */
 
+import {Log} from './log.ts'
+
 /*
  Checks if the output is an interactive terminal (TTY)
  @returns true if stdout is a TTY, false otherwise
@@ -84,10 +86,10 @@ export const ANSI = {
  */
 export function writeOverwritable(text: string): void {
     if (isInteractiveTTY() && supportsANSI()) {
-        Bun.write(Bun.stdout, ANSI.clearLineAndReset + text)
+        Log.stream.write(ANSI.clearLineAndReset + text)
     } else if (isInteractiveTTY()) {
         // Fallback for terminals without ANSI: just write normally with newline
-        console.log(text)
+        Log.info(text)
     }
 }
 
@@ -98,10 +100,10 @@ export function writeOverwritable(text: string): void {
  */
 export function clearCurrentLine(): void {
     if (isInteractiveTTY() && supportsANSI()) {
-        Bun.write(Bun.stdout, ANSI.clearLineAndReset)
+        Log.stream.write(ANSI.clearLineAndReset)
     } else if (isInteractiveTTY()) {
         // Fallback for non-ANSI terminals: just move to new line
-        process.stdout.write('\n')
+        Log.stream.write('\n')
     }
 }
 
@@ -110,5 +112,5 @@ export function clearCurrentLine(): void {
  @param text Text to write
  */
 export function writeLine(text: string): void {
-    console.log(text)
+    Log.info(text)
 }
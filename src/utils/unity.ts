@@ -0,0 +1,165 @@
+/*
+    unity.ts - Drivers for C tests written with TM_TEST() functions
+
+    Responsibilities:
+    - Find the TM_TEST(name) functions defined by a C test file
+    - Generate a driver that includes one or more test files and runs their tests through tUnityMain()
+    - Split driver output framed by TESTME_UNITY_BEGIN/END lines into per-file sections
+*/
+
+import {mkdir} from 'node:fs/promises'
+import {dirname} from 'path'
+
+// TM_TEST(name) at the start of a line
+const TEST_PATTERN = /^[ \t]*TM_TEST\s*\(\s*([A-Za-z_]\w*)\s*\)/gm
+
+// Framing lines written by tUnityMain() around each test file (file names may contain spaces)
+const BEGIN_PATTERN = /^TESTME_UNITY_BEGIN (.+)$/
+const END_PATTERN = /^TESTME_UNITY_END (.+) (\d+) ([\d.]+)$/
+
+// Characters that cannot appear in an #include "path" or a framing line
+const UNSAFE_PATH = /["\r\n]/
+
+/**
+ * Test file included in a driver
+ */
+export type UnityUnit = {
+    path: string // Absolute path of the test file
+    name: string // Test file base name, used to select and report the file
+    tests: string[] // TM_TEST function names in definition order
+}
+
+/**
+ * Output of one test file run by a driver
+ */
+export type UnitySection = {
+    name: string // Test file base name
+    output: string // Output between the framing lines (stderr merged into stdout)
+    failed: boolean
+    duration: number // Milliseconds measured by the driver
+    complete: boolean // False if the driver stopped (crash, exit() or timeout) before the file finished
+}
+
+/**
+ * Find the TM_TEST functions defined in a C source file
+ *
+ * @param source - C source text
+ * @returns Test names, or empty if the file does not use TM_TEST (it defines its own main())
+ */
+export function findUnityTests(source: string): string[] {
+    const names: string[] = []
+    for (const match of source.matchAll(TEST_PATTERN)) {
+        names.push(match[1]!)
+    }
+    return names
+}
+
+/**
+ * Check whether a test file can be included in a driver
+ *
+ * @param path - Test file path
+ * @returns False for paths with quotes or line breaks, which are run by the regular C handler
+ */
+export function canInclude(path: string): boolean {
+    return !UNSAFE_PATH.test(path)
+}
+
+/**
+ * Generate a driver that compiles the given test files into one program
+ *
+ * @remarks
+ * Each file is included with its own TM_UNIT prefix so tests with equal names in different files
+ * do not collide. Other file-scope names still share one translation unit, so files defining the
+ * same static helpers cannot be combined and fail to compile together.
+ * Paths must pass canInclude().
+ *
+ * @param units - Test files and their tests
+ * @returns Driver source
+ */
+export function generateDriver(units: UnityUnit[]): string {
+    const lines = ['/* Generated by TestMe - do not edit */', '#define TM_UNITY 1']
+    const entries: string[] = []
+    units.forEach((unit, index) => {
+        const prefix = `tm${index + 1}_`
+        lines.push('#undef TM_UNIT', `#define TM_UNIT ${prefix}`, `#include "${unit.path.replace(/\\/g, '/')}"`)
+        const name = unit.name.replace(/[\\"]/g, '\\$&')
+        for (const test of unit.tests) {
+            entries.push(`    {"${name}", "${test}", ${prefix}${test}},`)
+        }
+    })
+    lines.push(
+        '',
+        'static const TmUnityTest tmUnityTests[] = {',
+        ...entries,
+        '};',
+        '',
+        'int main(int argc, char **argv)',
+        '{',
+        '    return tUnityMain(tmUnityTests, sizeof(tmUnityTests) / sizeof(tmUnityTests[0]), argc, argv);',
+        '}',
+        ''
+    )
+    return lines.join('\n')
+}
+
+/**
+ * Split driver output into per-file sections
+ *
+ * @param output - Driver stdout (stderr is merged by tUnityMain)
+ * @returns Sections in run order. The last section is incomplete if the driver stopped inside a file.
+ */
+export function parseUnityOutput(output: string): UnitySection[] {
+    const sections: UnitySection[] = []
+    let current: UnitySection | null = null
+    let lines: string[] = []
+    for (const line of output.split(/\r?\n/)) {
+        const begin = line.match(BEGIN_PATTERN)
+        const end = line.match(END_PATTERN)
+        if (begin) {
+            current = {name: begin[1]!, output: '', failed: false, duration: 0, complete: false}
+            lines = []
+            sections.push(current)
+        } else if (end && current && end[1] === current.name) {
+            current.output = lines.join('\n')
+            current.failed = end[2] !== '0'
+            current.duration = parseFloat(end[3]!)
+            current.complete = true
+            current = null
+        } else if (current) {
+            lines.push(line)
+        }
+    }
+    if (current) {
+        current.output = lines.join('\n')
+        current.failed = true
+    }
+    return sections
+}
+
+/**
+ * Write a generated file only if its content changed, so the binary cache sees an unchanged mtime
+ *
+ * @param path - File path
+ * @param content - File content
+ */
+export async function writeIfChanged(path: string, content: string): Promise<void> {
+    const file = Bun.file(path)
+    if ((await file.exists()) && (await file.text()) === content) {
+        return
+    }
+    await mkdir(dirname(path), {recursive: true})
+    await Bun.write(path, content)
+}
+
+/**
+ * Remove the framing lines from driver output
+ *
+ * @param output - Driver output
+ * @returns Output without TESTME_UNITY_BEGIN/END lines
+ */
+export function stripUnityFraming(output: string): string {
+    return output
+        .split(/\r?\n/)
+        .filter((line) => !BEGIN_PATTERN.test(line) && !END_PATTERN.test(line))
+        .join('\n')
+}
@@ -0,0 +1,348 @@
+import type {TestFile} from './types.ts'
+import {TestType} from './types.ts'
+import {CTestHandler} from './handlers/c.ts'
+import {UnityTestHandler} from './handlers/unity.ts'
+import {watch, type FSWatcher} from 'node:fs'
+import {readdir, stat} from 'node:fs/promises'
+import {dirname, join, resolve, sep} from 'path'
+
+/*
+ Watch mode support - file watching and test dependency tracking
+
+ Responsibilities:
+ - Watches the test tree with native recursive file watching and batches change events
+ - Watches the directories of recorded dependencies outside the test tree (e.g. headers in ../include)
+ - Maps changed files to the tests they affect:
+   - C tests via the header dependencies recorded by each build variant (compile.deps, compile-<variant>.deps),
+     including the record of the shared unity driver a TM_TEST test was batched into
+   - JS/TS tests via their relative import graph
+   - Config files affect every test at or below their directory
+ */
+
+// Quiet period after the last change event before a batch is delivered
+const DEBOUNCE = 150
+
+// Modules resolved for relative JS/TS imports
+const IMPORT_EXTENSIONS = ['', '.ts', '.tsx', '.js', '.mjs', '.cjs', '/index.ts', '/index.js']
+
+// Relative import specifiers: import/export ... from '...', import('...'), require('...'), import '...'
+const IMPORT_PATTERN = /(?:from\s+|import\s*\(\s*|require\s*\(\s*|import\s+)['"](\.{1,2}\/[^'"]+)['"]/g
+
+/*
+ Watches a directory tree and reports batches of changed files
+ */
+export class TestWatcher {
+    private rootDir: string
+    private onChange: (paths: string[]) => void
+    private watcher: FSWatcher | null = null
+    // Directories outside rootDir holding dependencies -> their (non-recursive) watchers
+    private external = new Map<string, FSWatcher>()
+    private pending = new Set<string>()
+    private timer: ReturnType<typeof setTimeout> | null = null
+
+    /*
+     Creates a watcher for a directory tree
+     @param rootDir Root directory to watch recursively
+     @param onChange Callback receiving absolute paths of changed files after events settle
+     */
+    constructor(rootDir: string, onChange: (paths: string[]) => void) {
+        this.rootDir = rootDir
+        this.onChange = onChange
+    }
+
+    /*
+     Starts watching. Changes inside artifact, hidden and node_modules directories are ignored.
+     */
+    start(): void {
+        this.watcher = watch(this.rootDir, {recursive: true}, (_event, filename) => this.record(this.rootDir, filename))
+    }
+
+    /*
+     Watches the directories of dependencies outside rootDir, which the recursive watch does not see.
+     Directories no longer holding a dependency stop being watched. Call after each dependency graph build.
+     @param files Absolute paths of dependencies (DependencyGraph.files())
+     */
+    watchDependencies(files: string[]): void {
+        const root = this.rootDir + sep
+        const dirs = new Set(files.map((file) => dirname(file)).filter((dir) => !(dir + sep).startsWith(root)))
+        for (const [dir, watcher] of this.external) {
+            if (!dirs.has(dir)) {
+                watcher.close()
+                this.external.delete(dir)
+            }
+        }
+        for (const dir of dirs) {
+            if (this.external.has(dir)) {
+                continue
+            }
+            try {
+                this.external.set(dir, watch(dir, (_event, filename) => this.record(dir, filename)))
+            } catch {
+                // Directory removed since the dependency was recorded
+            }
+        }
+    }
+
+    /*
+     Stops watching and discards pending events
+     */
+    close(): void {
+        if (this.timer) {
+            clearTimeout(this.timer)
+            this.timer = null
+        }
+        this.pending.clear()
+        this.watcher?.close()
+        this.watcher = null
+        for (const watcher of this.external.values()) {
+            watcher.close()
+        }
+        this.external.clear()
+    }
+
+    /*
+     Adds a change event to the pending batch
+     @param dir Watched directory
+     @param filename Changed path relative to dir
+     */
+    private record(dir: string, filename: string | Buffer | null): void {
+        if (!filename) {
+            return
+        }
+        const name = filename.toString()
+        if (this.isIgnored(name)) {
+            return
+        }
+        this.pending.add(resolve(dir, name))
+        if (this.timer) {
+            clearTimeout(this.timer)
+        }
+        this.timer = setTimeout(() => this.flush(), DEBOUNCE)
+    }
+
+    /*
+     Delivers the pending batch of changed files
+     */
+    private flush(): void {
+        this.timer = null
+        const paths = [...this.pending]
+        this.pending.clear()
+        if (paths.length > 0) {
+            this.onChange(paths)
+        }
+    }
+
+    /*
+     Checks if a changed path should be ignored
+     @param name Path relative to the watched directory
+     @returns true for paths inside hidden directories (.testme, .git) or node_modules
+     */
+    private isIgnored(name: string): boolean {
+        return name.split(/[\\/]/).some((part) => part.startsWith('.') || part === 'node_modules')
+    }
+}
+
+/*
+ Dependency graph mapping source files to the tests that use them
+ */
+export class DependencyGraph {
+    // Absolute file path -> paths of tests depending on it
+    private dependents = new Map<string, Set<string>>()
+
+    /*
+     Builds the dependency graph for a set of tests
+     @param tests Discovered test files
+     @returns Dependency graph
+     */
+    static async build(tests: TestFile[]): Promise<DependencyGraph> {
+        const graph = new DependencyGraph()
+        const importCache = new Map<string, Promise<string[]>>()
+        await Promise.all(
+            tests.map(async (test) => {
+                let dependencies: string[] = []
+                if (test.type === TestType.C) {
+                    dependencies = await this.readCompileDependencies(test)
+                } else if (test.type === TestType.JavaScript || test.type === TestType.TypeScript) {
+                    dependencies = await this.collectImports(test.path, importCache)
+                }
+                graph.add(test.path, test.path)
+                for (const dependency of dependencies) {
+                    graph.add(dependency, test.path)
+                }
+            })
+        )
+        return graph
+    }
+
+    /*
+     Gets the tests affected by a set of changed files
+     @param changed Absolute paths of changed files
+     @param tests Discovered test files
+     @returns Paths of affected tests
+     */
+    affected(changed: string[], tests: TestFile[]): Set<string> {
+        const result = new Set<string>()
+        for (const path of changed) {
+            // A new test file is not in the graph yet but affects itself
+            result.add(path)
+            for (const test of this.dependents.get(path) || []) {
+                result.add(test)
+            }
+            // Config changes affect every test at or below the config directory
+            if (/testme\.json5$/.test(path)) {
+                const dir = dirname(path) + sep
+                for (const test of tests) {
+                    if (test.path.startsWith(dir)) {
+                        result.add(test.path)
+                    }
+                }
+            }
+        }
+        return result
+    }
+
+    /*
+     Gets the files tests depend on
+     @returns Absolute paths of all dependencies, including the tests themselves
+     */
+    files(): string[] {
+        return [...this.dependents.keys()]
+    }
+
+    /*
+     Records that a test depends on a file
+     @param file Dependency path
+     @param test Test path
+     */
+    private add(file: string, test: string): void {
+        let set = this.dependents.get(file)
+        if (!set) {
+            set = new Set()
+            this.dependents.set(file, set)
+        }
+        set.add(test)
+    }
+
+    /*
+     Reads the header dependencies recorded by the last successful compiles of a C test
+     Plain and instrumented (--sanitize, --coverage) builds keep separate records, so all are read.
+     A test batched into a unity driver is compiled through the driver, whose record lists the test itself.
+     @param test C test file
+     @returns Absolute header paths, or empty if the test has not been compiled
+     */
+    private static async readCompileDependencies(test: TestFile): Promise<string[]> {
+        const dependencies = await this.readDependencyRecords(test.artifactDir)
+        const unity = await this.readDependencyRecords(UnityTestHandler.getArtifactDir(test.directory))
+        if (unity.includes(resolve(test.path))) {
+            dependencies.push(...unity)
+        }
+        return dependencies
+    }
+
+    /*
+     Reads the dependency records of every build variant in an artifact directory
+     @param dir Artifact directory
+     @returns Recorded dependency paths, or empty if there are none
+     */
+    private static async readDependencyRecords(dir: string): Promise<string[]> {
+        let names: string[]
+        try {
+            names = (await readdir(dir)).filter((name) => CTestHandler.isDepsRecord(name))
+        } catch {
+            return []
+        }
+        const dependencies: string[] = []
+        for (const name of names) {
+            try {
+                const record = await Bun.file(join(dir, name)).json()
+                if (Array.isArray(record.dependencies)) {
+                    dependencies.push(...record.dependencies)
+                }
+            } catch {
+                // Torn or foreign record
+            }
+        }
+        return dependencies
+    }
+
+    /*
+     Collects the transitive relative imports of a JS/TS module
+     Bare module specifiers (packages) are not followed.
+     @param path Module path
+     @param cache Imports already resolved per module
+     @returns Absolute paths of all transitively imported local modules
+     */
+    private static async collectImports(path: string, cache: Map<string, Promise<string[]>>): Promise<string[]> {
+        const seen = new Set<string>([path])
+        const stack = [path]
+        while (stack.length > 0) {
+            const current = stack.pop()!
+            for (const dependency of await this.readImports(current, cache)) {
+                if (!seen.has(dependency)) {
+                    seen.add(dependency)
+                    stack.push(dependency)
+                }
+            }
+        }
+        seen.delete(path)
+        return [...seen]
+    }
+
+    /*
+     Reads the direct relative imports of a module
+     @param path Module path
+     @param cache Imports already resolved per module
+     @returns Absolute paths of directly imported local modules
+     */
+    private static readImports(path: string, cache: Map<string, Promise<string[]>>): Promise<string[]> {
+        let imports = cache.get(path)
+        if (!imports) {
+            imports = this.parseImports(path)
+            cache.set(path, imports)
+        }
+        return imports
+    }
+
+    /*
+     Parses and resolves the relative imports in a module's source
+     @param path Module path
+     @returns Absolute paths of directly imported local modules
+     */
+    private static async parseImports(path: string): Promise<string[]> {
+        const imports: string[] = []
+        let source: string
+        try {
+            source = await Bun.file(path).text()
+        } catch {
+            return imports
+        }
+        for (const match of source.matchAll(IMPORT_PATTERN)) {
+            const resolved = await this.resolveImport(dirname(path), match[1]!)
+            if (resolved) {
+                imports.push(resolved)
+            }
+        }
+        return imports
+    }
+
+    /*
+     Resolves a relative import specifier to a file
+     @param dir Directory of the importing module
+     @param specifier Relative specifier
+     @returns Absolute file path, or null if no candidate exists
+     */
+    private static async resolveImport(dir: string, specifier: string): Promise<string | null> {
+        const base = resolve(dir, specifier)
+        for (const extension of IMPORT_EXTENSIONS) {
+            const candidate = base + extension
+            try {
+                if ((await stat(candidate)).isFile()) {
+                    return candidate
+                }
+            } catch {
+                // Try the next candidate
+            }
+        }
+        return null
+    }
+}
@@ -0,0 +1,27 @@
+/*
+    Test that a test within execution.maxRss and execution.maxCpu passes
+ */
+#include "testme.h"
+
+#define SIZE (16 * 1024 * 1024)
+
+int main(int argc, char **argv) {
+    char    *buf;
+    size_t  i;
+    long    sum;
+
+    /*
+        Touch 16MB so it counts toward the peak resident memory
+     */
+    buf = malloc(SIZE);
+    ttrue(buf != NULL, "Allocated buffer");
+    memset(buf, 1, SIZE);
+
+    sum = 0;
+    for (i = 0; i < SIZE; i += 4096) {
+        sum += buf[i];
+    }
+    teq(sum, SIZE / 4096, "Read every page");
+    free(buf);
+    return 0;
+}
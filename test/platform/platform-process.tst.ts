@@ -237,6 +237,45 @@ async function testProcessKilling(): Promise<TestResult[]> {
     return results
 }
 
+async function testProcessTreeKilling(): Promise<TestResult[]> {
+    const results: TestResult[] = []
+    if (PlatformDetector.isWindows()) {
+        return results // taskkill /T is covered by killProcess
+    }
+
+    // Shell that starts a child and reports its PID
+    const proc = ProcessManager.spawn('sh', ['-c', 'sleep 30 & echo $!; wait'])
+    const reader = proc.stdout.getReader()
+    const {value} = await reader.read()
+    reader.releaseLock()
+    const child = parseInt(new TextDecoder().decode(value), 10)
+
+    try {
+        await ProcessManager.killProcessTree(proc.pid)
+        await proc.exited
+        await new Promise((resolve) => setTimeout(resolve, 500))
+
+        results.push({
+            name: 'Process tree root is killed',
+            passed: !(await ProcessManager.isProcessRunning(proc.pid)),
+            message: `PID ${proc.pid}`,
+        })
+        results.push({
+            name: 'Process tree children are killed',
+            passed: child > 0 && !(await ProcessManager.isProcessRunning(child)),
+            message: `Child PID ${child}`,
+        })
+    } catch (error) {
+        results.push({
+            name: 'Process tree is killed',
+            passed: false,
+            message: `Error: ${error}`,
+        })
+    }
+
+    return results
+}
+
 async function runTests(): Promise<void> {
     console.log('Running process manager tests...\n')
 
@@ -250,6 +289,7 @@ async function runTests(): Promise<void> {
             {name: 'Process Working Directory', tests: testProcessWorkingDirectory},
             {name: 'Process Check', tests: testProcessCheck},
             {name: 'Process Killing', tests: testProcessKilling},
+            {name: 'Process Tree Killing', tests: testProcessTreeKilling},
         ]
 
         let totalPassed = 0
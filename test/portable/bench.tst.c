@@ -0,0 +1,32 @@
+/*
+    Test the benchmark API
+ */
+#include "testme.h"
+
+static void increment(void *arg) {
+    long long   *value;
+
+    value = (long long*) arg;
+    *value += 1;
+    tDoNotOptimize(*value);
+}
+
+int main(int argc, char **argv) {
+    double      ns;
+    long long   sum, value;
+
+    //  Block form
+    sum = 0;
+    tbench("block add") {
+        sum += 3;
+        tDoNotOptimize(sum);
+    }
+    tgtll(sum, 0LL, "Benchmark block should have run");
+
+    //  Function form
+    value = 0;
+    ns = tBenchmark("function increment", increment, &value);
+    ttrue(ns > 0, "Benchmark should report a positive ns/op");
+    tgtll(value, 0LL, "Benchmark function should have run");
+    return 0;
+}
@@ -0,0 +1,100 @@
+import {CTestHandler} from '../../src/handlers/c.ts'
+import {CompilerManager, CompilerType} from '../../src/platform/compiler.ts'
+import type {CompilerConfig} from '../../src/platform/compiler.ts'
+import {TestType, type TestConfig, type TestFile} from '../../src/types.ts'
+import {teq} from 'testme'
+import {copyFile, mkdir, mkdtemp, rm, writeFile} from 'node:fs/promises'
+import {join} from 'path'
+import {tmpdir} from 'os'
+
+console.log('Testing compile cache keys across checkouts...')
+
+// Private steps of CTestHandler.compile() that produce the cache key
+type CacheSteps = {
+    getBinaryPath(file: TestFile, config: TestConfig): string
+    buildCompileArgs(
+        file: TestFile,
+        config: TestConfig,
+        compilerConfig: CompilerConfig,
+        binaryPath: string
+    ): Promise<{args: string[]; preprocessArgs: string[]}>
+    preprocess(
+        file: TestFile,
+        compilerConfig: CompilerConfig,
+        preprocessArgs: string[],
+        baseDir: string
+    ): Promise<{source: string} | null>
+    getCacheKey(
+        file: TestFile,
+        config: TestConfig,
+        compilerConfig: CompilerConfig,
+        args: string[],
+        source: string
+    ): Promise<string>
+}
+
+const SOURCE = `#include "testme.h"
+int main(void) {
+    teqi(1 + 1, 2, "Addition");
+    return 0;
+}
+`
+
+const compilerConfig = await CompilerManager.getDefaultCompilerConfig()
+if (compilerConfig.type !== CompilerType.GCC && compilerConfig.type !== CompilerType.Clang) {
+    console.log('✓ Skipped (requires GCC or Clang)')
+    process.exit(0)
+}
+const handler = new CTestHandler() as unknown as CacheSteps
+const roots: string[] = []
+
+// Compute the cache key of the same test in a checkout and return it with the preprocessed source
+// The checkout is a repository with the config in a subproject and shared headers beside it
+async function checkoutKey(): Promise<{key: string; source: string; root: string}> {
+    const root = await mkdtemp(join(tmpdir(), 'testme-checkout-'))
+    roots.push(root)
+    const project = join(root, 'project')
+    const directory = join(project, 'test')
+    await mkdir(join(root, '.git'), {recursive: true})
+    await mkdir(join(root, 'shared', 'include'), {recursive: true})
+    await mkdir(directory, {recursive: true})
+    await writeFile(join(directory, 'math.tst.c'), SOURCE)
+    await copyFile(join(import.meta.dir, '..', 'testme.h'), join(directory, 'testme.h'))
+    const file: TestFile = {
+        path: join(directory, 'math.tst.c'),
+        name: 'math.tst.c',
+        extension: '.c',
+        type: TestType.C,
+        directory,
+        artifactDir: join(directory, '.testme', 'math'),
+    }
+    await mkdir(file.artifactDir, {recursive: true})
+    const config = {
+        configDir: project,
+        compiler: {c: {cache: {enable: true}, flags: ['-I${CONFIGDIR}/include', `-I${root}/shared/include`]}},
+    } as TestConfig
+    const binaryPath = handler.getBinaryPath(file, config)
+    const {args, preprocessArgs} = await handler.buildCompileArgs(file, config, compilerConfig, binaryPath)
+    teq(args.includes(`-I${root}/shared/include`), true, 'Repository include outside the config directory')
+    const preprocessed = await handler.preprocess(file, compilerConfig, preprocessArgs, project)
+    teq(preprocessed !== null, true, 'Test should preprocess')
+    const key = await handler.getCacheKey(file, config, compilerConfig, args, preprocessed!.source)
+    return {key, source: preprocessed!.source, root}
+}
+
+const first = await checkoutKey()
+const second = await checkoutKey()
+
+// Test 1: __FILE__ in assertions is relative to the config directory
+teq(first.source.includes(first.root), false, 'Preprocessed source should not contain the checkout path')
+teq(first.source.includes('"./test/math.tst.c"'), true, '__FILE__ should be relative to the config directory')
+console.log('✓ Preprocessed source is independent of the checkout path')
+
+// Test 2: Two checkouts at different paths share one key, including paths outside the config directory
+teq(first.key, second.key, 'Checkouts at different paths should produce the same cache key')
+console.log('✓ Cache key is shared across checkouts')
+
+for (const root of roots) {
+    await rm(root, {recursive: true, force: true})
+}
+console.log('\nAll tests completed successfully!')
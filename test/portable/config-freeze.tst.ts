@@ -0,0 +1,42 @@
+import {TestRunner} from '../../src/runner.ts'
+import {ConfigManager} from '../../src/config.ts'
+import type {TestConfig} from '../../src/types.ts'
+import {teq} from 'testme'
+import {mkdtemp, rm, writeFile} from 'node:fs/promises'
+import {join} from 'path'
+import {tmpdir} from 'os'
+
+console.log('Testing resolved test configs...')
+
+type Steps = {
+    resolveTestConfig(directory: string, globalConfig: TestConfig): Promise<TestConfig>
+}
+
+const dir = await mkdtemp(join(tmpdir(), 'testme-config-freeze-test-'))
+await writeFile(join(dir, 'testme.json5'), "{compiler: {c: {flags: ['-DTEST'], gcc: {flags: ['-O2']}}}}\n")
+ConfigManager.clearCache()
+
+const runner = new TestRunner() as unknown as Steps
+const global = ConfigManager.getDefaultConfig()
+const config = await runner.resolveTestConfig(dir, global)
+
+// Test 1: The resolved config and its sections are frozen
+teq(Object.isFrozen(config), true, 'Config is frozen')
+teq(Object.isFrozen(config.execution), true, 'Execution is frozen')
+teq(Object.isFrozen(config.compiler), true, 'Compiler is frozen')
+console.log('✓ Frozen sections')
+
+// Test 2: Compiler settings, which key the C handler's flag cache, are frozen deeply
+const c = config.compiler!.c!
+teq(Object.isFrozen(c) && Object.isFrozen(c.flags) && Object.isFrozen(c.gcc), true, 'compiler.c is frozen deeply')
+let threw = false
+try {
+    c.flags!.push('-DLATER')
+} catch {
+    threw = true
+}
+teq(threw && c.flags!.join(' ') === '-DTEST', true, 'Compiler flags cannot change')
+console.log('✓ Frozen compiler settings')
+
+await rm(dir, {recursive: true, force: true})
+console.log('\nAll tests completed successfully!')
@@ -0,0 +1,89 @@
+import {CTestHandler} from '../../src/handlers/c.ts'
+import {CompilerManager, CompilerType} from '../../src/platform/compiler.ts'
+import type {CompilerConfig} from '../../src/platform/compiler.ts'
+import {teq} from 'testme'
+import {existsSync} from 'node:fs'
+import {mkdir, mkdtemp, readFile, rm, writeFile} from 'node:fs/promises'
+import {join, resolve} from 'path'
+import {tmpdir} from 'os'
+
+console.log('Testing C dependency tracking...')
+
+// Private steps of CTestHandler that record and validate header dependencies
+type DependencySteps = {
+    parseDepfile(content: string): string[]
+    extractShowIncludes(stdout: string): {stdout: string; includes: string[]}
+    hashCompileCommand(compilerConfig: CompilerConfig, args: string[]): string
+}
+
+const handler = new CTestHandler() as unknown as DependencySteps
+
+// Test 1: Continuation lines are joined and the target is excluded
+let deps = handler.parseDepfile('build/math.o: math.tst.c \\\n  testme.h \\\r\n  include/lib.h\n')
+teq(deps.join(','), 'math.tst.c,testme.h,include/lib.h', 'Continuation lines (LF and CRLF)')
+deps = handler.parseDepfile('C:/build/math.o: C:\\src\\math.tst.c C:\\src\\lib.h\n')
+teq(deps.join(','), 'C:\\src\\math.tst.c,C:\\src\\lib.h', 'Drive letters are not separators')
+deps = handler.parseDepfile('math.o: math.tst.c lib.h\nlib.h:\n')
+teq(deps.join(','), 'math.tst.c,lib.h', 'Phony targets (-MP) add no dependencies')
+teq(handler.parseDepfile('').length, 0, 'Empty depfile')
+console.log('✓ Depfile lines')
+
+// Test 2: Escaped spaces, hashes and dollars
+deps = handler.parseDepfile('t.o: t.c my\\ dir/a\\ b.h my\\ dir/c\\#d.h my\\ dir/e$$f.h\n')
+teq(deps.join(','), 't.c,my dir/a b.h,my dir/c#d.h,my dir/e$f.h', 'Escaped paths')
+console.log('✓ Escaped depfile paths')
+
+// Test 3: A depfile written by the compiler names the included headers
+const compilerConfig = await CompilerManager.getDefaultCompilerConfig()
+if (compilerConfig.type === CompilerType.GCC || compilerConfig.type === CompilerType.Clang) {
+    const dir = await mkdtemp(join(tmpdir(), 'testme-depfile-test-'))
+    const headers = ['my dir/a b.h', 'my dir/c#d.h', 'my dir/e$f.h']
+    await mkdir(join(dir, 'my dir'))
+    for (const header of headers) {
+        await writeFile(join(dir, header), '')
+    }
+    const includes = headers.map((header) => `#include "${header}"\n`).join('')
+    await writeFile(join(dir, 't.c'), includes + 'int main(void) { return 0; }\n')
+    const proc = Bun.spawn([compilerConfig.compiler, '-MMD', '-MF', 't.d', '-c', 't.c', '-o', 't.o'], {
+        cwd: dir,
+        stdout: 'pipe',
+        stderr: 'pipe',
+    })
+    teq(await proc.exited, 0, 'Source with escaped header names should compile')
+    deps = handler.parseDepfile(await readFile(join(dir, 't.d'), 'utf8')).map((dep) => resolve(dir, dep))
+    teq(deps.length, 4, 'Source and headers')
+    teq(deps.every((dep) => existsSync(dep)), true, 'Every parsed dependency should exist')
+    await rm(dir, {recursive: true, force: true})
+    console.log('✓ Compiler depfile')
+} else {
+    console.log('✓ Compiler depfile skipped (requires GCC or Clang)')
+}
+
+// Test 4: MSVC /showIncludes notes are removed from the output and returned as includes
+const shown = handler.extractShowIncludes(
+    [
+        'math.tst.c',
+        'Note: including file: C:\\src\\testme.h',
+        'Note: including file:  C:\\Program Files\\Windows Kits\\include\\stdio.h ',
+        'math.tst.c(12): warning C4100: unused parameter',
+    ].join('\r\n')
+)
+teq(shown.includes.length, 2, 'Include notes')
+teq(shown.includes[0], 'C:\\src\\testme.h', 'Include path')
+teq(shown.includes[1], 'C:\\Program Files\\Windows Kits\\include\\stdio.h', 'Nested include with spaces, trimmed')
+teq(shown.stdout, 'math.tst.c\nmath.tst.c(12): warning C4100: unused parameter', 'Other output is kept')
+console.log('✓ extractShowIncludes')
+
+// Test 5: The compile command hash changes with the compiler, arguments and MSVC environment
+const gcc: CompilerConfig = {compiler: 'gcc', type: CompilerType.GCC, flags: []}
+const hash = handler.hashCompileCommand(gcc, ['-O2', '-o', 'math'])
+teq(handler.hashCompileCommand(gcc, ['-O2', '-o', 'math']), hash, 'Same command, same hash')
+teq(handler.hashCompileCommand(gcc, ['-O0', '-o', 'math']) !== hash, true, 'Flags change the hash')
+teq(handler.hashCompileCommand({...gcc, compiler: 'gcc-13'}, ['-O2', '-o', 'math']) !== hash, true, 'Compiler path')
+teq(handler.hashCompileCommand(gcc, ['-O2', '-o math']) !== hash, true, 'Argument boundaries are part of the hash')
+const msvc: CompilerConfig = {compiler: 'cl.exe', type: CompilerType.MSVC, flags: [], env: {INCLUDE: 'C:\\a'}}
+const otherInclude = handler.hashCompileCommand({...msvc, env: {INCLUDE: 'C:\\b'}}, ['/O2'])
+teq(handler.hashCompileCommand(msvc, ['/O2']) !== otherInclude, true, 'MSVC INCLUDE changes the hash')
+console.log('✓ hashCompileCommand')
+
+console.log('\nAll tests completed successfully!')
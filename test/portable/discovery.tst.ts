@@ -0,0 +1,95 @@
+import {TestDiscovery} from '../../src/discovery.ts'
+import {teq} from 'testme'
+import {existsSync} from 'node:fs'
+import {mkdir, mkdtemp, readFile, rm, utimes, writeFile} from 'node:fs/promises'
+import {join, relative} from 'path'
+import {tmpdir} from 'os'
+
+console.log('Testing test discovery...')
+
+// Private glob matchers of TestDiscovery
+type GlobSteps = {
+    matchesGlob(text: string, pattern: string): boolean
+    compileGlob(pattern: string): unknown
+}
+
+const globs = TestDiscovery as unknown as GlobSteps
+
+// Test 1: Compiled globs match per path segment
+teq(globs.matchesGlob('math.tst.c', '**/*.tst.c'), true, '** matches zero segments')
+teq(globs.matchesGlob('a/b/c/math.tst.c', '**/*.tst.c'), true, '** matches several segments')
+teq(globs.matchesGlob('a/math.tst.c', '*.tst.c'), false, '* does not cross segments')
+teq(globs.matchesGlob('unit/a/math.tst.c', 'unit/**/math.tst.c'), true, '** in the middle')
+teq(globs.matchesGlob('test1.tst.c', 'test?.tst.c'), true, '? matches one character')
+teq(globs.matchesGlob('test12.tst.c', 'test?.tst.c'), false, '? matches only one character')
+teq(globs.matchesGlob('MATH.TST.C', '*.tst.c'), true, 'Matching ignores case')
+teq(globs.matchesGlob('a+b(1).tst.c', 'a+b(1).*'), true, 'Regex characters are literal')
+teq(globs.matchesGlob('aab(1).tst.c', 'a+b(1).*'), false, '+ is not a regex quantifier')
+teq(globs.compileGlob('**/*.tst.c') === globs.compileGlob('**/*.tst.c'), true, 'Patterns are compiled once')
+console.log('✓ Compiled globs')
+
+const root = await mkdtemp(join(tmpdir(), 'testme-discovery-test-'))
+const past = new Date(Date.now() - 60_000)
+
+// Create files, then date the directories back so the index accepts them
+async function create(files: string[]): Promise<void> {
+    for (const file of files) {
+        await mkdir(join(root, file, '..'), {recursive: true})
+        await writeFile(join(root, file), '')
+    }
+}
+async function age(dirs: string[]): Promise<void> {
+    for (const dir of dirs) {
+        await utimes(join(root, dir), past, past)
+    }
+}
+async function discover(index = true, patterns = ['**/*.tst.c', '**/*.tst.sh']): Promise<string[]> {
+    const tests = await TestDiscovery.discoverTests({rootDir: root, patterns, excludePatterns: ['**/skip/**'], index})
+    return tests.map((test) => relative(root, test.path).replace(/\\/g, '/'))
+}
+
+await create(['a.tst.c', 'notes.txt', 'unit/b.tst.c', 'unit/deep/c.tst.sh', 'skip/d.tst.c', 'node_modules/e.tst.c'])
+await age(['', 'unit', 'unit/deep', 'skip', 'node_modules'])
+
+// Test 2: Discovery order, exclusions and the index are independent of each other
+const plain = await discover(false)
+teq(plain.join(','), 'a.tst.c,unit/b.tst.c,unit/deep/c.tst.sh', 'Depth-first order with exclusions')
+teq(existsSync(join(root, '.testme', 'discovery.json')), false, 'No index unless enabled')
+teq((await discover()).join(','), plain.join(','), 'Indexed discovery finds the same tests')
+const index = JSON.parse(await readFile(join(root, '.testme', 'discovery.json'), 'utf8'))
+teq(Object.keys(index.dirs).sort().join(','), ',skip,unit,unit/deep', 'Searched directories are indexed')
+console.log('✓ Index is written')
+
+// Test 3: An unchanged directory is not read again
+index.dirs['unit'].files.push('indexed.tst.c')
+await writeFile(join(root, '.testme', 'discovery.json'), JSON.stringify(index))
+teq((await discover()).includes('unit/indexed.tst.c'), true, 'Unchanged directory uses its indexed scan')
+console.log('✓ Unchanged directories are reused')
+
+// Test 4: A directory whose mtime changed is stale and read again, even when its parent is unchanged
+await create(['unit/deep/f.tst.c'])
+let found = await discover()
+teq(found.includes('unit/deep/f.tst.c'), true, 'New file in a nested directory is found')
+teq(found.includes('unit/indexed.tst.c'), true, 'Unchanged parent keeps its indexed scan')
+await utimes(join(root, 'unit'), new Date(past.getTime() - 1000), new Date(past.getTime() - 1000))
+found = await discover()
+teq(found.includes('unit/indexed.tst.c'), false, 'Directory with a new mtime is read again')
+teq(found.join(','), 'a.tst.c,unit/b.tst.c,unit/deep/c.tst.sh,unit/deep/f.tst.c', 'Stale entries are replaced')
+console.log('✓ Stale directories are read again')
+
+// Test 5: Recently modified directories are not indexed, so a change in the same instant is never missed
+const recent = JSON.parse(await readFile(join(root, '.testme', 'discovery.json'), 'utf8'))
+teq('unit/deep' in recent.dirs, false, 'Just modified directory is not indexed')
+teq('unit' in recent.dirs, true, 'Settled directory is indexed')
+console.log('✓ Recently modified directories are not indexed')
+
+// Test 6: An index built with other patterns is ignored
+recent.dirs['unit'].files.push('other.tst.c')
+await writeFile(join(root, '.testme', 'discovery.json'), JSON.stringify(recent))
+found = await discover(true, ['**/*.tst.c'])
+teq(found.includes('unit/other.tst.c'), false, 'Index of other patterns is not used')
+teq(found.join(','), 'a.tst.c,unit/b.tst.c,unit/deep/f.tst.c', 'Only the new patterns apply')
+console.log('✓ Index is keyed by the patterns')
+
+await rm(root, {recursive: true, force: true})
+console.log('\nAll tests completed successfully!')
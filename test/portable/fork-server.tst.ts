@@ -0,0 +1,156 @@
+import {ForkServer} from '../../src/utils/fork-server.ts'
+import {CompilerManager, CompilerType} from '../../src/platform/compiler.ts'
+import {teq} from 'testme'
+import {chmod, copyFile, mkdtemp, rm, writeFile} from 'node:fs/promises'
+import {join} from 'path'
+import {tmpdir} from 'os'
+
+console.log('Testing fork-server framing...')
+
+if (process.platform === 'win32') {
+    console.log('✓ Skipped (fork-server mode is POSIX only)')
+    process.exit(0)
+}
+
+const dir = await mkdtemp(join(tmpdir(), 'testme-fork-test-'))
+
+// Write an executable shell script standing in for a test binary
+async function script(name: string, body: string): Promise<string> {
+    const path = join(dir, name)
+    await writeFile(path, `#!/bin/sh\n${body}`)
+    await chmod(path, 0o755)
+    return path
+}
+
+function server(command: string, runs: number, timeout = 10000): ForkServer {
+    return new ForkServer(command, {cwd: dir, env: {}, timeout, runs})
+}
+
+// Test 1: Runs are split at status lines written in several chunks, across both streams
+const chunked = await script(
+    'chunked.sh',
+    `n=0
+while read command; do
+    [ "$command" = run ] || break
+    n=$((n + 1))
+    printf 'out %s\\nTESTME_FO' $n
+    sleep 0.05
+    printf 'RK_EXIT 0\\n'
+    printf 'err %s' $n >&2
+    sleep 0.05
+    printf '\\n\\nTESTME_FORK_EXIT 0\\n' >&2
+done
+`
+)
+const split = server(chunked, 3)
+for (let run = 1; run <= 3; run++) {
+    const result = await split.run()
+    teq(result.exitCode, 0, `Run ${run} exit code`)
+    teq(result.stdout, `out ${run}`, `Run ${run} stdout without the status line`)
+    teq(result.stderr, `err ${run}\n`, `Run ${run} stderr without the status line`)
+}
+teq(split.closed, true, 'Server is closed after the last requested run')
+console.log('✓ Status lines split across chunks')
+
+// Test 2: Output of several runs arriving in one chunk is split per run
+const batched = await script(
+    'batched.sh',
+    `read command
+printf 'one\\nTESTME_FORK_EXIT 0\\ntwo\\nTESTME_FORK_EXIT 0\\n'
+printf 'TESTME_FORK_EXIT 0\\nTESTME_FORK_EXIT 0\\n' >&2
+read command
+`
+)
+const merged = server(batched, 2)
+const first = await merged.run()
+const second = await merged.run()
+teq(first.stdout, 'one', 'First run of a shared chunk')
+teq(second.stdout, 'two', 'Second run of a shared chunk')
+teq(first.stderr + second.stderr, '', 'Empty stderr per run')
+console.log('✓ Several runs in one chunk')
+
+// Test 3: A failed run stops the server, as the runner stops repeating a failing test
+const failing = await script(
+    'failing.sh',
+    `read command
+printf 'boom\\nTESTME_FORK_EXIT 3\\n'
+printf 'TESTME_FORK_EXIT 3\\n' >&2
+read command
+`
+)
+const stopped = server(failing, 5)
+const failed = await stopped.run()
+teq(failed.exitCode, 3, 'Exit status of the child')
+teq(failed.stdout, 'boom', 'Failed run output')
+teq(stopped.closed, true, 'Server is closed after a failed run')
+console.log('✓ Failed run closes the server')
+
+// Test 4: A child killed by its alarm is reported as a timeout
+const alarmed = await script(
+    'alarm.sh',
+    `read command
+printf 'TESTME_FORK_EXIT 142\\n'
+printf 'TESTME_FORK_EXIT 142\\n' >&2
+`
+)
+const timedOut = await server(alarmed, 1, 2000).run()
+teq(timedOut.exitCode, -1, 'Timed out run')
+teq(timedOut.stderr.includes('timed out after 2s'), true, 'Timeout message')
+console.log('✓ Alarm status is a timeout')
+
+// Test 5: A binary without fork-server support runs once and is reported by its exit status
+const plain = await script('plain.sh', `echo hello\necho oops >&2\nexit 4\n`)
+const once = server(plain, 3)
+const direct = await once.run()
+teq(direct.exitCode, 4, 'Exit status of the process itself')
+teq(direct.stdout, 'hello\n', 'Output of the direct run')
+teq(direct.stderr, 'oops\n', 'Error output of the direct run')
+teq(once.closed, true, 'Server is closed so the caller falls back to spawning')
+console.log('✓ Binaries without fork-server support')
+
+// Test 6: A testme.h binary forks a fresh child per run from its checkpoint
+const compilerConfig = await CompilerManager.getDefaultCompilerConfig()
+if (compilerConfig.type === CompilerType.GCC || compilerConfig.type === CompilerType.Clang) {
+    await copyFile(join(import.meta.dir, '..', 'testme.h'), join(dir, 'testme.h'))
+    await writeFile(
+        join(dir, 'counter.tst.c'),
+        `#include "testme.h"
+
+static int runs = 0;
+
+int main(void)
+{
+    runs++;
+    printf("runs %d\\n", runs);
+    teqi(runs, 1, "Each run starts from the checkpoint");
+    tnull(getenv("TESTME_FORK_SERVER"), "Fork-server mode is not inherited");
+    teqi(WEXITSTATUS(system("./helper")), 7, "Programs run by the test run their own main()");
+    return 0;
+}
+`
+    )
+    //  A program built with testme.h that the test itself runs
+    await writeFile(join(dir, 'helper.c'), '#include "testme.h"\n\nint main(void)\n{\n    return 7;\n}\n')
+    for (const name of ['helper', 'counter']) {
+        const source = join(dir, name === 'helper' ? 'helper.c' : `${name}.tst.c`)
+        const compile = Bun.spawn([compilerConfig.compiler, `-I${dir}`, source, '-o', join(dir, name)], {
+            stdout: 'pipe',
+            stderr: 'pipe',
+        })
+        teq(await compile.exited, 0, `${name} should compile`)
+    }
+    const binary = join(dir, 'counter')
+    const forked = server(binary, 3)
+    for (let run = 1; run <= 3; run++) {
+        const result = await forked.run()
+        teq(result.exitCode, 0, `Forked run ${run} passed`)
+        teq(result.stdout.startsWith('runs 1\n'), true, `Forked run ${run} is isolated`)
+    }
+    teq(forked.closed, true, 'Server is closed after the last run')
+    console.log('✓ testme.h fork server')
+} else {
+    console.log('✓ testme.h fork server skipped (requires GCC or Clang)')
+}
+
+await rm(dir, {recursive: true, force: true})
+console.log('\nAll tests completed successfully!')
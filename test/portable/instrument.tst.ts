@@ -0,0 +1,63 @@
+import {CompilerManager, CompilerType} from '../../src/platform/compiler.ts'
+import {Coverage} from '../../src/utils/coverage.ts'
+import {teq} from 'testme'
+import {mkdtemp, readFile, rm} from 'node:fs/promises'
+import {join} from 'path'
+import {tmpdir} from 'os'
+
+console.log('Testing sanitizer and coverage build profiles...')
+
+// Test 1: Sanitizers are normalized and named as a build variant
+const instrumentation = CompilerManager.getInstrumentation(['undefined', 'Address', 'address'], true)!
+teq(instrumentation.sanitize.join(','), 'address,undefined', 'Sanitizers should be sorted without duplicates')
+teq(CompilerManager.getVariantName(instrumentation), 'asan-ubsan-cov', 'Variant name')
+teq(CompilerManager.getInstrumentation([], false), undefined, 'No instrumentation is a plain build')
+console.log('✓ Instrumentation variants')
+
+// Test 2: Unknown and conflicting sanitizers are rejected
+function rejects(sanitize: string[]): boolean {
+    try {
+        CompilerManager.getInstrumentation(sanitize)
+        return false
+    } catch {
+        return true
+    }
+}
+teq(rejects(['adress']), true, 'Unknown sanitizer should be rejected')
+teq(rejects(['address', 'thread']), true, 'ASan and TSan cannot be combined')
+console.log('✓ Invalid sanitizers are rejected')
+
+// Test 3: Flags follow the compiler type
+const gcc = CompilerManager.getInstrumentFlags(CompilerType.GCC, instrumentation)
+teq(gcc.includes('-fsanitize=address,undefined'), true, 'GCC sanitizer flag')
+teq(gcc.includes('--coverage'), true, 'GCC coverage flag')
+const clang = CompilerManager.getInstrumentFlags(CompilerType.Clang, instrumentation)
+teq(clang.includes('-fcoverage-mapping'), true, 'Clang source-based coverage')
+const asan = CompilerManager.getInstrumentation(['address'])!
+teq(CompilerManager.getInstrumentFlags(CompilerType.MSVC, asan).includes('/fsanitize=address'), true, 'MSVC ASan')
+let unsupported = false
+try {
+    CompilerManager.getInstrumentFlags(CompilerType.MSVC, instrumentation)
+} catch {
+    unsupported = true
+}
+teq(unsupported, true, 'MSVC should reject UBSan and coverage')
+console.log('✓ Compiler flags')
+
+// Test 4: Line counts from several tests are merged into one LCOV report
+const dir = await mkdtemp(join(tmpdir(), 'testme-coverage-test-'))
+const source = join(dir, 'src', 'math.c')
+Coverage.start(join(dir, 'lcov.info'), true)
+Coverage.addLcov(`TN:\nSF:${source}\nDA:1,2\nDA:2,0\nDA:3,0\nend_of_record\n`)
+Coverage.addLcov(`TN:\nSF:${source}\nDA:2,1\nDA:3,0\nend_of_record\n`)
+Coverage.add(join(dir, 'testme.h'), 10, 1)
+const summary = await Coverage.finish()
+teq(summary?.files, 1, 'testme.h should not be reported')
+teq(summary?.lines, 3, 'Instrumented lines')
+teq(summary?.covered, 2, 'Lines covered by either test')
+const report = await readFile(join(dir, 'lcov.info'), 'utf8')
+teq(report.includes('DA:1,2\nDA:2,1\nDA:3,0\nLF:3\nLH:2\n'), true, 'Counts should be summed per line')
+console.log('✓ Coverage is merged across tests')
+
+await rm(dir, {recursive: true, force: true})
+console.log('\nAll tests completed successfully!')
@@ -0,0 +1,60 @@
+import {Log} from '../../src/utils/log.ts'
+import {TestReporter} from '../../src/reporter.ts'
+import {TestStatus, TestType, type TestConfig, type TestResult} from '../../src/types.ts'
+import {teq} from 'testme'
+import {PassThrough} from 'node:stream'
+
+console.log('Testing runner output streams...')
+
+const consoleLog = console.log
+const config = {output: {format: 'json', colors: false}} as TestConfig
+const result: TestResult = {
+    file: {
+        path: '/src/math.tst.c',
+        name: 'math.tst.c',
+        extension: '.c',
+        type: TestType.C,
+        directory: '/src',
+        artifactDir: '/src/.testme/math',
+    },
+    status: TestStatus.Passed,
+    duration: 12,
+    output: '✓ Addition',
+}
+
+// Test 1: Runner messages go to stdout by default
+teq(Log.stream === process.stdout, true, 'Default stream is stdout')
+console.log('✓ Default stream')
+
+// Test 2: With JSON output, only the report is written to stdout
+const sink = new PassThrough()
+let messages = ''
+sink.on('data', (chunk) => (messages += chunk))
+Log.useStream(sink as unknown as NodeJS.WriteStream)
+
+let stdout = ''
+const write = process.stdout.write
+process.stdout.write = ((chunk: string) => {
+    stdout += chunk
+    return true
+}) as typeof process.stdout.write
+try {
+    const reporter = new TestReporter(config, '/src')
+    reporter.reportTestsStarting()
+    reporter.reportProgress(result)
+    reporter.reportResults([result], 20)
+} finally {
+    process.stdout.write = write
+    Log.useStream(process.stdout)
+}
+await new Promise((resolve) => setImmediate(resolve))
+
+const report = JSON.parse(stdout)
+teq(report.summary.passed, 1, 'Stdout holds the report alone')
+teq(report.tests[0].file, '/src/math.tst.c', 'Report entry')
+teq(messages.includes('Running tests...'), true, 'Progress messages use the selected stream')
+teq(messages.includes('math.tst.c'), true, 'Test results use the selected stream')
+teq(console.log === consoleLog, true, 'The global console is not replaced')
+console.log('✓ JSON output keeps stdout for the report')
+
+console.log('\nAll tests completed successfully!')
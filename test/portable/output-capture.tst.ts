@@ -0,0 +1,84 @@
+import {OutputCapture} from '../../src/utils/output-capture.ts'
+import {countAssertions} from '../../src/utils/assertion-counter.ts'
+import {teq} from 'testme'
+import {existsSync} from 'node:fs'
+import {mkdtemp, readFile, rm} from 'node:fs/promises'
+import {join} from 'path'
+import {tmpdir} from 'os'
+
+console.log('Testing bounded output capture...')
+
+const LIMIT = 4096
+const encoder = new TextEncoder()
+const dir = await mkdtemp(join(tmpdir(), 'testme-capture-test-'))
+
+// Feed a stream to a capture in chunks of the given size (splitting multi-byte characters)
+async function capture(text: string, chunkSize: number, logPath?: string) {
+    const output = new OutputCapture(LIMIT, logPath)
+    const bytes = encoder.encode(text)
+    let decoded = ''
+    for (let offset = 0; offset < bytes.length; offset += chunkSize) {
+        decoded += await output.write(bytes.subarray(offset, offset + chunkSize))
+    }
+    return {captured: await output.finish(), decoded}
+}
+
+// Test 1: Output within the limit is kept whole and no log file is written
+const small = '✓ One\n✓ Two\n✗ Three\n'
+const whole = await capture(small, 5, join(dir, 'small.log'))
+teq(whole.captured, small, 'Small output is kept whole')
+teq(whole.decoded, small, 'Chunks split inside characters decode to the original text')
+teq(existsSync(join(dir, 'small.log')), false, 'No log file below the limit')
+console.log('✓ Output within the limit')
+
+// Build a stream several times the limit with assertions and protocol lines throughout
+const lines: string[] = ['HEAD MARKER']
+for (let i = 0; i < 600; i++) {
+    lines.push(`✓ Assertion ${i} passed at math.tst.c@${i}`)
+    if (i % 100 === 50) {
+        lines.push(`✗ Assertion ${i} failed`)
+        lines.push(`TESTME_BENCH {"name":"bench${i}","ops":${i}}`)
+    }
+}
+lines.push('TAIL MARKER', '')
+const large = lines.join('\n')
+const expected = countAssertions(large)!
+
+// Test 2: Oversized output keeps the head and tail and summarizes the omitted middle
+const logPath = join(dir, 'large.log')
+const {captured, decoded} = await capture(large, 1000, logPath)
+teq(decoded, large, 'Every chunk is returned decoded')
+teq(captured.length < large.length, true, 'Captured output is bounded')
+teq(captured.length < LIMIT * 3, true, 'Captured output is close to the limit')
+teq(captured.startsWith('HEAD MARKER\n'), true, 'Head is kept')
+teq(captured.endsWith('TAIL MARKER\n'), true, 'Tail is kept')
+teq(captured.includes(`bytes omitted (full output in ${logPath})`), true, 'Omission notice names the log')
+console.log('✓ Head and tail are kept')
+
+// Test 3: TESTME_OMITTED counts the evicted assertions so the totals match the whole stream
+teq(captured.includes('TESTME_OMITTED passed='), true, 'Omitted assertions are summarized')
+const counted = countAssertions(captured)!
+teq(counted.passed, expected.passed, 'Passed assertions of the whole stream')
+teq(counted.failed, expected.failed, 'Failed assertions of the whole stream')
+console.log('✓ TESTME_OMITTED counting')
+
+// Test 4: Protocol lines from the omitted middle are kept
+for (const line of lines.filter((line) => line.startsWith('TESTME_BENCH'))) {
+    teq(captured.includes(line), true, `Protocol line kept: ${line}`)
+}
+console.log('✓ Protocol lines are kept')
+
+// Test 5: The log file holds the complete stream
+teq(await readFile(logPath, 'utf8'), large, 'Log file has the complete output')
+console.log('✓ Complete output is logged')
+
+// Test 6: Counting stays exact with one-byte chunks and without a log file
+const unlogged = await capture(large, 1)
+teq(unlogged.captured.includes('(full output not saved)'), true, 'Notice without a log file')
+const bytewise = countAssertions(unlogged.captured)!
+teq(bytewise.passed, expected.passed, 'Passed assertions with one-byte chunks')
+teq(bytewise.failed, expected.failed, 'Failed assertions with one-byte chunks')
+console.log('✓ One-byte chunks')
+
+await rm(dir, {recursive: true, force: true})
+console.log('\nAll tests completed successfully!')
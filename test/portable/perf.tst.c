@@ -0,0 +1,39 @@
+/*
+    Test the performance counter region API
+ */
+#include "testme.h"
+
+int main(int argc, char **argv) {
+    long long   sum;
+    int         i;
+
+    //  Nested regions (counters are recorded only where perf_event_open is available)
+    sum = 0;
+    tPerfBegin("outer loop");
+    for (i = 0; i < 100000; i++) {
+        sum += i;
+        tDoNotOptimize(sum);
+    }
+    tPerfBegin("inner loop");
+    for (i = 0; i < 1000; i++) {
+        sum += i;
+        tDoNotOptimize(sum);
+    }
+    tPerfEnd();
+    tPerfEnd();
+    tgtll(sum, 0LL, "Regions should have run");
+    teqi(tPerfState()->depth, 0, "Regions should be balanced");
+
+    //  An unbalanced end is ignored
+    tPerfEnd();
+    teqi(tPerfState()->depth, 0, "Unbalanced tPerfEnd is ignored");
+
+    //  Repeated regions are combined by the runner
+    for (i = 0; i < 3; i++) {
+        tPerfBegin("repeated");
+        sum += i;
+        tDoNotOptimize(sum);
+        tPerfEnd();
+    }
+    return 0;
+}
@@ -0,0 +1,29 @@
+/*
+    Test quiet-pass mode where passing assertions are counted without output
+ */
+#ifndef _WIN32
+    #define _POSIX_C_SOURCE 200112L
+#endif
+#include "testme.h"
+
+int main(int argc, char **argv) {
+    long    i;
+
+    //  Enable quiet-pass mode before the first assertion caches the setting
+#if _WIN32
+    _putenv_s("TESTME_QUIET_PASS", "1");
+#else
+    setenv("TESTME_QUIET_PASS", "1", 1);
+#endif
+    ttrue(tQuietPass(), "Quiet-pass mode should be enabled");
+
+    //  Passing assertions only increment the counter
+    for (i = 0; i < 100000; i++) {
+        teqi((int) (i % 10), (int) (i % 10));
+        tlti((int) (i % 10), 10);
+        ttrue(i >= 0);
+    }
+    tmatch("quiet", "quiet");
+    teql(tmPassCount, 300002L, "Pass count should include all quiet assertions");
+    return 0;
+}
@@ -0,0 +1,50 @@
+import {discardTree, removeTree, settleBackground, TRASH_PREFIX} from '../../src/utils/remove.ts'
+import {teq} from 'testme'
+import {existsSync} from 'node:fs'
+import {mkdir, mkdtemp, readdir, writeFile} from 'node:fs/promises'
+import {join} from 'path'
+import {tmpdir} from 'os'
+
+console.log('Testing bounded parallel removal...')
+
+// Create a tree wider than the removal fan-out
+async function makeTree(dir: string, depth: number): Promise<void> {
+    await mkdir(dir, {recursive: true})
+    for (let i = 0; i < 40; i++) {
+        await writeFile(join(dir, `file${i}`), 'artifact')
+    }
+    if (depth > 0) {
+        for (let i = 0; i < 4; i++) {
+            await makeTree(join(dir, `dir${i}`), depth - 1)
+        }
+    }
+}
+
+const root = await mkdtemp(join(tmpdir(), 'testme-remove-test-'))
+
+// Test 1: Remove a directory tree
+await makeTree(join(root, 'tree'), 2)
+await removeTree(join(root, 'tree'))
+teq(existsSync(join(root, 'tree')), false, 'removeTree should remove the whole tree')
+console.log('✓ removeTree removes nested directories')
+
+// Test 2: A missing directory is not an error
+await removeTree(join(root, 'missing'))
+console.log('✓ removeTree ignores missing directories')
+
+// Test 3: Discard renames the directory aside and removes it in the background
+const testme = join(root, '.testme')
+await makeTree(join(testme, 'math'), 1)
+let removed = false
+await discardTree(join(testme, 'math'), async () => {
+    removed = true
+})
+teq(existsSync(join(testme, 'math')), false, 'discardTree should free the path before returning')
+await settleBackground()
+teq(removed, true, 'discardTree should call back after the background removal')
+const left = (await readdir(testme)).filter((name) => name.startsWith(TRASH_PREFIX))
+teq(left.length, 0, 'settleBackground should wait for the renamed directory to be removed')
+console.log('✓ discardTree removes in the background')
+
+await removeTree(root)
+console.log('\nAll tests completed successfully!')
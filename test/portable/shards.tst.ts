@@ -0,0 +1,135 @@
+import {loadReports, parseShard, selectShard} from '../../src/utils/shards.ts'
+import {TestStatus, TestType, type TestFile} from '../../src/types.ts'
+import {teq} from 'testme'
+import {mkdtemp, rm, writeFile} from 'node:fs/promises'
+import {basename, dirname, join} from 'path'
+import {tmpdir} from 'os'
+
+console.log('Testing CI shards...')
+
+const root = join(tmpdir(), 'testme-shards')
+
+function testFile(path: string): TestFile {
+    const directory = dirname(join(root, path))
+    const name = basename(path)
+    return {
+        path: join(root, path),
+        name,
+        extension: '.c',
+        type: TestType.C,
+        directory,
+        artifactDir: join(directory, '.testme', name),
+    }
+}
+
+// Test 1: Shard specifications
+teq(parseShard('2/8').index, 2, 'Shard index')
+teq(parseShard('2/8').total, 8, 'Shard total')
+function rejects(spec: string): boolean {
+    try {
+        parseShard(spec)
+        return false
+    } catch {
+        return true
+    }
+}
+teq(rejects('0/4'), true, 'Index 0 should be rejected')
+teq(rejects('5/4'), true, 'Index above total should be rejected')
+teq(rejects('1/0'), true, 'Total 0 should be rejected')
+teq(rejects('1-4'), true, 'Malformed spec should be rejected')
+console.log('✓ Shard specifications')
+
+// Test 2: N shards are disjoint and together cover every test
+const tests: TestFile[] = []
+for (let i = 0; i < 23; i++) {
+    tests.push(testFile(`${['api', 'core', 'util'][i % 3]}/case${i}.tst.c`))
+}
+for (let total = 1; total <= 6; total++) {
+    const seen = new Map<string, number>()
+    for (let index = 1; index <= total; index++) {
+        const shard = await selectShard(tests, {index, total}, root)
+        for (const test of shard) {
+            seen.set(test.path, (seen.get(test.path) ?? 0) + 1)
+        }
+        // Equal weights deal the tests round-robin, so shard sizes differ by at most one
+        const size = Math.floor(tests.length / total) + (index <= tests.length % total ? 1 : 0)
+        teq(shard.length, size, `Shard ${index}/${total} size`)
+    }
+    teq(seen.size, tests.length, `${total} shards should cover every test`)
+    teq([...seen.values()].every((count) => count === 1), true, `${total} shards should be disjoint`)
+}
+console.log('✓ Shards are disjoint and complete')
+
+// Test 3: The split does not depend on discovery order
+const forward = (await selectShard(tests, {index: 2, total: 4}, root)).map((test) => test.path).sort()
+const reversed = (await selectShard([...tests].reverse(), {index: 2, total: 4}, root)).map((test) => test.path).sort()
+teq(forward.join(','), reversed.join(','), 'Same tests in any discovery order')
+console.log('✓ Split is deterministic')
+
+// Test 4: --shard-timings balances by reported durations; unreported tests weigh as a median test
+const dir = await mkdtemp(join(tmpdir(), 'testme-shards-test-'))
+const timed = [testFile('slow.tst.c'), testFile('a.tst.c'), testFile('b.tst.c'), testFile('c.tst.c')]
+const report = join(dir, 'timings.json')
+await writeFile(
+    report,
+    JSON.stringify({
+        summary: {total: 3},
+        tests: [
+            {file: '/other/checkout/slow.tst.c', type: 'c', status: 'passed', duration: 3000},
+            {file: '/other/checkout/a.tst.c', type: 'c', status: 'passed', duration: 1000},
+            {file: '/other/checkout/b.tst.c', type: 'c', status: 'passed', duration: 1000},
+        ],
+    })
+)
+const first = await selectShard(timed, {index: 1, total: 2}, root, report)
+const second = await selectShard(timed, {index: 2, total: 2}, root, report)
+teq(first.map((test) => test.name).join(','), 'slow.tst.c', 'Longest test fills its own shard')
+teq(second.map((test) => test.name).join(','), 'a.tst.c,b.tst.c,c.tst.c', 'Other tests share a shard')
+console.log('✓ Shards are balanced by --shard-timings')
+
+// Test 5: JSON and NDJSON reports are merged
+const json = join(dir, 's1.json')
+await writeFile(
+    json,
+    JSON.stringify(
+        {
+            summary: {total: 1, passed: 1},
+            tests: [{file: '/ci/test/a.tst.c', type: 'c', status: 'passed', duration: 12, exitCode: 0}],
+        },
+        null,
+        2
+    ) + '\n'
+)
+const ndjson = join(dir, 's2.ndjson')
+await writeFile(
+    ndjson,
+    [
+        JSON.stringify({file: '/ci/test/b.tst.ts', type: 'typescript', status: 'failed', duration: 5, error: 'boom'}),
+        JSON.stringify({summary: {total: 1, failed: 1}}),
+        '',
+    ].join('\n')
+)
+const results = await loadReports([json, ndjson])
+teq(results.length, 2, 'One result per reported test')
+teq(results[0]!.file.name, 'a.tst.c', 'JSON test file')
+teq(results[0]!.status, TestStatus.Passed, 'JSON test status')
+teq(results[0]!.duration, 12, 'JSON test duration')
+teq(results[1]!.file.extension, '.ts', 'NDJSON test extension')
+teq(results[1]!.status, TestStatus.Failed, 'NDJSON test status')
+teq(results[1]!.error, 'boom', 'NDJSON test error')
+console.log('✓ Reports are merged')
+
+// Test 6: A report with other output around the JSON document is rejected
+const mixed = join(dir, 'mixed.json')
+await writeFile(mixed, `Shard 1/4: 1 test(s)\n${JSON.stringify({summary: {}, tests: []})}\n`)
+let invalid = false
+try {
+    await loadReports([mixed])
+} catch {
+    invalid = true
+}
+teq(invalid, true, 'Non-JSON report should be rejected')
+console.log('✓ Invalid reports are rejected')
+
+await rm(dir, {recursive: true, force: true})
+console.log('\nAll tests completed successfully!')
@@ -0,0 +1,59 @@
+import {StreamReport} from '../../src/utils/stream-report.ts'
+import {TestStatus, TestType, type TestResult} from '../../src/types.ts'
+import {teq} from 'testme'
+import {mkdtemp, readFile, rm} from 'node:fs/promises'
+import {join} from 'path'
+import {tmpdir} from 'os'
+
+console.log('Testing streamed NDJSON and JUnit reports...')
+
+const dir = await mkdtemp(join(tmpdir(), 'testme-stream-test-'))
+
+function makeResult(name: string, status: TestStatus, output: string, error?: string): TestResult {
+    return {
+        file: {
+            path: join(dir, 'unit', name),
+            name,
+            extension: '.c',
+            type: TestType.C,
+            directory: join(dir, 'unit'),
+            artifactDir: join(dir, 'unit', '.testme', name),
+        },
+        status,
+        duration: 25,
+        output,
+        error,
+        exitCode: status === TestStatus.Passed ? 0 : 1,
+    }
+}
+
+await StreamReport.start({ndjson: join(dir, 'results.ndjson'), junit: join(dir, 'results.xml'), rootDir: dir})
+const passed = makeResult('math.tst.c', TestStatus.Passed, 'output with ]]> and <tags>')
+const failed = makeResult('string.tst.c', TestStatus.Failed, 'failure output', 'Assertion failed: "a" == "b"')
+StreamReport.add(passed, false)
+StreamReport.add(failed, false)
+await StreamReport.finish()
+
+// Test 1: Passed output is released once written, failure output is kept for the final report
+teq(passed.output, '', 'Passed output should be released after it is written')
+teq(failed.output, 'failure output', 'Failed output should be kept')
+console.log('✓ Output of passed tests is released')
+
+// Test 2: NDJSON has one line per test and a summary line
+const lines = (await readFile(join(dir, 'results.ndjson'), 'utf8')).trim().split('\n')
+teq(lines.length, 3, 'NDJSON should have two test lines and a summary')
+teq(JSON.parse(lines[0]!).output, 'output with ]]> and <tags>', 'NDJSON should include the test output')
+teq(JSON.parse(lines[2]!).summary.failed, 1, 'NDJSON summary should count the failure')
+console.log('✓ NDJSON report')
+
+// Test 3: JUnit totals are rewritten in the header and output is escaped
+const xml = await readFile(join(dir, 'results.xml'), 'utf8')
+teq(xml.includes('<testsuite name="testme" tests="2" failures="1" errors="0" skipped="0"'), true, 'JUnit totals')
+teq(xml.includes('classname="unit"'), true, 'JUnit class name should be the relative directory')
+teq(xml.includes('<failure message="Assertion failed: &quot;a&quot; == &quot;b&quot;">'), true, 'JUnit failure')
+teq(xml.includes(']]]]><![CDATA[>'), true, 'CDATA terminators in output should be split')
+teq(xml.trimEnd().endsWith('</testsuites>'), true, 'JUnit report should be closed')
+console.log('✓ JUnit report')
+
+await rm(dir, {recursive: true, force: true})
+console.log('\nAll tests completed successfully!')
@@ -0,0 +1,44 @@
+/*
+    Test the multi-threaded stress harness
+ */
+#include "testme.h"
+
+typedef struct Counter {
+    volatile long   value;
+    volatile long   seen[TM_STRESS_MAX_THREADS];
+} Counter;
+
+static void increment(void *arg) {
+    Counter     *counter;
+    int         thread;
+
+    counter = (Counter*) arg;
+    thread = tStressThread();
+    ttrue(thread >= 0 && thread < TM_STRESS_MAX_THREADS, "Thread index should be in range");
+    counter->seen[thread] = 1;
+    TM_ATOMIC_ADD(&counter->value, 1);
+}
+
+int main(int argc, char **argv) {
+    Counter     counter;
+    int64_t     total;
+    int         i, threads;
+
+    memset(&counter, 0, sizeof(counter));
+    ttrue(tStressThread() < 0, "Main thread is not a stress thread");
+
+    //  Every iteration of every thread runs once
+    total = tStress(increment, &counter, 4);
+    tgtll((long long) total, 0LL, "Stress should run iterations");
+    teqll((long long) counter.value, (long long) total, "Atomic counter should match the iterations");
+    for (threads = 0, i = 0; i < TM_STRESS_MAX_THREADS; i++) {
+        threads += counter.seen[i] ? 1 : 0;
+    }
+    teqi(threads, 4, "Every thread should run the body");
+
+    //  Zero threads uses one thread per core
+    memset(&counter, 0, sizeof(counter));
+    total = tStress(increment, &counter, 0);
+    teqll((long long) counter.value, (long long) total, "Atomic counter should match with one thread per core");
+    return 0;
+}
@@ -0,0 +1,167 @@
+import {canInclude, findUnityTests, generateDriver, parseUnityOutput, stripUnityFraming} from '../../src/utils/unity.ts'
+import {CompilerManager, CompilerType} from '../../src/platform/compiler.ts'
+import {teq} from 'testme'
+import {copyFile, mkdtemp, rm, writeFile} from 'node:fs/promises'
+import {join} from 'path'
+import {tmpdir} from 'os'
+
+console.log('Testing TM_TEST drivers...')
+
+const ADD = `#include "testme.h"
+
+TM_TEST(add)
+{
+    teqi(1 + 1, 2, "Add");
+}
+`
+
+const MIXED = `#include "testme.h"
+
+/* TM_TEST(commented) is not at the start of a line */
+    TM_TEST( add )
+{
+    teqi(1 + 1, 3, "Wrong sum");
+}
+
+TM_TEST(sub)
+{
+    teqi(2 - 1, 1, "Sub");
+}
+`
+
+const SPIN = `#include "testme.h"
+
+TM_TEST(spin)
+{
+    volatile int running = 1;
+    while (running) {
+    }
+}
+`
+
+// Test 1: TM_TEST functions are found in definition order
+teq(findUnityTests(ADD).join(','), 'add', 'Single test')
+teq(findUnityTests(MIXED).join(','), 'add,sub', 'Indented tests with spaces, comments ignored')
+teq(findUnityTests('int main(void) { return 0; }\n').length, 0, 'Files with main() have no tests')
+console.log('✓ findUnityTests')
+
+// Test 2: Each file is included with its own prefix
+const driver = generateDriver([
+    {path: 'C:\\src\\a.tst.c', name: 'a.tst.c', tests: ['add']},
+    {path: '/src/b.tst.c', name: 'b.tst.c', tests: ['add', 'sub']},
+])
+teq(driver.includes('#define TM_UNIT tm1_\n#include "C:/src/a.tst.c"'), true, 'First file prefix and path')
+teq(driver.includes('#define TM_UNIT tm2_\n#include "/src/b.tst.c"'), true, 'Second file prefix')
+teq(driver.includes('{"a.tst.c", "add", tm1_add},'), true, 'First file entry')
+teq(driver.includes('{"b.tst.c", "add", tm2_add},'), true, 'Equal test names do not collide')
+teq(driver.includes('{"b.tst.c", "sub", tm2_sub},'), true, 'Second test entry')
+const quoted = generateDriver([{path: '/src/my\\test.tst.c', name: 'my\\test.tst.c', tests: ['add']}])
+teq(quoted.includes('{"my\\\\test.tst.c", "add", tm1_add},'), true, 'Names are escaped in C strings')
+teq(canInclude('/src/my test.tst.c'), true, 'Paths with spaces can be included')
+teq(canInclude('/src/my"test.tst.c'), false, 'Paths with quotes are not included')
+teq(canInclude('/src/my\ntest.tst.c'), false, 'Paths with line breaks are not included')
+console.log('✓ generateDriver')
+
+// Test 3: Output is split into per-file sections
+const output = [
+    'TESTME_UNITY_BEGIN a.tst.c',
+    '✓ Add',
+    'TESTME_UNITY_END a.tst.c 0 1.500',
+    'TESTME_UNITY_BEGIN b.tst.c',
+    '✗ Wrong sum',
+    'TESTME_UNITY_END b.tst.c 1 2.250',
+].join('\r\n')
+const sections = parseUnityOutput(output)
+teq(sections.length, 2, 'One section per file')
+teq(sections[0]!.name, 'a.tst.c', 'First section name')
+teq(sections[0]!.output, '✓ Add', 'Section output without framing or CR')
+teq(sections[0]!.failed, false, 'First section passed')
+teq(sections[0]!.duration, 1.5, 'Section duration')
+teq(sections[1]!.failed && sections[1]!.complete, true, 'Second section failed but completed')
+teq(stripUnityFraming(output), '✓ Add\n✗ Wrong sum', 'Framing lines are stripped')
+console.log('✓ parseUnityOutput')
+
+// Test 4: A driver that stops inside a file leaves that section incomplete and failed
+const crashed = parseUnityOutput(
+    'TESTME_UNITY_BEGIN a.tst.c\n✓ Add\nTESTME_UNITY_BEGIN b.tst.c\n✓ Sub\nSegmentation fault'
+)
+teq(crashed.length, 2, 'Sections before the crash are kept')
+teq(crashed[0]!.complete, false, 'File without an END line is incomplete')
+teq(crashed[1]!.complete, false, 'Crashed file is incomplete')
+teq(crashed[1]!.failed, true, 'Crashed file failed')
+teq(crashed[1]!.output, '✓ Sub\nSegmentation fault', 'Crash output is kept')
+const mismatched = parseUnityOutput('TESTME_UNITY_BEGIN a.tst.c\nTESTME_UNITY_END b.tst.c 0 1.0\n')
+teq(mismatched[0]!.complete, false, 'END line of another file does not complete the section')
+console.log('✓ Incomplete sections')
+
+// Test 5: File names with spaces keep their whole name in the framing lines
+const spaced = parseUnityOutput('TESTME_UNITY_BEGIN my test.tst.c\n✓ Add\nTESTME_UNITY_END my test.tst.c 0 0.5\n')
+teq(spaced[0]!.name, 'my test.tst.c', 'Name with spaces')
+teq(spaced[0]!.complete && !spaced[0]!.failed, true, 'Section with spaces completes')
+teq(spaced[0]!.duration, 0.5, 'Duration after a name with spaces')
+console.log('✓ Names with spaces')
+
+// Test 6: A generated driver compiles and runs every file, continuing after a failed test
+const compilerConfig = await CompilerManager.getDefaultCompilerConfig()
+if (compilerConfig.type === CompilerType.GCC || compilerConfig.type === CompilerType.Clang) {
+    const dir = await mkdtemp(join(tmpdir(), 'testme-unity-test-'))
+    await copyFile(join(import.meta.dir, '..', 'testme.h'), join(dir, 'testme.h'))
+    await writeFile(join(dir, 'a.tst.c'), ADD)
+    await writeFile(join(dir, 'b.tst.c'), MIXED)
+    const units = [
+        {path: join(dir, 'a.tst.c'), name: 'a.tst.c', tests: findUnityTests(ADD)},
+        {path: join(dir, 'b.tst.c'), name: 'b.tst.c', tests: findUnityTests(MIXED)},
+    ]
+    await writeFile(join(dir, 'driver.c'), generateDriver(units))
+    const build = async (name: string) => {
+        const binary = join(dir, name)
+        const compile = Bun.spawn([compilerConfig.compiler, `-I${dir}`, `${binary}.c`, '-o', binary], {
+            stdout: 'pipe',
+            stderr: 'pipe',
+        })
+        teq(await compile.exited, 0, `Driver should compile: ${await new Response(compile.stderr).text()}`)
+        return binary
+    }
+    let binary = await build('driver')
+
+    const run = async (args: string[], env: Record<string, string> = {}) => {
+        const proc = Bun.spawn([binary, ...args], {stdout: 'pipe', stderr: 'pipe', env: {...process.env, ...env}})
+        const text = await new Response(proc.stdout).text()
+        return {exitCode: await proc.exited, sections: parseUnityOutput(text)}
+    }
+    const all = await run([])
+    teq(all.exitCode !== 0, true, 'Driver fails when a test fails')
+    teq(all.sections.map((section) => section.name).join(','), 'a.tst.c,b.tst.c', 'Files run in order')
+    teq(all.sections[0]!.failed, false, 'Passing file')
+    teq(all.sections[1]!.failed, true, 'Failing file')
+    teq(all.sections[1]!.output.includes('✓ Sub'), true, 'Tests after a failed test still run')
+
+    const selected = await run(['b.tst.c:sub'])
+    teq(selected.exitCode, 0, 'Selected test passes')
+    teq(selected.sections.map((section) => section.name).join(','), 'b.tst.c', 'Only the selected file runs')
+    teq(selected.sections[0]!.output.includes('Wrong sum'), false, 'Unselected tests do not run')
+
+    // A file that exceeds TESTME_UNITY_TIMEOUT stops the driver with 128 + SIGALRM
+    if (process.platform !== 'win32') {
+        const units = [
+            {path: join(dir, 'spin test.tst.c'), name: 'spin test.tst.c', tests: findUnityTests(SPIN)},
+            {path: join(dir, 'a.tst.c'), name: 'a.tst.c', tests: findUnityTests(ADD)},
+        ]
+        await writeFile(units[0]!.path, SPIN)
+        await writeFile(join(dir, 'spin.c'), generateDriver(units))
+        binary = await build('spin')
+        const timed = await run([], {TESTME_UNITY_TIMEOUT: '1'})
+        teq(timed.exitCode, 142, 'Timed out driver exit status')
+        teq(timed.sections.length, 1, 'Driver stops in the timed out file')
+        teq(timed.sections[0]!.name, 'spin test.tst.c', 'Timed out file name with spaces')
+        teq(timed.sections[0]!.complete, false, 'Timed out file is incomplete')
+        const rest = await run(['a.tst.c'], {TESTME_UNITY_TIMEOUT: '1'})
+        teq(rest.exitCode, 0, 'Remaining files run after a restart')
+    }
+    await rm(dir, {recursive: true, force: true})
+    console.log('✓ Generated driver runs')
+} else {
+    console.log('✓ Generated driver skipped (requires GCC or Clang)')
+}
+
+console.log('\nAll tests completed successfully!')
@@ -0,0 +1,72 @@
+import {DependencyGraph} from '../../src/watch.ts'
+import type {TestFile} from '../../src/types.ts'
+import {TestType} from '../../src/types.ts'
+import {teq} from 'testme'
+import {mkdir, mkdtemp, rm, writeFile} from 'node:fs/promises'
+import {join} from 'path'
+import {tmpdir} from 'os'
+
+console.log('Testing watch mode dependencies...')
+
+const dir = await mkdtemp(join(tmpdir(), 'testme-watch-test-'))
+
+function testFile(name: string, type = TestType.C): TestFile {
+    const base = name.replace(/\.tst\.\w+$/, '')
+    return {
+        path: join(dir, name),
+        name,
+        extension: name.slice(name.lastIndexOf('.')),
+        type,
+        directory: dir,
+        artifactDir: join(dir, '.testme', base),
+    }
+}
+
+// Write a dependency record as saved by the C handler after a compile
+async function record(artifactDir: string, name: string, dependencies: string[]): Promise<void> {
+    await mkdir(artifactDir, {recursive: true})
+    await writeFile(join(artifactDir, name), JSON.stringify({hash: 'x', dependencies}))
+}
+
+const math = testFile('math.tst.c')
+const unit = testFile('unit.tst.c')
+const other = testFile('other.tst.c')
+const script = testFile('app.tst.ts', TestType.TypeScript)
+const tests = [math, unit, other, script]
+const header = (name: string) => join(dir, name)
+
+await record(math.artifactDir, 'compile.deps', [header('plain.h')])
+await record(math.artifactDir, 'compile-asan-ubsan.deps', [header('asan.h')])
+await record(math.artifactDir, 'compile-cov.deps', [header('cov.h')])
+await writeFile(join(math.artifactDir, 'compile.log'), 'not a record')
+await record(join(dir, '.testme', '.unity'), 'compile-cov.deps', [unit.path, header('unity.h')])
+await writeFile(script.path, "import {add} from './lib'\n")
+await writeFile(join(dir, 'lib.ts'), "export * from './util.ts'\n")
+await writeFile(join(dir, 'util.ts'), 'export const add = 1\n')
+
+const graph = await DependencyGraph.build(tests)
+const affected = (path: string) => [...graph.affected([path], tests)].sort().join(',')
+const paths = (...list: string[]) => list.sort().join(',')
+
+// Test 1: Headers recorded by every build variant re-run the test
+teq(affected(header('plain.h')), paths(header('plain.h'), math.path), 'Plain build record')
+teq(affected(header('asan.h')), paths(header('asan.h'), math.path), 'Sanitizer build record')
+teq(affected(header('cov.h')), paths(header('cov.h'), math.path), 'Coverage build record')
+console.log('✓ Build variant records')
+
+// Test 2: The shared unity driver's record applies to the tests it includes
+teq(affected(header('unity.h')), paths(header('unity.h'), unit.path), 'Unity driver record')
+teq(graph.files().includes(header('unity.h')), true, 'Unity dependencies are watched')
+console.log('✓ Unity driver records')
+
+// Test 3: JS/TS tests follow their relative imports transitively
+teq(affected(join(dir, 'util.ts')), paths(script.path, join(dir, 'util.ts')), 'Transitive import')
+console.log('✓ Relative imports')
+
+// Test 4: Config files affect the tests at or below their directory, new files affect themselves
+teq(graph.affected([join(dir, 'testme.json5')], tests).size, tests.length + 1, 'Config change')
+teq(affected(join(dir, 'new.tst.c')), join(dir, 'new.tst.c'), 'New test file')
+console.log('✓ Config and new files')
+
+await rm(dir, {recursive: true, force: true})
+console.log('\nAll tests completed successfully!')
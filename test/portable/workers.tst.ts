@@ -0,0 +1,38 @@
+import {ConfigManager} from '../../src/config.ts'
+import {RunBudget} from '../../src/utils/run-budget.ts'
+import {PlatformDetector} from '../../src/platform/detector.ts'
+import {teq} from 'testme'
+import {mkdtemp, rm, writeFile} from 'node:fs/promises'
+import {join} from 'path'
+import {tmpdir} from 'os'
+
+console.log('Testing worker defaults...')
+
+const cores = PlatformDetector.getCpuCount()
+const dir = await mkdtemp(join(tmpdir(), 'testme-workers-test-'))
+
+// Test 1: Without a configuration file, tests and compiles run on every core
+const defaults = ConfigManager.getDefaultConfig()
+teq(defaults.execution?.workers, undefined, 'No default workers')
+teq(RunBudget.getWorkers(defaults.execution), cores, 'Default workers are the CPU cores')
+teq(RunBudget.getCompiles(defaults.execution), cores, 'Default compiles are the CPU cores')
+console.log('✓ Defaults')
+
+// Test 2: A configuration file without execution.workers keeps the core count after merging defaults
+await writeFile(join(dir, 'testme.json5'), '{execution: {timeout: 10}}\n')
+ConfigManager.clearCache()
+let config = await ConfigManager.findConfig(dir)
+teq(config.execution?.timeout, 10, 'Configuration file is read')
+teq(RunBudget.getWorkers(config.execution), cores, 'Unset workers are the CPU cores')
+console.log('✓ Unset workers')
+
+// Test 3: An explicit execution.workers is used as is
+await writeFile(join(dir, 'testme.json5'), '{execution: {workers: 3, compileWorkers: 2}}\n')
+ConfigManager.clearCache()
+config = await ConfigManager.findConfig(dir)
+teq(RunBudget.getWorkers(config.execution), 3, 'Configured workers')
+teq(RunBudget.getCompiles(config.execution), 2, 'Configured compiles')
+console.log('✓ Configured workers')
+
+await rm(dir, {recursive: true, force: true})
+console.log('\nAll tests completed successfully!')
@@ -0,0 +1,15 @@
+/*
+    Test the server is up as soon as it reports ready (setupDelay would otherwise wait 30s)
+*/
+
+try {
+    const response = await fetch('http://localhost:8897/')
+    if ((await response.text()) !== 'OK') {
+        console.error('Unexpected response')
+        process.exit(1)
+    }
+    console.log('✓ Server was ready when the test started')
+} catch (error) {
+    console.error('Server not ready:', error)
+    process.exit(1)
+}
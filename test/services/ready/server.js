@@ -0,0 +1,16 @@
+/*
+    HTTP server that announces readiness on stdout (services.ready)
+*/
+
+const server = Bun.serve({
+    hostname: 'localhost',
+    port: 8897,
+    fetch() {
+        return new Response('OK')
+    },
+})
+
+console.log(`Ready server listening on localhost:${server.port}`)
+
+// Keep process running
+await new Promise(() => {})
@@ -0,0 +1,14 @@
+/*
+    Test the shared server is running for this group
+*/
+
+const response = await fetch('http://localhost:8896/')
+const started = Number(await response.text())
+
+if (response.status !== 200 || !started) {
+    console.error(`Unexpected response from shared server: ${response.status}`)
+    process.exit(1)
+}
+
+console.log(`✓ Shared server is running (started at ${started})`)
+process.exit(0)
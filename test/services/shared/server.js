@@ -0,0 +1,18 @@
+/*
+    HTTP server shared by the alpha and beta groups (services.share)
+*/
+
+const started = Date.now()
+
+const server = Bun.serve({
+    hostname: 'localhost',
+    port: 8896,
+    fetch() {
+        return new Response(String(started))
+    },
+})
+
+console.log(`Shared server listening on localhost:${server.port}`)
+
+// Keep process running
+await new Promise(() => {})